@@ -0,0 +1,49 @@
+# Cargar VECTOR_A_ADDR (addr 0)
+LOAD R5, [0]        # R5 = VECTOR_A_ADDR
+
+LOAD R2, [1]        # R2 = VECTOR_B_ADDR
+
+LOAD R1, [12]       # R1 = start_index
+ROI                 # inicio de la región de interés (fin de SIM_FASTFWD=roi)
+
+MOV R0, 0.0         # R0 = acumulador (resultado parcial)
+MOV R3, 1.0         # iteraciones de 4 elementos
+
+LOOP_START:
+FADD R4, R5, R1     # R4 = VECTOR_A_ADDR + i
+LOAD R4, [R4]       # R4 = A[i]
+FADD R6, R2, R1     # R6 = VECTOR_B_ADDR + i
+LOAD R6, [R6]       # R6 = B[i]
+FMUL R4, R4, R6     # R4 = A[i] * B[i]
+FADD R0, R0, R4     # acumulador += producto
+INC R1              # i++
+FADD R4, R5, R1     # R4 = VECTOR_A_ADDR + i
+LOAD R4, [R4]       # R4 = A[i]
+FADD R6, R2, R1     # R6 = VECTOR_B_ADDR + i
+LOAD R6, [R6]       # R6 = B[i]
+FMUL R4, R4, R6     # R4 = A[i] * B[i]
+FADD R0, R0, R4     # acumulador += producto
+INC R1              # i++
+FADD R4, R5, R1     # R4 = VECTOR_A_ADDR + i
+LOAD R4, [R4]       # R4 = A[i]
+FADD R6, R2, R1     # R6 = VECTOR_B_ADDR + i
+LOAD R6, [R6]       # R6 = B[i]
+FMUL R4, R4, R6     # R4 = A[i] * B[i]
+FADD R0, R0, R4     # acumulador += producto
+INC R1              # i++
+FADD R4, R5, R1     # R4 = VECTOR_A_ADDR + i
+LOAD R4, [R4]       # R4 = A[i]
+FADD R6, R2, R1     # R6 = VECTOR_B_ADDR + i
+LOAD R6, [R6]       # R6 = B[i]
+FMUL R4, R4, R6     # R4 = A[i] * B[i]
+FADD R0, R0, R4     # acumulador += producto
+INC R1              # i++
+DEC R3              # contador--
+JNZ LOOP_START      # Repetir si contador != 0
+
+STORE R0, [18]      # Guardar resultado parcial
+
+MOV R6, 1.0         # Flag value
+STORE R6, [22]      # Señalizar finalización
+
+HALT
@@ -10,6 +10,7 @@ LOAD R1, [R4]        # R1 = start_index (índice, no dirección)
 
 MOV R4, 9.0
 LOAD R3, [R4]        # R3 = segment_size (contador del loop)
+ROI                  # inicio de la región de interés (fin de SIM_FASTFWD=roi)
 
 MOV R0, 0.0         # R0 = acumulador (resultado parcial)
 
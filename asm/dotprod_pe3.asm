@@ -11,6 +11,7 @@ LOAD R1, [R4]        # R1 = start_index
 
 MOV R4, 15.0
 LOAD R3, [R4]        # R3 = segment_size (contador)
+ROI                  # inicio de la región de interés (fin de SIM_FASTFWD=roi)
 
 MOV R0, 0.0         # R0 = acumulador
 
@@ -35,19 +36,20 @@ LOAD R7, [R1]  # R7 = barrier_check = - (NUM_PES-1)
 
 WAIT_LOOP:
 MOV R1, 20.0
+MONITOR [R1]         # armar monitor sobre el bloque de flags
 LOAD R2, [R1]        # R2 = flag[PE0]
 
 MOV R1, 21.0
 LOAD R4, [R1]        # R4 = flag[PE1]
+FADD R2, R2, R4      # R2 += flag1
 
 MOV R1, 22.0
-LOAD R5, [R1]        # R5 = flag[PE2]
+LOAD R4, [R1]        # R4 = flag[PE2]
+FADD R2, R2, R4      # R2 += flag2
 
-FADD R6, R2, R4      # R6 = flag0 + flag1
-FADD R6, R6, R5      # R6 += flag2
-FADD R6, R6, R7      # R6 = suma_flags - (NUM_PES-1)
+FADD R6, R2, R7      # R6 = suma_flags - (NUM_PES-1)
 
-JNZ WAIT_LOOP        # si != 0, repetir
+JNZ WAIT_SLEEP       # si != 0, dormir hasta que cambie un flag
 
 # reducción de resultados parciales
 
@@ -68,3 +70,7 @@ MOV R2, 24.0
 STORE R0, [R2]       # guardar producto punto final
 
 HALT
+
+WAIT_SLEEP:
+MWAIT                # dormir (MONITOR armado en WAIT_LOOP)
+JNZ WAIT_LOOP        # zero_flag sigue a 0: volver a comprobar
@@ -0,0 +1,37 @@
+# Cargar direcciones desde SHARED_CONFIG
+MOV R4, 0.0
+LOAD R5, [R4]        # R5 = VECTOR_A_ADDR
+
+MOV R4, 1.0
+LOAD R2, [R4]        # R2 = VECTOR_B_ADDR
+
+MOV R4, 12.0
+LOAD R1, [R4]        # R1 = start_index
+ROI                  # inicio de la región de interés (fin de SIM_FASTFWD=roi)
+
+FADD R5, R5, R1      # R5 = &A[start]
+FADD R2, R2, R1      # R2 = &B[start]
+MOV R7, 4.0       # R7 = BLOCK_SIZE (paso vectorial)
+MOV R0, 0.0          # R0 = acumulador escalar
+
+# 1 iteraciones vectoriales de 4 lanes (V0 empieza en 0.0)
+MOV R3, 1.0
+VLOOP:
+VLOAD V1, [R5]       # V1 = A[i..i+3]
+VLOAD V2, [R2]       # V2 = B[i..i+3]
+VFMA V0, V1, V2      # V0 += V1 * V2
+FADD R5, R5, R7      # R5 += BLOCK_SIZE
+FADD R2, R2, R7      # R2 += BLOCK_SIZE
+DEC R3               # contador--
+JNZ VLOOP            # repetir si contador != 0
+
+VREDUCE R0, V0       # R0 = suma horizontal de V0
+
+MOV R5, 18.0
+STORE R0, [R5]      # Guardar resultado parcial
+
+MOV R7, 22.0
+MOV R6, 1.0         # Flag value
+STORE R6, [R7]      # Señalizar finalización
+
+HALT
@@ -0,0 +1,77 @@
+# Cargar direcciones desde SHARED_CONFIG
+MOV R4, 0.0
+LOAD R5, [R4]        # R5 = VECTOR_A_ADDR
+
+MOV R4, 1.0
+LOAD R2, [R4]        # R2 = VECTOR_B_ADDR
+
+MOV R4, 14.0
+LOAD R1, [R4]        # R1 = start_index
+ROI                  # inicio de la región de interés (fin de SIM_FASTFWD=roi)
+
+FADD R5, R5, R1      # R5 = &A[start]
+FADD R2, R2, R1      # R2 = &B[start]
+MOV R7, 4.0       # R7 = BLOCK_SIZE (paso vectorial)
+MOV R0, 0.0          # R0 = acumulador escalar
+
+# 1 iteraciones vectoriales de 4 lanes (V0 empieza en 0.0)
+MOV R3, 1.0
+VLOOP:
+VLOAD V1, [R5]       # V1 = A[i..i+3]
+VLOAD V2, [R2]       # V2 = B[i..i+3]
+VFMA V0, V1, V2      # V0 += V1 * V2
+FADD R5, R5, R7      # R5 += BLOCK_SIZE
+FADD R2, R2, R7      # R2 += BLOCK_SIZE
+DEC R3               # contador--
+JNZ VLOOP            # repetir si contador != 0
+
+VREDUCE R0, V0       # R0 = suma horizontal de V0
+
+MOV R5, 19.0
+STORE R0, [R5]      # guardar en RESULTS_ADDR + 3
+
+# barrera de sincronización
+
+MOV R1, 6.0
+LOAD R7, [R1]  # R7 = barrier_check = - (NUM_PES-1)
+
+WAIT_LOOP:
+MOV R1, 20.0
+MONITOR [R1]         # armar monitor sobre el bloque de flags
+LOAD R2, [R1]        # R2 = flag[PE0]
+
+MOV R1, 21.0
+LOAD R4, [R1]        # R4 = flag[PE1]
+FADD R2, R2, R4      # R2 += flag1
+
+MOV R1, 22.0
+LOAD R4, [R1]        # R4 = flag[PE2]
+FADD R2, R2, R4      # R2 += flag2
+
+FADD R6, R2, R7      # R6 = suma_flags - (NUM_PES-1)
+
+JNZ WAIT_SLEEP       # si != 0, dormir hasta que cambie un flag
+
+# reducción de resultados parciales
+
+MOV R1, 5.0
+LOAD R2, [R1]  # R2 = NUM_PES
+
+MOV R1, 16.0  # R1 = dirección actual (empieza en RESULTS_ADDR)
+MOV R0, 0.0          # R0 = acumulador final
+
+REDUCE_LOOP:
+LOAD R4, [R1]        # R4 = resultado_parcial[i]
+FADD R0, R0, R4      # acumulador += resultado_parcial[i]
+INC R1               # R1++ (siguiente resultado: compacto, +1 dirección)
+DEC R2               # contador--
+JNZ REDUCE_LOOP      # repetir si contador != 0
+
+MOV R2, 24.0
+STORE R0, [R2]       # guardar producto punto final
+
+HALT
+
+WAIT_SLEEP:
+MWAIT                # dormir (MONITOR armado en WAIT_LOOP)
+JNZ WAIT_LOOP        # zero_flag sigue a 0: volver a comprobar
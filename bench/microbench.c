@@ -0,0 +1,247 @@
+/**
+ * @file microbench.c
+ * @brief Microbenchmarks de los componentes del simulador (make microbench)
+ *
+ * Enlazado con los mismos objetos que mp_mesi (todo menos main.o): arranca
+ * la memoria, el bus y NUM_PES cachés con sus hilos, como main, y mide desde
+ * este hilo el coste aislado de cada operación:
+ *   read hit         cache_read sobre una línea presente
+ *   read miss (mem)  cache_read de un bloque que ninguna caché tiene (BUS_RD a memoria)
+ *   c2c from E/M     cache_read servido por otra caché en handle_busrd
+ *                    (desde M incluye el writeback a memoria)
+ *   mem round trip   mem_read_block a través de mem_thread_func
+ *   upgrade k=N      cache_write en S con N copias compartidas (BUS_UPGR)
+ *
+ * Las operaciones que necesitan preparar estado (invalidar, repartir copias)
+ * se cronometran una a una y la preparación queda fuera de la medida; el
+ * resto se mide en bucle. Cada caso hace un calentamiento y luego
+ * MICROBENCH_REPS repeticiones de MICROBENCH_ITERS operaciones; se reporta
+ * la media, la desviación estándar, el mínimo y el máximo de ns/op entre
+ * repeticiones. Todo es tiempo de host: incluye los cambios de contexto
+ * entre este hilo y los hilos del bus y de la memoria.
+ *
+ * Variables de entorno:
+ *   MICROBENCH_ITERS=N   operaciones por repetición (por defecto 2000; los hits x100)
+ *   MICROBENCH_REPS=N    repeticiones por caso (por defecto 10)
+ *   MICROBENCH_CSV=file  además escribe name,iters,reps,mean_ns,stddev_ns,min_ns,max_ns
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <time.h>
+#include <pthread.h>
+#include "config.h"
+#include "cache.h"
+#include "bus.h"
+#include "memory.h"
+#include "log.h"
+
+#define MICROBENCH_ITERS_DEFAULT 2000
+#define MICROBENCH_REPS_DEFAULT  10
+#define MICROBENCH_HIT_SCALE     100    // Hits are ~100x cheaper: more of them per rep
+
+// First data block after the synchronization area (see config.h)
+#define BENCH_ADDR VECTORS_START_ALIGNED
+
+static Memory mem;
+static Bus bus;
+static Cache caches[NUM_PES];
+
+static int ITERS = MICROBENCH_ITERS_DEFAULT;
+static int REPS = MICROBENCH_REPS_DEFAULT;
+static FILE* CSV;
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+// CASES
+
+typedef struct {
+    const char* name;
+    void (*setup)(int arg);     // NULL: the op is timed in a loop
+    void (*op)(int arg);
+    int arg;
+    int scale;                  // Iterations = ITERS * scale
+} BenchCase;
+
+static void invalidate_all(int addr) {
+    for (int i = 0; i < NUM_PES; i++) {
+        if (cache_get_state(&caches[i], addr) != I) {
+            cache_set_state(&caches[i], addr, I);
+        }
+    }
+}
+
+static void op_read0(int arg) {
+    (void)arg;
+    (void)cache_read(&caches[0], BENCH_ADDR, 0);
+}
+
+static void setup_miss(int arg) {
+    (void)arg;
+    invalidate_all(BENCH_ADDR);
+}
+
+// Owner PE1 holds the block in E (read from memory) or M (written)
+static void setup_c2c_e(int arg) {
+    (void)arg;
+    invalidate_all(BENCH_ADDR);
+    (void)cache_read(&caches[1], BENCH_ADDR, 1);
+}
+
+static void setup_c2c_m(int arg) {
+    (void)arg;
+    invalidate_all(BENCH_ADDR);
+    cache_write(&caches[1], BENCH_ADDR, 1.0, 1);
+}
+
+static void op_mem_read(int arg) {
+    (void)arg;
+    double block[BLOCK_SIZE];
+    mem_read_block(&mem, BENCH_ADDR, block, 0);
+}
+
+// PE0 and PEs 1..k hold the block in S
+static void setup_upgrade(int k) {
+    invalidate_all(BENCH_ADDR);
+    for (int i = 0; i <= k; i++) {
+        (void)cache_read(&caches[i], BENCH_ADDR, i);
+    }
+}
+
+static void op_write0(int arg) {
+    (void)arg;
+    cache_write(&caches[0], BENCH_ADDR, 2.0, 0);
+}
+
+// MEASUREMENT
+
+static double run_rep(const BenchCase* bc, int iters) {
+    if (!bc->setup) {
+        uint64_t t0 = now_ns();
+        for (int n = 0; n < iters; n++) {
+            bc->op(bc->arg);
+        }
+        return (double)(now_ns() - t0) / iters;
+    }
+    uint64_t total = 0;
+    for (int n = 0; n < iters; n++) {
+        bc->setup(bc->arg);
+        uint64_t t0 = now_ns();
+        bc->op(bc->arg);
+        total += now_ns() - t0;
+    }
+    return (double)total / iters;
+}
+
+static void run_case(const BenchCase* bc) {
+    int iters = ITERS * bc->scale;
+    run_rep(bc, iters / 10 + 1);  // Warm-up: host caches, branch predictors, thread wakeups
+
+    double sum = 0.0, sum_sq = 0.0, min = 0.0, max = 0.0;
+    for (int r = 0; r < REPS; r++) {
+        double ns = run_rep(bc, iters);
+        sum += ns;
+        sum_sq += ns * ns;
+        if (r == 0 || ns < min) min = ns;
+        if (r == 0 || ns > max) max = ns;
+    }
+    double mean = sum / REPS;
+    double var = REPS > 1 ? (sum_sq - sum * mean) / (REPS - 1) : 0.0;
+    double stddev = var > 0.0 ? sqrt(var) : 0.0;
+
+    printf("  %-18s %9d %10.1f %9.1f %6.1f%% %10.1f %10.1f\n", bc->name, iters, mean, stddev,
+           mean > 0.0 ? 100.0 * stddev / mean : 0.0, min, max);
+    if (CSV) {
+        fprintf(CSV, "%s,%d,%d,%.1f,%.1f,%.1f,%.1f\n", bc->name, iters, REPS, mean, stddev, min, max);
+    }
+}
+
+static int env_positive(const char* name, int* out) {
+    const char* value = getenv(name);
+    if (!value || !*value) {
+        return 0;
+    }
+    char* end;
+    long n = strtol(value, &end, 0);
+    if (*end != '\0' || n <= 0) {
+        LOGE("Invalid %s=%s (positive integer)", name, value);
+        return -1;
+    }
+    *out = (int)n;
+    return 0;
+}
+
+int main(void) {
+    log_init();
+    if (env_positive("MICROBENCH_ITERS", &ITERS) < 0 || env_positive("MICROBENCH_REPS", &REPS) < 0) {
+        return 1;
+    }
+    const char* csv_path = getenv("MICROBENCH_CSV");
+    if (csv_path && *csv_path) {
+        CSV = fopen(csv_path, "w");
+        if (!CSV) {
+            LOGE("Could not open %s", csv_path);
+            return 1;
+        }
+        fprintf(CSV, "name,iters,reps,mean_ns,stddev_ns,min_ns,max_ns\n");
+    }
+
+    // Same wiring as main, without PEs: this thread issues every access
+    mem_init(&mem);
+    Cache* cache_ptrs[NUM_PES];
+    for (int i = 0; i < NUM_PES; i++) {
+        cache_init(&caches[i]);
+        caches[i].bus = &bus;
+        caches[i].pe_id = i;
+        cache_ptrs[i] = &caches[i];
+    }
+    bus_init(&bus, cache_ptrs, &mem);
+
+    pthread_t mem_thread, bus_thread;
+    pthread_create(&mem_thread, NULL, mem_thread_func, &mem);
+    pthread_create(&bus_thread, NULL, bus_thread_func, &bus);
+    log_flush();
+
+    static char names[NUM_PES][24];
+    BenchCase cases[5 + NUM_PES];
+    int count = 0;
+    cases[count++] = (BenchCase){ "read hit", NULL, op_read0, 0, MICROBENCH_HIT_SCALE };
+    cases[count++] = (BenchCase){ "read miss (mem)", setup_miss, op_read0, 0, 1 };
+    if (NUM_PES > 1) {
+        cases[count++] = (BenchCase){ "c2c from E", setup_c2c_e, op_read0, 0, 1 };
+        cases[count++] = (BenchCase){ "c2c from M", setup_c2c_m, op_read0, 0, 1 };
+    }
+    cases[count++] = (BenchCase){ "mem round trip", NULL, op_mem_read, 0, 1 };
+    for (int k = 1; k < NUM_PES; k++) {
+        snprintf(names[k], sizeof(names[k]), "upgrade k=%d", k);
+        cases[count++] = (BenchCase){ names[k], setup_upgrade, op_write0, k, 1 };
+    }
+
+    // The first read of the hit case brings the line in
+    (void)cache_read(&caches[0], BENCH_ADDR, 0);
+
+    printf("\n[Microbenchmarks] NUM_PES=%d BLOCK_SIZE=%d, %d reps, host ns/op\n",
+           NUM_PES, BLOCK_SIZE, REPS);
+    printf("  %-18s %9s %10s %9s %7s %10s %10s\n", "case", "iters", "mean", "stddev",
+           "cv", "min", "max");
+    for (int c = 0; c < count; c++) {
+        run_case(&cases[c]);
+    }
+
+    bus_destroy(&bus);
+    pthread_join(bus_thread, NULL);
+    mem_destroy(&mem);
+    pthread_join(mem_thread, NULL);
+    for (int i = 0; i < NUM_PES; i++) {
+        cache_destroy(&caches[i]);
+    }
+    if (CSV) {
+        fclose(CSV);
+    }
+    return 0;
+}
@@ -0,0 +1,144 @@
+# stencil: Jacobi 2D 6x6, 4 pasos, intercambio de halo por barrera (SPMD)
+MOV R7, 0.0          # R7 = -(llegadas esperadas en la barrera)
+
+STEP_PAIR:
+MOV R4, -4.0
+FADD R7, R7, R4
+
+# paso A: 0x38 -> 0x5C
+PEID R4
+MOV R5, 8.0
+FADD R5, R5, R4
+FADD R5, R5, R4      # R5 = CFG_PE(pe, 0)
+LOAD R1, [R5]
+INC R5
+LOAD R6, [R5]
+MOV R4, 56.0
+FADD R1, R1, R4      # R1 = &src[primera celda]
+MOV R4, 0.0
+FADD R4, R6, R4
+JNZ STEP_A
+MOV R4, 1.0
+FADD R4, R4, R4
+JNZ DONE_A
+STEP_A:
+ROW_A:
+MOV R3, 4.0
+CELL_A:
+LOAD R0, [R1]
+MOV R4, 0.5
+FMUL R0, R0, R4      # R0 = centro / 2
+MOV R4, -6.0
+FADD R4, R1, R4
+LOAD R5, [R4]        # norte
+MOV R4, 6.0
+FADD R4, R1, R4
+LOAD R4, [R4]        # sur
+FADD R5, R5, R4
+MOV R4, -1.0
+FADD R4, R1, R4
+LOAD R4, [R4]        # oeste
+FADD R5, R5, R4
+MOV R4, 1.0
+FADD R4, R1, R4
+LOAD R4, [R4]        # este
+FADD R5, R5, R4
+MOV R4, 0.125
+FMUL R5, R5, R4
+FADD R0, R0, R5      # R0 = centro / 2 + vecinos * 0.125
+MOV R4, 36.0
+FADD R4, R1, R4
+STORE R0, [R4]       # dst[celda]
+INC R1
+DEC R3
+JNZ CELL_A
+INC R1
+INC R1               # saltar el borde derecho y el izquierdo de la fila siguiente
+DEC R6
+JNZ ROW_A
+
+DONE_A:
+MOV R4, 128.0
+MOV R5, 1.0
+FAA R5, R5, [R4]     # llegada a la barrera
+WAIT_A:
+MONITOR [R4]
+LOAD R5, [R4]
+FADD R5, R5, R7      # R5 = llegadas - esperadas
+JNZ WAIT_A_SLEEP
+
+# paso B: 0x5C -> 0x38
+PEID R4
+MOV R5, 8.0
+FADD R5, R5, R4
+FADD R5, R5, R4      # R5 = CFG_PE(pe, 0)
+LOAD R1, [R5]
+INC R5
+LOAD R6, [R5]
+MOV R4, 92.0
+FADD R1, R1, R4      # R1 = &src[primera celda]
+MOV R4, 0.0
+FADD R4, R6, R4
+JNZ STEP_B
+MOV R4, 1.0
+FADD R4, R4, R4
+JNZ DONE_B
+STEP_B:
+ROW_B:
+MOV R3, 4.0
+CELL_B:
+LOAD R0, [R1]
+MOV R4, 0.5
+FMUL R0, R0, R4      # R0 = centro / 2
+MOV R4, -6.0
+FADD R4, R1, R4
+LOAD R5, [R4]        # norte
+MOV R4, 6.0
+FADD R4, R1, R4
+LOAD R4, [R4]        # sur
+FADD R5, R5, R4
+MOV R4, -1.0
+FADD R4, R1, R4
+LOAD R4, [R4]        # oeste
+FADD R5, R5, R4
+MOV R4, 1.0
+FADD R4, R1, R4
+LOAD R4, [R4]        # este
+FADD R5, R5, R4
+MOV R4, 0.125
+FMUL R5, R5, R4
+FADD R0, R0, R5      # R0 = centro / 2 + vecinos * 0.125
+MOV R4, -36.0
+FADD R4, R1, R4
+STORE R0, [R4]       # dst[celda]
+INC R1
+DEC R3
+JNZ CELL_B
+INC R1
+INC R1               # saltar el borde derecho y el izquierdo de la fila siguiente
+DEC R6
+JNZ ROW_B
+
+DONE_B:
+MOV R4, 132.0
+MOV R5, 1.0
+FAA R5, R5, [R4]     # llegada a la barrera
+WAIT_B:
+MONITOR [R4]
+LOAD R5, [R4]
+FADD R5, R5, R7      # R5 = llegadas - esperadas
+JNZ WAIT_B_SLEEP
+
+MOV R4, 8.0
+FADD R4, R7, R4
+JNZ STEP_PAIR
+
+HALT
+
+WAIT_A_SLEEP:
+MWAIT                # dormir hasta que otro PE incremente el contador
+JNZ WAIT_A          # zero_flag sigue a 0: volver a comprobar
+
+WAIT_B_SLEEP:
+MWAIT                # dormir hasta que otro PE incremente el contador
+JNZ WAIT_B          # zero_flag sigue a 0: volver a comprobar
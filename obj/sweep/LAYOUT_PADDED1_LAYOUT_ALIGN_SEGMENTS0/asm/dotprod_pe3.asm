@@ -0,0 +1,76 @@
+# cálculo de producto punto parcial
+
+MOV R4, 0.0
+LOAD R5, [R4]        # R5 = VECTOR_A_ADDR
+
+MOV R4, 1.0
+LOAD R2, [R4]        # R2 = VECTOR_B_ADDR
+
+MOV R4, 14.0
+LOAD R1, [R4]        # R1 = start_index
+
+MOV R4, 15.0
+LOAD R3, [R4]        # R3 = segment_size (contador)
+
+MOV R0, 0.0         # R0 = acumulador
+
+LOOP_START:
+FADD R4, R5, R1     # R4 = VECTOR_A_ADDR + i (dirección de A[i])
+LOAD R4, [R4]       # R4 = A[i]
+FADD R6, R2, R1     # R6 = VECTOR_B_ADDR + i
+LOAD R6, [R6]       # R6 = B[i]
+FMUL R4, R4, R6     # R4 = A[i] * B[i]
+FADD R0, R0, R4     # acumulador += producto
+INC R1              # i++
+DEC R3              # contador--
+JNZ LOOP_START      # repetir si contador != 0
+
+MOV R5, 28.0
+STORE R0, [R5]      # guardar en RESULTS_ADDR + 3
+
+# barrera de sincronización
+
+MOV R1, 6.0
+LOAD R7, [R1]  # R7 = barrier_check = - (NUM_PES-1)
+
+WAIT_LOOP:
+MOV R1, 32.0
+MONITOR [R1]         # armar monitor sobre el bloque de flags
+LOAD R2, [R1]        # R2 = flag[PE0]
+
+MOV R1, 36.0
+LOAD R4, [R1]        # R4 = flag[PE1]
+FADD R2, R2, R4      # R2 += flag1
+
+MOV R1, 40.0
+LOAD R4, [R1]        # R4 = flag[PE2]
+FADD R2, R2, R4      # R2 += flag2
+
+FADD R6, R2, R7      # R6 = suma_flags - (NUM_PES-1)
+
+JNZ WAIT_LOOP        # si != 0, volver a sondear (flags en varios bloques)
+
+# reducción de resultados parciales
+
+MOV R1, 5.0
+LOAD R2, [R1]  # R2 = NUM_PES
+
+MOV R1, 16.0  # R1 = dirección actual (empieza en RESULTS_ADDR)
+MOV R0, 0.0          # R0 = acumulador final
+MOV R7, 4.0         # R7 = SYNC_STRIDE
+
+REDUCE_LOOP:
+LOAD R4, [R1]        # R4 = resultado_parcial[i]
+FADD R0, R0, R4      # acumulador += resultado_parcial[i]
+FADD R1, R1, R7      # R1 += 4 (siguiente resultado: un bloque por PE)
+DEC R2               # contador--
+JNZ REDUCE_LOOP      # repetir si contador != 0
+
+MOV R2, 48.0
+STORE R0, [R2]       # guardar producto punto final
+
+HALT
+
+WAIT_SLEEP:
+MWAIT                # dormir (MONITOR armado en WAIT_LOOP)
+JNZ WAIT_LOOP        # zero_flag sigue a 0: volver a comprobar
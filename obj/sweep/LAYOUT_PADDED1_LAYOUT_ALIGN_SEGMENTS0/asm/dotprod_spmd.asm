@@ -0,0 +1,86 @@
+# Programa SPMD: la misma imagen para todos los PEs
+PEID R7              # R7 = id de este PE
+
+MOV R4, 8.0
+FADD R4, R4, R7
+FADD R4, R4, R7      # R4 = CFG_PE(pe, PE_START_INDEX) (2 parámetros por PE)
+LOAD R1, [R4]        # R1 = start_index
+INC R4
+LOAD R3, [R4]        # R3 = segment_size
+
+MOV R4, 0.0
+LOAD R5, [R4]        # R5 = VECTOR_A_ADDR
+
+MOV R4, 1.0
+LOAD R2, [R4]        # R2 = VECTOR_B_ADDR
+
+MOV R0, 0.0         # R0 = acumulador (resultado parcial)
+
+LOOP_START:
+FADD R4, R5, R1     # R4 = VECTOR_A_ADDR + i (dirección de A[i])
+LOAD R4, [R4]       # R4 = A[i]
+FADD R6, R2, R1     # R6 = VECTOR_B_ADDR + i
+LOAD R6, [R6]       # R6 = B[i]
+FMUL R4, R4, R6     # R4 = A[i] * B[i]
+FADD R0, R0, R4     # acumulador += producto
+INC R1              # i++
+DEC R3              # contador--
+JNZ LOOP_START      # Repetir si contador != 0
+
+MOV R4, 2.0
+LOAD R5, [R4]
+MOV R6, 4.0
+FMUL R6, R7, R6     # R6 = pe * SYNC_STRIDE
+FADD R5, R5, R6     # R5 = RESULT_ADDR(pe)
+STORE R0, [R5]      # Guardar resultado parcial
+
+# ¿master? (pe == NUM_PES-1)
+NPES R6
+MOV R5, -1.0
+FMUL R4, R7, R5     # R4 = -pe
+FADD R6, R6, R4     # R6 = NUM_PES - pe
+DEC R6              # zero_flag = (pe == NUM_PES-1)
+JNZ WORKER
+
+# barrera de sincronización (contador atómico)
+
+MOV R1, 6.0
+LOAD R7, [R1]  # R7 = barrier_check = - (NUM_PES-1)
+MOV R1, 52.0  # R1 = BARRIER_COUNTER_ADDR
+
+WAIT_LOOP:
+MONITOR [R1]         # armar monitor sobre el bloque del contador
+LOAD R2, [R1]        # R2 = trabajadores que llegaron
+FADD R6, R2, R7      # R6 = contador - (NUM_PES-1)
+JNZ WAIT_SLEEP       # si != 0, dormir hasta que cambie el contador
+
+# reducción de resultados parciales
+
+MOV R1, 5.0
+LOAD R2, [R1]  # R2 = NUM_PES
+
+MOV R1, 16.0  # R1 = dirección actual (empieza en RESULTS_ADDR)
+MOV R0, 0.0          # R0 = acumulador final
+MOV R7, 4.0         # R7 = SYNC_STRIDE
+
+REDUCE_LOOP:
+LOAD R4, [R1]        # R4 = resultado_parcial[i]
+FADD R0, R0, R4      # acumulador += resultado_parcial[i]
+FADD R1, R1, R7      # R1 += 4 (siguiente resultado: un bloque por PE)
+DEC R2               # contador--
+JNZ REDUCE_LOOP      # repetir si contador != 0
+
+MOV R2, 48.0
+STORE R0, [R2]       # guardar producto punto final
+
+HALT
+
+WORKER:
+MOV R7, 52.0
+MOV R6, 1.0
+FAA R6, R6, [R7]    # contador de barrera += 1 (atómico)
+HALT
+
+WAIT_SLEEP:
+MWAIT                # dormir (MONITOR armado en WAIT_LOOP)
+JNZ WAIT_LOOP        # zero_flag sigue a 0: volver a comprobar
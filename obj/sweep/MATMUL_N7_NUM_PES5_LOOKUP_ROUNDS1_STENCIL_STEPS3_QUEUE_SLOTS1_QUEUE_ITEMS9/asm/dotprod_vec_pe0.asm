@@ -0,0 +1,35 @@
+# Cargar direcciones desde SHARED_CONFIG
+MOV R4, 0.0
+LOAD R5, [R4]        # R5 = VECTOR_A_ADDR
+
+MOV R4, 1.0
+LOAD R2, [R4]        # R2 = VECTOR_B_ADDR
+
+MOV R4, 8.0
+LOAD R1, [R4]        # R1 = start_index
+
+FADD R5, R5, R1      # R5 = &A[start]
+FADD R2, R2, R1      # R2 = &B[start]
+MOV R7, 4.0       # R7 = BLOCK_SIZE (paso vectorial)
+MOV R0, 0.0          # R0 = acumulador escalar
+
+# cola escalar: 3 elementos
+MOV R3, 3.0
+TAIL_LOOP:
+LOAD R4, [R5]        # R4 = A[i]
+LOAD R6, [R2]        # R6 = B[i]
+FMUL R4, R4, R6      # R4 = A[i] * B[i]
+FADD R0, R0, R4      # acumulador += producto
+INC R5               # siguiente A
+INC R2               # siguiente B
+DEC R3               # contador--
+JNZ TAIL_LOOP        # repetir si contador != 0
+
+MOV R5, 18.0
+STORE R0, [R5]      # Guardar resultado parcial
+
+MOV R7, 23.0
+MOV R6, 1.0         # Flag value
+STORE R6, [R7]      # Señalizar finalización
+
+HALT
@@ -0,0 +1,28 @@
+# histogram: 64 entradas, 8 bins compartidos (SPMD)
+PEID R4
+MOV R5, 8.0
+FADD R5, R5, R4
+FADD R5, R5, R4      # R5 = CFG_PE(pe, 0)
+LOAD R1, [R5]
+INC R5
+LOAD R3, [R5]
+MOV R4, 32.0
+FADD R1, R1, R4      # R1 = &X[inicio]
+MOV R6, 96.0   # R6 = &bins[0]
+MOV R2, 1.0
+MOV R4, 0.0
+FADD R4, R3, R4
+JNZ HIST_LOOP
+MOV R4, 1.0
+FADD R4, R4, R4
+JNZ DONE
+HIST_LOOP:
+LOAD R4, [R1]        # R4 = X[i] (número de bin)
+FADD R4, R4, R6      # R4 = &bins[X[i]]
+FAA R0, R2, [R4]     # bins[X[i]] += 1 (atómico)
+INC R1
+DEC R3
+JNZ HIST_LOOP
+
+DONE:
+HALT
@@ -0,0 +1,86 @@
+# lookup: 16 entradas, 64 consultas, 1 pasadas (SPMD)
+MOV R0, 0.0          # R0 = suma de este PE
+MOV R7, 0.0          # R7 = -(llegadas esperadas en la barrera)
+MOV R2, 32.0   # R2 = entrada que PE0 actualiza tras esta pasada
+
+ROUND:
+PEID R4
+MOV R5, 8.0
+FADD R5, R5, R4
+FADD R5, R5, R4      # R5 = CFG_PE(pe, 0)
+LOAD R1, [R5]
+INC R5
+LOAD R3, [R5]
+MOV R4, 48.0
+FADD R1, R1, R4      # R1 = &claves[inicio]
+MOV R4, 0.0
+FADD R4, R3, R4
+JNZ LOOKUP_LOOP
+MOV R4, 1.0
+FADD R4, R4, R4
+JNZ ROUND_DONE
+LOOKUP_LOOP:
+LOAD R4, [R1]        # clave
+MOV R5, 32.0
+FADD R4, R4, R5
+LOAD R4, [R4]        # tabla[clave]
+FADD R0, R0, R4
+INC R1
+DEC R3
+JNZ LOOKUP_LOOP
+
+ROUND_DONE:
+MOV R4, -5.0
+FADD R7, R7, R4
+MOV R4, 5.0
+FADD R4, R7, R4      # 0 tras la última pasada
+JNZ UPDATE
+MOV R4, 1.0
+FADD R4, R4, R4
+JNZ FINISH
+
+UPDATE:
+MOV R4, 112.0
+MOV R5, 1.0
+FAA R5, R5, [R4]     # llegada a la barrera
+WAIT_READ:
+MONITOR [R4]
+LOAD R5, [R4]
+FADD R5, R5, R7      # R5 = llegadas - esperadas
+JNZ WAIT_READ_SLEEP
+PEID R4
+MOV R5, 0.0
+FADD R4, R4, R5
+JNZ UPDATED          # solo PE0 escribe
+LOAD R5, [R2]
+MOV R4, 1.0
+FADD R5, R5, R4
+STORE R5, [R2]       # tabla[pasada] += 1
+UPDATED:
+INC R2
+MOV R4, 116.0
+MOV R5, 1.0
+FAA R5, R5, [R4]     # llegada a la barrera
+WAIT_WRITE:
+MONITOR [R4]
+LOAD R5, [R4]
+FADD R5, R5, R7      # R5 = llegadas - esperadas
+JNZ WAIT_WRITE_SLEEP
+MOV R4, 1.0
+FADD R4, R4, R4
+JNZ ROUND
+
+FINISH:
+PEID R4
+MOV R5, 18.0
+FADD R5, R5, R4      # R5 = RESULT_ADDR(pe)
+STORE R0, [R5]
+HALT
+
+WAIT_READ_SLEEP:
+MWAIT                # dormir hasta que otro PE incremente el contador
+JNZ WAIT_READ          # zero_flag sigue a 0: volver a comprobar
+
+WAIT_WRITE_SLEEP:
+MWAIT                # dormir hasta que otro PE incremente el contador
+JNZ WAIT_WRITE          # zero_flag sigue a 0: volver a comprobar
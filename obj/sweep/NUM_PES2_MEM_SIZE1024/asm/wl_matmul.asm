@@ -0,0 +1,50 @@
+# matmul: C = A * B (4x4), filas de C repartidas entre PEs (SPMD)
+PEID R4
+MOV R5, 8.0
+FADD R5, R5, R4
+FADD R5, R5, R4      # R5 = CFG_PE(pe, 0)
+LOAD R1, [R5]
+INC R5
+LOAD R7, [R5]
+# R1 = fila * N (desplazamiento de la primera fila), R7 = filas
+MOV R4, 52.0
+FADD R6, R1, R4      # R6 = &C[fila][0]
+MOV R4, 20.0
+FADD R1, R1, R4      # R1 = &A[fila][0]
+MOV R4, 0.0
+FADD R4, R7, R4
+JNZ ROW_LOOP
+MOV R4, 1.0
+FADD R4, R4, R4
+JNZ DONE
+ROW_LOOP:
+MOV R2, 36.0   # R2 = &BT[0][0] (columna 0 de B)
+
+COL_LOOP:
+MOV R0, 0.0          # R0 = C[fila][col]
+MOV R3, 4.0
+K_LOOP:
+LOAD R4, [R1]        # A[fila][k]
+LOAD R5, [R2]        # B[k][col] = BT[col][k]
+FMUL R4, R4, R5
+FADD R0, R0, R4
+INC R1
+INC R2
+DEC R3
+JNZ K_LOOP
+
+STORE R0, [R6]
+INC R6
+MOV R4, -4.0
+FADD R1, R1, R4      # volver al inicio de la fila de A
+MOV R4, -52.0
+FADD R4, R2, R4      # 0 tras la última columna de B
+JNZ COL_LOOP
+
+MOV R4, 4.0
+FADD R1, R1, R4      # siguiente fila de A
+DEC R7
+JNZ ROW_LOOP
+
+DONE:
+HALT
@@ -0,0 +1,92 @@
+# Cargar VECTOR_A_ADDR (addr 0)
+LOAD R5, [0]        # R5 = VECTOR_A_ADDR
+
+LOAD R2, [1]        # R2 = VECTOR_B_ADDR
+
+LOAD R1, [12]       # R1 = start_index
+
+MOV R0, 0.0         # R0 = acumulador (resultado parcial)
+MOV R3, 1.0         # iteraciones de 4 elementos
+
+LOOP_START:
+FADD R4, R5, R1     # R4 = VECTOR_A_ADDR + i
+LOAD R4, [R4]       # R4 = A[i]
+FADD R6, R2, R1     # R6 = VECTOR_B_ADDR + i
+LOAD R6, [R6]       # R6 = B[i]
+FMUL R4, R4, R6     # R4 = A[i] * B[i]
+FADD R0, R0, R4     # acumulador += producto
+INC R1              # i++
+FADD R4, R5, R1     # R4 = VECTOR_A_ADDR + i
+LOAD R4, [R4]       # R4 = A[i]
+FADD R6, R2, R1     # R6 = VECTOR_B_ADDR + i
+LOAD R6, [R6]       # R6 = B[i]
+FMUL R4, R4, R6     # R4 = A[i] * B[i]
+FADD R0, R0, R4     # acumulador += producto
+INC R1              # i++
+FADD R4, R5, R1     # R4 = VECTOR_A_ADDR + i
+LOAD R4, [R4]       # R4 = A[i]
+FADD R6, R2, R1     # R6 = VECTOR_B_ADDR + i
+LOAD R6, [R6]       # R6 = B[i]
+FMUL R4, R4, R6     # R4 = A[i] * B[i]
+FADD R0, R0, R4     # acumulador += producto
+INC R1              # i++
+FADD R4, R5, R1     # R4 = VECTOR_A_ADDR + i
+LOAD R4, [R4]       # R4 = A[i]
+FADD R6, R2, R1     # R6 = VECTOR_B_ADDR + i
+LOAD R6, [R6]       # R6 = B[i]
+FMUL R4, R4, R6     # R4 = A[i] * B[i]
+FADD R0, R0, R4     # acumulador += producto
+INC R1              # i++
+DEC R3              # contador--
+JNZ LOOP_START      # Repetir si contador != 0
+
+# resto: 2 elemento(s)
+FADD R4, R5, R1     # R4 = VECTOR_A_ADDR + i
+LOAD R4, [R4]       # R4 = A[i]
+FADD R6, R2, R1     # R6 = VECTOR_B_ADDR + i
+LOAD R6, [R6]       # R6 = B[i]
+FMUL R4, R4, R6     # R4 = A[i] * B[i]
+FADD R0, R0, R4     # acumulador += producto
+INC R1              # i++
+FADD R4, R5, R1     # R4 = VECTOR_A_ADDR + i
+LOAD R4, [R4]       # R4 = A[i]
+FADD R6, R2, R1     # R6 = VECTOR_B_ADDR + i
+LOAD R6, [R6]       # R6 = B[i]
+FMUL R4, R4, R6     # R4 = A[i] * B[i]
+FADD R0, R0, R4     # acumulador += producto
+INC R1              # i++
+
+STORE R0, [16]      # guardar en RESULTS_ADDR + 2
+
+# barrera de sincronización
+
+LOAD R7, [6]        # R7 = barrier_check = - (NUM_PES-1)
+
+WAIT_LOOP:
+MONITOR [17]        # armar monitor sobre el bloque de flags
+LOAD R2, [17]       # R2 = flag[PE0]
+
+LOAD R4, [18]       # R4 = flag[PE1]
+FADD R2, R2, R4     # R2 += flag1
+
+FADD R6, R2, R7     # R6 = suma_flags - (NUM_PES-1)
+
+JNZ WAIT_SLEEP      # si != 0, dormir hasta que cambie un flag
+
+# reducción de resultados parciales (desenrollada)
+
+MOV R0, 0.0         # R0 = acumulador final
+LOAD R4, [14]       # R4 = resultado_parcial[0]
+FADD R0, R0, R4     # acumulador += resultado_parcial[0]
+LOAD R4, [15]       # R4 = resultado_parcial[1]
+FADD R0, R0, R4     # acumulador += resultado_parcial[1]
+LOAD R4, [16]       # R4 = resultado_parcial[2]
+FADD R0, R0, R4     # acumulador += resultado_parcial[2]
+
+STORE R0, [20]      # guardar producto punto final
+
+HALT
+
+WAIT_SLEEP:
+MWAIT               # dormir (MONITOR armado en WAIT_LOOP)
+JNZ WAIT_LOOP       # zero_flag sigue a 0: volver a comprobar
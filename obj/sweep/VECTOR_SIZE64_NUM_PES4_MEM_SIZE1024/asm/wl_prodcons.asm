@@ -0,0 +1,97 @@
+# prodcons: cola de 4 slots, 16 elementos por pareja de PEs (SPMD)
+PEID R4
+MOV R5, 8.0
+FADD R5, R5, R4
+FADD R5, R5, R4      # R5 = CFG_PE(pe, 0)
+LOAD R7, [R5]
+INC R5
+LOAD R6, [R5]
+# R7 = base de la cola del par, R6 = rol (1 productor, 2 consumidor, 0 sin pareja)
+ROI                  # inicio de la región de interés (fin de SIM_FASTFWD=roi)
+MOV R4, 0.0
+FADD R4, R6, R4
+JNZ HAS_ROLE
+MOV R4, 1.0
+FADD R4, R4, R4
+JNZ DONE
+HAS_ROLE:
+MOV R1, 0.0          # R1 = elementos producidos / consumidos
+MOV R2, 0.0
+FADD R2, R2, R7      # R2 = slot actual
+MOV R3, 4.0   # R3 = slots hasta dar la vuelta
+DEC R6
+JNZ CONSUMER
+MOV R6, 16.0
+
+P_LOOP:
+MOV R4, 4.0
+FADD R4, R7, R4      # R4 = &head
+P_WAIT:
+MONITOR [R4]
+LOAD R5, [R4]        # R5 = consumidos
+MOV R0, 4.0
+FADD R5, R5, R0
+MOV R0, -1.0
+FMUL R0, R1, R0
+FADD R5, R5, R0      # R5 = huecos = consumidos + SLOTS - producidos
+JNZ P_PUT
+MWAIT                # cola llena: dormir hasta que el consumidor publique head
+MOV R0, 1.0
+FADD R0, R0, R0
+JNZ P_WAIT
+P_PUT:
+INC R1
+FADD R0, R1, R7      # R0 = elemento: base del par + número de orden (1..ITEMS)
+STORE R0, [R2]
+MOV R5, 8.0
+FADD R5, R7, R5
+STORE R1, [R5]       # publicar tail
+INC R2
+DEC R3
+JNZ P_NEXT
+MOV R2, 0.0
+FADD R2, R2, R7      # volver al primer slot
+MOV R3, 4.0
+P_NEXT:
+DEC R6
+JNZ P_LOOP
+HALT
+
+CONSUMER:
+MOV R6, 16.0
+C_LOOP:
+MOV R4, 8.0
+FADD R4, R7, R4      # R4 = &tail
+C_WAIT:
+MONITOR [R4]
+LOAD R5, [R4]        # R5 = producidos
+MOV R0, -1.0
+FMUL R0, R1, R0
+FADD R5, R5, R0      # R5 = disponibles = producidos - consumidos
+JNZ C_GET
+MWAIT                # cola vacía: dormir hasta que el productor publique tail
+MOV R0, 1.0
+FADD R0, R0, R0
+JNZ C_WAIT
+C_GET:
+LOAD R0, [R2]        # R0 = elemento
+MOV R5, 12.0
+FADD R5, R7, R5
+FADD R5, R5, R1
+STORE R0, [R5]       # salida[consumidos] = elemento
+INC R1
+MOV R5, 4.0
+FADD R5, R7, R5
+STORE R1, [R5]       # publicar head
+INC R2
+DEC R3
+JNZ C_NEXT
+MOV R2, 0.0
+FADD R2, R2, R7      # volver al primer slot
+MOV R3, 4.0
+C_NEXT:
+DEC R6
+JNZ C_LOOP
+
+DONE:
+HALT
@@ -0,0 +1,231 @@
+#!/usr/bin/env python3
+"""
+Benchmark de throughput del simulador (make bench)
+Ejecuta una matriz fija de cargas: el producto punto con VECTOR_SIZE 16/19/64
+(vectores CSV de data/) y tamaños sintéticos grandes (SIM_VECTORS=synthetic),
+con varios números de PEs. Cada variante se compila con scripts/sweep.py en
+obj/sweep/<variante>/ (MEM_SIZE se ajusta al tamaño del vector).
+
+Por punto reporta (mediana de --repeat ejecuciones):
+    instr_per_s     instrucciones simuladas / tiempo de la sección paralela
+    bus_txn_per_s   transacciones de bus / tiempo de la sección paralela
+    host_wall_s     tiempo de pared del proceso completo (carga, ensamblado, informe)
+    peak_rss_kb     memoria residente máxima del proceso
+    cpu_{pe,bus,mem}_{user,sys}_s   CPU por hilo (RUSAGE_THREAD, impresa por el simulador):
+                    suma de los hilos PE, hilo del bus, hilo de memoria
+    proc_cpu_user_s, proc_cpu_sys_s   CPU del proceso completo (wait4), incluye el
+                    hilo principal y los auxiliares
+
+Salida: obj/bench/results.json y obj/bench/results.csv.
+Con --baseline compara contra un resultado guardado (--save-baseline) y
+termina con código 1 si algún punto pierde más de --tolerance en
+instr_per_s o bus_txn_per_s, o si no da CORRECT. Los puntos con menos de
+--min-wall segundos de sección paralela se muestran sin comparar. La línea base depende del
+host: se guarda en la misma máquina en la que se compara.
+
+Uso:
+    python3 scripts/bench.py --save-baseline bench_baseline.json
+    python3 scripts/bench.py --baseline bench_baseline.json
+    python3 scripts/bench.py --sizes 64,8192 --pes 4 --kernels scalar,vector
+"""
+
+import argparse
+import csv
+import json
+import os
+import statistics
+import subprocess
+import sys
+import time
+from concurrent.futures import ThreadPoolExecutor
+
+import sweep
+
+BENCH_DIR = os.path.join("obj", "bench")
+CSV_SIZES = {16, 19, 64}             # Sizes with vector files in data/
+CODE_SLOT_SIZE = 64                  # config.h; la región de código es max(NUM_PES, 2) * CODE_SLOT_SIZE
+RATES = ["instr_per_s", "bus_txn_per_s"]
+CPU_THREADS = [f"cpu_{t}_{m}_s" for t in ("pe", "bus", "mem") for m in ("user", "sys")]
+
+
+def _mem_size(vector_size, num_pes, block_size=4):
+    """Potencia de 2 (mínimo 512) que cabe config + sincronización + A + B + código."""
+    need = 64 + 2 * (vector_size + 2 * num_pes * block_size) + max(num_pes, 2) * CODE_SLOT_SIZE
+    size = 512
+    while size < need:
+        size *= 2
+    return size
+
+
+def run_point(vdir, env_params, timeout):
+    """Una ejecución: contadores y CPU por hilo impresos por el simulador + CPU y RSS máximo del proceso (wait4)."""
+    env = dict(os.environ, NO_COLOR="1", LOG_LEVEL="WARN", **env_params)
+    out_path = os.path.join(vdir, "bench_stdout.txt")
+    start = time.perf_counter()
+    with open(out_path, "w") as out:
+        proc = subprocess.Popen(["./mp_mesi"], cwd=vdir, env=env, stdout=out,
+                                stderr=subprocess.DEVNULL)
+        deadline = start + timeout
+        while True:
+            pid, status, usage = os.wait4(proc.pid, os.WNOHANG)
+            if pid:
+                break
+            if time.perf_counter() > deadline:
+                proc.kill()
+                os.wait4(proc.pid, 0)
+                return {"status": "TIMEOUT"}
+            time.sleep(0.002)
+    wall = time.perf_counter() - start
+    proc.returncode = os.waitstatus_to_exitcode(status)
+
+    with open(out_path) as f:
+        row = sweep.parse_output(f.read())
+    if proc.returncode != 0 and row.get("status", "CORRECT") == "CORRECT":
+        row["status"] = f"EXIT{proc.returncode}"
+    row.setdefault("status", "NO_STATUS")
+
+    sim_wall = row.get("wall_s") or 0.0
+    row["instr_per_s"] = round(row.get("instructions", 0) / sim_wall) if sim_wall else 0
+    row["bus_txn_per_s"] = round(row.get("bus_total", 0) / sim_wall) if sim_wall else 0
+    row["host_wall_s"] = round(wall, 4)
+    row["peak_rss_kb"] = usage.ru_maxrss
+    row["proc_cpu_user_s"] = round(usage.ru_utime, 4)
+    row["proc_cpu_sys_s"] = round(usage.ru_stime, 4)
+    return row
+
+
+def _median_row(rows):
+    """Contadores de la primera ejecución; métricas de tiempo como mediana."""
+    merged = dict(rows[0])
+    for key in RATES + ["host_wall_s", "wall_s", "peak_rss_kb", "proc_cpu_user_s", "proc_cpu_sys_s"] + CPU_THREADS:
+        values = [r[key] for r in rows if key in r]
+        if values:
+            merged[key] = statistics.median(values)
+    merged["peak_rss_kb"] = int(merged.get("peak_rss_kb", 0))
+    bad = [r["status"] for r in rows if r["status"] != "CORRECT"]
+    merged["status"] = bad[0] if bad else "CORRECT"
+    return merged
+
+
+def _key(row):
+    return f"{row['kernel']}/VECTOR_SIZE={row['vector_size']}/NUM_PES={row['num_pes']}"
+
+
+def compare(rows, baseline, tolerance, min_wall):
+    """Imprime la variación respecto a la línea base; devuelve los puntos con regresión.
+    Los puntos con una sección paralela más corta que min_wall se muestran pero
+    no cuentan: con pocos milisegundos el ruido del host supera la tolerancia."""
+    base = {_key(r): r for r in baseline}
+    regressions = []
+    print(f"\n{'point':<36} {'metric':<14} {'baseline':>12} {'current':>12} {'change':>8}")
+    for row in rows:
+        old = base.get(_key(row))
+        if not old:
+            print(f"{_key(row):<36} (no baseline)")
+            continue
+        for metric in RATES:
+            a, b = old.get(metric, 0), row.get(metric, 0)
+            if not a:
+                continue
+            change = (b - a) / a
+            flag = ""
+            if min(old.get("wall_s", 0), row.get("wall_s", 0)) < min_wall:
+                flag = "  (noisy)"
+            elif change < -tolerance:
+                flag = "  REGRESSION"
+                regressions.append((_key(row), metric))
+            print(f"{_key(row):<36} {metric:<14} {a:>12.0f} {b:>12.0f} {100 * change:>+7.1f}%{flag}")
+    return regressions
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Throughput del simulador sobre una matriz fija")
+    parser.add_argument("--sizes", default="16,19,64,1024,8192",
+                        help="VECTOR_SIZE (16/19/64 usan data/; el resto, SIM_VECTORS=synthetic)")
+    parser.add_argument("--pes", default="2,4,8", help="valores de NUM_PES")
+    parser.add_argument("--kernels", default="scalar,vector", help="valores de SIM_KERNEL")
+    parser.add_argument("--repeat", type=int, default=3, help="ejecuciones por punto (mediana)")
+    parser.add_argument("--timeout", type=float, default=600, help="segundos por ejecución")
+    parser.add_argument("--baseline", help="JSON guardado con --save-baseline contra el que comparar")
+    parser.add_argument("--save-baseline", help="guarda los resultados como línea base")
+    parser.add_argument("--tolerance", type=float, default=0.10,
+                        help="caída relativa de instr_per_s o bus_txn_per_s tolerada (0.10 = 10%%)")
+    parser.add_argument("--min-wall", type=float, default=0.05,
+                        help="segundos de sección paralela por debajo de los cuales no se compara")
+    parser.add_argument("--jobs", type=int, default=os.cpu_count() or 1,
+                        help="compilaciones concurrentes (las ejecuciones son secuenciales)")
+    args = parser.parse_args()
+
+    os.chdir(sweep.ROOT)
+    sizes = [int(s) for s in args.sizes.split(",")]
+    pes = [int(p) for p in args.pes.split(",")]
+    kernels = args.kernels.split(",")
+
+    variants = [{"VECTOR_SIZE": str(n), "NUM_PES": str(p), "MEM_SIZE": str(_mem_size(n, p))}
+                for n in sizes for p in pes]
+    print(f"Compilando {len(variants)} variante(s)...")
+    with ThreadPoolExecutor(max_workers=args.jobs) as pool:
+        builds = list(pool.map(sweep.build_variant, variants))
+    for params, (vdir, error) in zip(variants, builds):
+        if error:
+            sys.exit(f"{vdir}: {' '.join(error)}")
+
+    # Sequential runs: concurrent points would compete for the host cores they measure
+    rows = []
+    for params, (vdir, _) in zip(variants, builds):
+        n = int(params["VECTOR_SIZE"])
+        for kernel in kernels:
+            env = {"SIM_KERNEL": kernel}
+            if n not in CSV_SIZES:
+                env["SIM_VECTORS"] = "synthetic"
+            runs = [run_point(vdir, env, args.timeout) for _ in range(args.repeat)]
+            row = {"kernel": kernel, "vector_size": n, "num_pes": int(params["NUM_PES"]),
+                   "mem_size": int(params["MEM_SIZE"]), **_median_row(runs)}
+            rows.append(row)
+            print(f"  {_key(row):<36} {row['status']:<8} "
+                  f"{row.get('instr_per_s', 0):>10.0f} instr/s {row.get('bus_txn_per_s', 0):>9.0f} txn/s "
+                  f"wall={row.get('host_wall_s', 0):.3f}s rss={row.get('peak_rss_kb', 0)}KB "
+                  f"cpu pe={row.get('cpu_pe_user_s', 0) + row.get('cpu_pe_sys_s', 0):.3f}s "
+                  f"bus={row.get('cpu_bus_user_s', 0) + row.get('cpu_bus_sys_s', 0):.3f}s "
+                  f"mem={row.get('cpu_mem_user_s', 0) + row.get('cpu_mem_sys_s', 0):.3f}s "
+                  f"proc={row.get('proc_cpu_user_s', 0) + row.get('proc_cpu_sys_s', 0):.3f}s", flush=True)
+
+    os.makedirs(BENCH_DIR, exist_ok=True)
+    json_path = os.path.join(BENCH_DIR, "results.json")
+    with open(json_path, "w") as f:
+        json.dump(rows, f, indent=2)
+    columns = []
+    for row in rows:
+        columns += [c for c in row if c not in columns]
+    with open(os.path.join(BENCH_DIR, "results.csv"), "w", newline="") as f:
+        writer = csv.DictWriter(f, fieldnames=columns)
+        writer.writeheader()
+        writer.writerows(rows)
+    print(f"Resultados -> {json_path}")
+
+    failed = [r for r in rows if r["status"] != "CORRECT"]
+    if args.save_baseline:
+        if failed:
+            sys.exit("No se guarda la línea base: hay puntos que no dan CORRECT")
+        with open(args.save_baseline, "w") as f:
+            json.dump(rows, f, indent=2)
+        print(f"Línea base guardada en {args.save_baseline}")
+
+    regressions = []
+    if args.baseline:
+        if os.path.exists(args.baseline):
+            with open(args.baseline) as f:
+                regressions = compare(rows, json.load(f), args.tolerance, args.min_wall)
+        else:
+            print(f"Sin línea base en {args.baseline} (créela con make bench-baseline)")
+
+    if failed:
+        print(f"{len(failed)} punto(s) sin CORRECT")
+    if regressions:
+        print(f"{len(regressions)} métrica(s) por debajo de la línea base en más de "
+              f"{100 * args.tolerance:.0f}%")
+    sys.exit(1 if failed or regressions else 0)
+
+
+if __name__ == "__main__":
+    main()
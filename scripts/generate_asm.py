@@ -4,10 +4,25 @@ Generador de programas assembly para producto punto paralelo
 Genera archivos .asm parametrizados basados en config.h
 """
 
+import os
 import re
 import ast
 import operator
 
+# Directorio de salida y overrides -DNOMBRE=valor (los mismos que recibe el
+# compilador vía `make SIM_DEFS=...`; los usa scripts/sweep.py)
+ASM_DIR = os.environ.get("SIM_ASM_DIR", "asm")
+SIM_DEFS = os.environ.get("SIM_DEFS", "")
+
+def _apply_defs(content: str, defs: str) -> str:
+    """Reemplaza en el texto de config.h los #define sobrescritos con -DNOMBRE=valor."""
+    for token in defs.split():
+        match = re.fullmatch(r'-D(\w+)=(\S+)', token)
+        if match:
+            name, value = match.groups()
+            content = re.sub(rf'(#define\s+{name}\s+)\S+', rf'\g<1>{value}', content)
+    return content
+
 def _parse_int(token: str):
     """Parse ints possibly in hex (0x..)."""
     token = token.strip()
@@ -42,12 +57,46 @@ def _safe_eval_expr(expr: str, symbols: dict):
     except Exception:
         return None
 
+class _Defines(dict):
+    """Símbolos de config.h que se evalúan al pedirlos: un #define de objeto
+    (no de función) con una expresión aritmética de otros #define"""
+
+    def __init__(self, content):
+        super().__init__()
+        self.raw = {}
+        for line in content.splitlines():
+            match = re.match(r'\s*#define\s+(\w+)\s+(.+)$', line)
+            if match and match.group(1) not in self.raw:
+                self.raw[match.group(1)] = match.group(2).split('//')[0].strip()
+
+    def __contains__(self, name):
+        if not dict.__contains__(self, name) and name in self.raw:
+            raw = self.raw.pop(name)  # evita ciclos
+            val = _parse_int(raw)
+            if val is None:
+                val = _safe_eval_expr(raw, self)
+            if val is not None:
+                self[name] = val
+        return dict.__contains__(self, name)
+
+# Macros de config.h que usan los programas de src/workloads/
+WORKLOAD_VARS = [
+    'MATMUL_N', 'MATMUL_A_ADDR', 'MATMUL_BT_ADDR', 'MATMUL_C_ADDR',
+    'HIST_SIZE', 'HIST_BINS', 'HIST_INPUT_ADDR', 'HIST_BINS_ADDR',
+    'STENCIL_ROWS', 'STENCIL_COLS', 'STENCIL_STEPS', 'STENCIL_GRID0_ADDR', 'STENCIL_GRID1_ADDR',
+    'STENCIL_BARRIER0_ADDR', 'STENCIL_BARRIER1_ADDR',
+    'QUEUE_SLOTS', 'QUEUE_ITEMS', 'QUEUE_HEAD_OFFSET', 'QUEUE_TAIL_OFFSET', 'QUEUE_OUT_OFFSET',
+    'LOOKUP_ENTRIES', 'LOOKUP_QUERIES', 'LOOKUP_ROUNDS', 'LOOKUP_TABLE_ADDR', 'LOOKUP_KEYS_ADDR',
+    'LOOKUP_BARRIER0_ADDR', 'LOOKUP_BARRIER1_ADDR',
+]
+
 def read_config_h():
     """Lee la configuración desde config.h"""
     config = {}
     try:
         with open('src/include/config.h', 'r') as f:
-            content = f.read()
+            content = _apply_defs(f.read(), SIM_DEFS)
+            defines = _Defines(content)
             
             # Buscar VECTOR_SIZE
             match = re.search(r'#define\s+VECTOR_SIZE\s+(\d+)', content)
@@ -59,17 +108,22 @@ def read_config_h():
             if match:
                 config['NUM_PES'] = int(match.group(1))
             
-            # Buscar constantes básicas (acepta hex o expresiones simples)
-            for var in ['SHARED_CONFIG_ADDR', 'RESULTS_ADDR', 'FLAGS_ADDR', 'FINAL_RESULT_ADDR']:
-                match = re.search(rf'#define\s+{var}\s+([^\n]+)', content)
-                if match:
-                    raw = match.group(1).strip()
-                    val = _parse_int(raw)
-                    if val is None:
-                        # intentar evaluar usando símbolos ya encontrados
-                        val = _safe_eval_expr(raw, config)
-                    if val is not None:
-                        config[var] = int(val)
+            # Buscar ASM_UNROLL (desenrollado del kernel optimizado)
+            match = re.search(r'#define\s+ASM_UNROLL\s+(\d+)', content)
+            if match:
+                config['ASM_UNROLL'] = int(match.group(1))
+            
+            # Buscar BLOCK_SIZE (lanes de las instrucciones vectoriales)
+            match = re.search(r'#define\s+BLOCK_SIZE\s+(\d+)', content)
+            if match:
+                config['BLOCK_SIZE'] = int(match.group(1))
+            
+            # Layout de la zona de sincronización (mismas macros que usa el C;
+            # LAYOUT_PADDED cambia las direcciones y el paso entre PEs)
+            for var in ['SHARED_CONFIG_ADDR', 'RESULTS_ADDR', 'FLAGS_ADDR', 'FINAL_RESULT_ADDR',
+                        'BARRIER_COUNTER_ADDR', 'SYNC_STRIDE']:
+                if var in defines:
+                    config[var] = int(defines[var])
             
             # Buscar offsets dentro de SHARED_CONFIG
             for var in ['CFG_VECTOR_A_ADDR', 'CFG_VECTOR_B_ADDR', 'CFG_RESULTS_ADDR',
@@ -84,6 +138,11 @@ def read_config_h():
                     if val is not None:
                         config[var] = int(val)
             
+            # Cargas de trabajo (SIM_WORKLOAD): tamaños y direcciones
+            for var in WORKLOAD_VARS:
+                if var in defines:
+                    config[var] = int(defines[var])
+            
             # Calcular SEGMENT_SIZE para workers y master
             if 'VECTOR_SIZE' in config and 'NUM_PES' in config:
                 config['SEGMENT_SIZE_WORKER'] = config['VECTOR_SIZE'] // config['NUM_PES']
@@ -105,6 +164,8 @@ if config:
     SEGMENT_SIZE_WORKER = config['SEGMENT_SIZE_WORKER']
     SEGMENT_SIZE_MASTER = config['SEGMENT_SIZE_MASTER']
     RESIDUE = config['RESIDUE']
+    BLOCK_SIZE = config.get('BLOCK_SIZE', 4)
+    ASM_UNROLL = config.get('ASM_UNROLL', 1)
     
     # Nuevo layout: shared config area
     SHARED_CONFIG_ADDR = config.get('SHARED_CONFIG_ADDR', 0)
@@ -128,6 +189,8 @@ if config:
         RESULTS_ADDR = base
         FLAGS_ADDR = RESULTS_ADDR + config.get('NUM_PES', 4)
         FINAL_RESULT_ADDR = FLAGS_ADDR + config.get('NUM_PES', 4)
+    BARRIER_COUNTER_ADDR = config.get('BARRIER_COUNTER_ADDR', FINAL_RESULT_ADDR + 1)
+    SYNC_STRIDE = config.get('SYNC_STRIDE', 1)
 else:
     # Valores por defecto
     VECTOR_SIZE = 16
@@ -135,6 +198,8 @@ else:
     SEGMENT_SIZE_WORKER = VECTOR_SIZE // NUM_PES
     RESIDUE = VECTOR_SIZE % NUM_PES
     SEGMENT_SIZE_MASTER = SEGMENT_SIZE_WORKER + RESIDUE
+    BLOCK_SIZE = 4
+    ASM_UNROLL = 1
     
     SHARED_CONFIG_ADDR = 0
     CFG_VECTOR_A_ADDR = 0
@@ -149,9 +214,19 @@ else:
     RESULTS_ADDR = 16
     FLAGS_ADDR = 20
     FINAL_RESULT_ADDR = 24
+    BARRIER_COUNTER_ADDR = 25
+    SYNC_STRIDE = 1
 
-def generate_worker_pe(pe_id):
-    """Genera código assembly GENÉRICO para PE trabajador (PE0-PE2)
+def _result_addr(pe_id):
+    """RESULT_ADDR(pe) de config.h: consecutivos o uno por bloque (LAYOUT_PADDED)"""
+    return RESULTS_ADDR + pe_id * SYNC_STRIDE
+
+def _flag_addr(pe_id):
+    """FLAG_ADDR(pe) de config.h"""
+    return FLAGS_ADDR + pe_id * SYNC_STRIDE
+
+def _scalar_partial_product(pe_id):
+    """Producto punto parcial escalar de un PE trabajador.
     CARGA TODOS LOS PARÁMETROS DESDE SHARED_CONFIG EN MEMORIA"""
     
     # Calcular offset dentro de CFG_PE para este PE
@@ -172,6 +247,7 @@ LOAD R1, [R4]        # R1 = start_index (índice, no dirección)
 
 MOV R4, {float(cfg_segment_size_addr)}
 LOAD R3, [R4]        # R3 = segment_size (contador del loop)
+ROI                  # inicio de la región de interés (fin de SIM_FASTFWD=roi)
 
 MOV R0, 0.0         # R0 = acumulador (resultado parcial)
 
@@ -185,11 +261,19 @@ FADD R0, R0, R4     # acumulador += producto
 INC R1              # i++
 DEC R3              # contador--
 JNZ LOOP_START      # Repetir si contador != 0
+"""
+    return code
 
-MOV R5, {float(RESULTS_ADDR + pe_id)}
+def generate_worker_pe(pe_id):
+    """Genera código assembly GENÉRICO para PE trabajador (PE0-PE2)
+    CARGA TODOS LOS PARÁMETROS DESDE SHARED_CONFIG EN MEMORIA"""
+    
+    code = _scalar_partial_product(pe_id)
+    code += f"""
+MOV R5, {float(_result_addr(pe_id))}
 STORE R0, [R5]      # Guardar resultado parcial
 
-MOV R7, {float(FLAGS_ADDR + pe_id)}
+MOV R7, {float(_flag_addr(pe_id))}
 MOV R6, 1.0         # Flag value
 STORE R6, [R7]      # Señalizar finalización
 
@@ -197,6 +281,75 @@ HALT
 """
     return code
 
+def _master_barrier_and_reduce():
+    """Barrera de sincronización y reducción final del PE master (común a
+    las variantes escalar y vectorial)"""
+    return _flag_barrier() + _reduce()
+
+def _flag_barrier():
+    """Barrera por flags: el master suma un flag por PE trabajador (NUM_PES-1)"""
+    loads = "".join(f"""
+MOV R1, {float(_flag_addr(i))}
+LOAD R4, [R1]        # R4 = flag[PE{i}]
+FADD R2, R2, R4      # R2 += flag{i}
+""" for i in range(1, NUM_PES - 1))
+    # MWAIT solo despierta con escrituras al bloque monitorizado: si los flags
+    # ocupan más de un bloque, la barrera vuelve a sondear sin dormir
+    single_block = FLAGS_ADDR // BLOCK_SIZE == _flag_addr(NUM_PES - 2) // BLOCK_SIZE
+    wait = "JNZ WAIT_SLEEP       # si != 0, dormir hasta que cambie un flag" if single_block \
+        else "JNZ WAIT_LOOP        # si != 0, volver a sondear (flags en varios bloques)"
+    return f"""
+# barrera de sincronización
+
+MOV R1, {float(CFG_BARRIER_CHECK_ADDR)}
+LOAD R7, [R1]  # R7 = barrier_check = - (NUM_PES-1)
+
+WAIT_LOOP:
+MOV R1, {float(FLAGS_ADDR)}
+MONITOR [R1]         # armar monitor sobre el bloque de flags
+LOAD R2, [R1]        # R2 = flag[PE0]
+{loads}
+FADD R6, R2, R7      # R6 = suma_flags - (NUM_PES-1)
+
+{wait}
+"""
+
+def _wait_sleep():
+    """Cola de la barrera (tras HALT): MWAIT duerme al PE hasta que otro PE
+    escriba el bloque monitorizado, en lugar de repetir la espera activa"""
+    return f"""
+WAIT_SLEEP:
+MWAIT                # dormir (MONITOR armado en WAIT_LOOP)
+JNZ WAIT_LOOP        # zero_flag sigue a 0: volver a comprobar
+"""
+
+def _reduce():
+    """Reducción de resultados parciales y almacenamiento del resultado final"""
+    if SYNC_STRIDE == 1:
+        step = "INC R1               # R1++ (siguiente resultado: compacto, +1 dirección)"
+    else:
+        step = f"FADD R1, R1, R7      # R1 += {SYNC_STRIDE} (siguiente resultado: un bloque por PE)"
+    stride = "" if SYNC_STRIDE == 1 else f"MOV R7, {float(SYNC_STRIDE)}         # R7 = SYNC_STRIDE\n"
+    return f"""
+# reducción de resultados parciales
+
+MOV R1, {float(CFG_NUM_PES_ADDR)}
+LOAD R2, [R1]  # R2 = NUM_PES
+
+MOV R1, {float(RESULTS_ADDR)}  # R1 = dirección actual (empieza en RESULTS_ADDR)
+MOV R0, 0.0          # R0 = acumulador final
+{stride}
+REDUCE_LOOP:
+LOAD R4, [R1]        # R4 = resultado_parcial[i]
+FADD R0, R0, R4      # acumulador += resultado_parcial[i]
+{step}
+DEC R2               # contador--
+JNZ REDUCE_LOOP      # repetir si contador != 0
+
+MOV R2, {float(FINAL_RESULT_ADDR)}
+STORE R0, [R2]       # guardar producto punto final
+"""
+
 def generate_master_pe(pe_id=3):
     
     cfg_start_idx_addr = CFG_PE_START_ADDR + pe_id * 2
@@ -215,6 +368,7 @@ LOAD R1, [R4]        # R1 = start_index
 
 MOV R4, {float(cfg_segment_size_addr)}
 LOAD R3, [R4]        # R3 = segment_size (contador)
+ROI                  # inicio de la región de interés (fin de SIM_FASTFWD=roi)
 
 MOV R0, 0.0         # R0 = acumulador
 
@@ -229,79 +383,861 @@ INC R1              # i++
 DEC R3              # contador--
 JNZ LOOP_START      # repetir si contador != 0
 
-MOV R5, {float(RESULTS_ADDR + pe_id)}
+MOV R5, {float(_result_addr(pe_id))}
 STORE R0, [R5]      # guardar en RESULTS_ADDR + {pe_id}
+{_master_barrier_and_reduce()}
+HALT
+{_wait_sleep()}"""
+    return code
 
-# barrera de sincronización
+def _vector_partial_product(pe_id, segment_size):
+    """Producto punto parcial vectorizado: VLOAD/VFMA sobre bloques de
+    BLOCK_SIZE elementos y cola escalar para el resto. El número de
+    iteraciones se conoce al generar (segment_size es fijo por PE)."""
+    cfg_start_idx_addr = CFG_PE_START_ADDR + pe_id * 2
+    vec_iters = segment_size // BLOCK_SIZE
+    tail = segment_size % BLOCK_SIZE
+
+    code = f"""# Cargar direcciones desde SHARED_CONFIG
+MOV R4, {float(CFG_VECTOR_A_ADDR)}
+LOAD R5, [R4]        # R5 = VECTOR_A_ADDR
+
+MOV R4, {float(CFG_VECTOR_B_ADDR)}
+LOAD R2, [R4]        # R2 = VECTOR_B_ADDR
+
+MOV R4, {float(cfg_start_idx_addr)}
+LOAD R1, [R4]        # R1 = start_index
+ROI                  # inicio de la región de interés (fin de SIM_FASTFWD=roi)
+
+FADD R5, R5, R1      # R5 = &A[start]
+FADD R2, R2, R1      # R2 = &B[start]
+MOV R7, {float(BLOCK_SIZE)}       # R7 = BLOCK_SIZE (paso vectorial)
+MOV R0, 0.0          # R0 = acumulador escalar
+"""
+    if vec_iters > 0:
+        code += f"""
+# {vec_iters} iteraciones vectoriales de {BLOCK_SIZE} lanes (V0 empieza en 0.0)
+MOV R3, {float(vec_iters)}
+VLOOP:
+VLOAD V1, [R5]       # V1 = A[i..i+{BLOCK_SIZE - 1}]
+VLOAD V2, [R2]       # V2 = B[i..i+{BLOCK_SIZE - 1}]
+VFMA V0, V1, V2      # V0 += V1 * V2
+FADD R5, R5, R7      # R5 += BLOCK_SIZE
+FADD R2, R2, R7      # R2 += BLOCK_SIZE
+DEC R3               # contador--
+JNZ VLOOP            # repetir si contador != 0
+
+VREDUCE R0, V0       # R0 = suma horizontal de V0
+"""
+    if tail > 0:
+        code += f"""
+# cola escalar: {tail} elementos
+MOV R3, {float(tail)}
+TAIL_LOOP:
+LOAD R4, [R5]        # R4 = A[i]
+LOAD R6, [R2]        # R6 = B[i]
+FMUL R4, R4, R6      # R4 = A[i] * B[i]
+FADD R0, R0, R4      # acumulador += producto
+INC R5               # siguiente A
+INC R2               # siguiente B
+DEC R3               # contador--
+JNZ TAIL_LOOP        # repetir si contador != 0
+"""
+    return code
+
+def generate_worker_pe_vector(pe_id):
+    """Genera la variante vectorizada para un PE trabajador (PE0-PE2)"""
+    code = _vector_partial_product(pe_id, SEGMENT_SIZE_WORKER)
+    code += f"""
+MOV R5, {float(_result_addr(pe_id))}
+STORE R0, [R5]      # Guardar resultado parcial
+
+MOV R7, {float(_flag_addr(pe_id))}
+MOV R6, 1.0         # Flag value
+STORE R6, [R7]      # Señalizar finalización
+
+HALT
+"""
+    return code
+
+def generate_master_pe_vector(pe_id=3):
+    """Genera la variante vectorizada para el PE master"""
+    code = _vector_partial_product(pe_id, SEGMENT_SIZE_MASTER)
+    code += f"""
+MOV R5, {float(_result_addr(pe_id))}
+STORE R0, [R5]      # guardar en RESULTS_ADDR + {pe_id}
+{_master_barrier_and_reduce()}
+HALT
+{_wait_sleep()}"""
+    return code
+
+def _counter_barrier():
+    """Barrera por contador: cada trabajador hace FAA +1 sobre
+    BARRIER_COUNTER_ADDR y el master espera a que llegue a NUM_PES-1
+    sondeando una sola palabra"""
+    return f"""
+# barrera de sincronización (contador atómico)
 
 MOV R1, {float(CFG_BARRIER_CHECK_ADDR)}
 LOAD R7, [R1]  # R7 = barrier_check = - (NUM_PES-1)
+MOV R1, {float(BARRIER_COUNTER_ADDR)}  # R1 = BARRIER_COUNTER_ADDR
 
 WAIT_LOOP:
-MOV R1, {float(FLAGS_ADDR)}
-LOAD R2, [R1]        # R2 = flag[PE0]
+MONITOR [R1]         # armar monitor sobre el bloque del contador
+LOAD R2, [R1]        # R2 = trabajadores que llegaron
+FADD R6, R2, R7      # R6 = contador - (NUM_PES-1)
+JNZ WAIT_SLEEP       # si != 0, dormir hasta que cambie el contador
+"""
 
-MOV R1, {float(FLAGS_ADDR + 1)}
-LOAD R4, [R1]        # R4 = flag[PE1]
+def generate_worker_pe_atomic(pe_id):
+    """Genera la variante con barrera atómica para un PE trabajador"""
+    code = _scalar_partial_product(pe_id)
+    code += f"""
+MOV R5, {float(_result_addr(pe_id))}
+STORE R0, [R5]      # Guardar resultado parcial
 
-MOV R1, {float(FLAGS_ADDR + 2)}
-LOAD R5, [R1]        # R5 = flag[PE2]
+MOV R7, {float(BARRIER_COUNTER_ADDR)}
+MOV R6, 1.0
+FAA R6, R6, [R7]    # contador de barrera += 1 (atómico)
 
-FADD R6, R2, R4      # R6 = flag0 + flag1
-FADD R6, R6, R5      # R6 += flag2
-FADD R6, R6, R7      # R6 = suma_flags - (NUM_PES-1)
+HALT
+"""
+    return code
 
-JNZ WAIT_LOOP        # si != 0, repetir
+def generate_master_pe_atomic(pe_id=3):
+    """Genera la variante con barrera atómica para el PE master"""
+    code = _scalar_partial_product(pe_id)
+    code += f"""
+MOV R5, {float(_result_addr(pe_id))}
+STORE R0, [R5]      # guardar en RESULTS_ADDR + {pe_id}
+{_counter_barrier()}{_reduce()}
+HALT
+{_wait_sleep()}"""
+    return code
 
-# reducción de resultados parciales
+def _spmd_result_offset():
+    """R5 += pe * SYNC_STRIDE (R7 = id del PE, R6 libre)"""
+    if SYNC_STRIDE == 1:
+        return "FADD R5, R5, R7     # R5 = RESULTS_ADDR + pe\n"
+    return f"""MOV R6, {float(SYNC_STRIDE)}
+FMUL R6, R7, R6     # R6 = pe * SYNC_STRIDE
+FADD R5, R5, R6     # R5 = RESULT_ADDR(pe)
+"""
 
-MOV R1, {float(CFG_NUM_PES_ADDR)}
-LOAD R2, [R1]  # R2 = NUM_PES
+def generate_spmd():
+    """Genera un único programa SPMD para todos los PEs: el segmento, la
+    dirección del resultado parcial y el rol (trabajador/master) se
+    calculan en tiempo de ejecución con PEID/NPES"""
+    code = f"""# Programa SPMD: la misma imagen para todos los PEs
+PEID R7              # R7 = id de este PE
 
-MOV R1, {float(RESULTS_ADDR)}  # R1 = dirección actual (empieza en RESULTS_ADDR)
-MOV R0, 0.0          # R0 = acumulador final
+MOV R4, {float(CFG_PE_START_ADDR)}
+FADD R4, R4, R7
+FADD R4, R4, R7      # R4 = CFG_PE(pe, PE_START_INDEX) (2 parámetros por PE)
+LOAD R1, [R4]        # R1 = start_index
+INC R4
+LOAD R3, [R4]        # R3 = segment_size
 
-REDUCE_LOOP:
-LOAD R4, [R1]        # R4 = resultado_parcial[i]
-FADD R0, R0, R4      # acumulador += resultado_parcial[i]
-INC R1               # R1++ (siguiente resultado: compacto, +1 dirección)
-DEC R2               # contador--
-JNZ REDUCE_LOOP      # repetir si contador != 0
+MOV R4, {float(CFG_VECTOR_A_ADDR)}
+LOAD R5, [R4]        # R5 = VECTOR_A_ADDR
+
+MOV R4, {float(CFG_VECTOR_B_ADDR)}
+LOAD R2, [R4]        # R2 = VECTOR_B_ADDR
+ROI                  # inicio de la región de interés (fin de SIM_FASTFWD=roi)
+
+MOV R0, 0.0         # R0 = acumulador (resultado parcial)
+
+LOOP_START:
+FADD R4, R5, R1     # R4 = VECTOR_A_ADDR + i (dirección de A[i])
+LOAD R4, [R4]       # R4 = A[i]
+FADD R6, R2, R1     # R6 = VECTOR_B_ADDR + i
+LOAD R6, [R6]       # R6 = B[i]
+FMUL R4, R4, R6     # R4 = A[i] * B[i]
+FADD R0, R0, R4     # acumulador += producto
+INC R1              # i++
+DEC R3              # contador--
+JNZ LOOP_START      # Repetir si contador != 0
+
+MOV R4, {float(CFG_RESULTS_ADDR)}
+LOAD R5, [R4]
+{_spmd_result_offset()}STORE R0, [R5]      # Guardar resultado parcial
+
+# ¿master? (pe == NUM_PES-1)
+NPES R6
+MOV R5, -1.0
+FMUL R4, R7, R5     # R4 = -pe
+FADD R6, R6, R4     # R6 = NUM_PES - pe
+DEC R6              # zero_flag = (pe == NUM_PES-1)
+JNZ WORKER
+{_counter_barrier()}{_reduce()}
+HALT
+
+WORKER:
+MOV R7, {float(BARRIER_COUNTER_ADDR)}
+MOV R6, 1.0
+FAA R6, R6, [R7]    # contador de barrera += 1 (atómico)
+HALT
+{_wait_sleep()}"""
+    return code
+
+# ============================================================================
+# Optimizador peephole (variante SIM_KERNEL=opt)
+# ============================================================================
 
+_REG = re.compile(r'^R[0-7]$')
+
+def _parse_asm(code):
+    """Separa el código en items: instrucciones, labels y líneas de texto"""
+    items = []
+    for line in code.splitlines():
+        text, _, comment = line.partition('#')
+        text = text.strip()
+        if not text:
+            items.append({'kind': 'text', 'line': line})
+        elif text.endswith(':'):
+            items.append({'kind': 'label', 'name': text[:-1], 'line': line})
+        else:
+            op, _, rest = text.partition(' ')
+            ops = [o.strip() for o in rest.split(',')] if rest.strip() else []
+            items.append({'kind': 'inst', 'op': op, 'ops': ops, 'comment': comment.strip()})
+    return items
+
+def _emit_asm(items):
+    lines = []
+    for it in items:
+        if it['kind'] != 'inst':
+            lines.append(it['line'])
+            continue
+        text = it['op'] + (' ' + ', '.join(it['ops']) if it['ops'] else '')
+        lines.append(f"{text:<20}# {it['comment']}" if it['comment'] else text)
+    return '\n'.join(lines) + '\n'
+
+def _uses_defs(op, ops):
+    """Registros escalares leídos y escritos por una instrucción"""
+    regs = [o for o in ops if _REG.match(o)]
+    uses = {o[1:-1] for o in ops if o.startswith('[') and _REG.match(o[1:-1])}
+    defs = set()
+    if op in ('MOV', 'LOAD', 'LL', 'PEID', 'NPES', 'VREDUCE'):
+        defs = {regs[0]}
+    elif op in ('FADD', 'FMUL'):
+        defs = {regs[0]}
+        uses |= {regs[1], regs[2]}
+    elif op in ('INC', 'DEC'):
+        uses |= {regs[0]}
+        defs = {regs[0]}
+    elif op in ('STORE', 'SC'):
+        uses |= {regs[0]}
+    elif op == 'FAA':
+        defs = {regs[0]}
+        uses |= {regs[1]}
+    elif op == 'CAS':
+        defs = {regs[0]}
+        uses |= {regs[0], regs[1]}
+    return uses, defs
+
+def _fold_addresses(items):
+    """[Rx] -> [addr] cuando Rx tiene una constante conocida (MOV en el
+    mismo bloque básico). Retorna el número de operandos plegados."""
+    folded = 0
+    consts = {}
+    for it in items:
+        if it['kind'] == 'label':
+            consts = {}
+            continue
+        if it['kind'] != 'inst':
+            continue
+        for k, o in enumerate(it['ops']):
+            if o.startswith('[') and o[1:-1] in consts:
+                val = consts[o[1:-1]]
+                if val >= 0 and val == int(val):
+                    it['ops'][k] = f"[{int(val)}]"
+                    folded += 1
+        _, defs = _uses_defs(it['op'], it['ops'])
+        for d in defs:
+            consts.pop(d, None)
+        if it['op'] == 'MOV':
+            consts[it['ops'][0]] = float(it['ops'][1])
+    return folded
+
+def _remove_dead(items):
+    """Elimina MOV/LOAD cuyo registro destino no se lee en ningún camino
+    (liveness sobre el CFG: fall-through + destino de JNZ, HALT termina).
+    Ni MOV ni LOAD modifican el zero_flag, así que los saltos no cambian."""
+    insts = [it for it in items if it['kind'] == 'inst']
+    label_at = {}
+    pending = []
+    idx = 0
+    for it in items:
+        if it['kind'] == 'label':
+            pending.append(it['name'])
+        elif it['kind'] == 'inst':
+            for name in pending:
+                label_at[name] = idx
+            pending = []
+            idx += 1
+
+    n = len(insts)
+    succ = []
+    for i, it in enumerate(insts):
+        s_i = [] if it['op'] == 'HALT' or i + 1 >= n else [i + 1]
+        if it['op'] == 'JNZ' and it['ops'][0] in label_at:
+            s_i.append(label_at[it['ops'][0]])
+        succ.append(s_i)
+
+    ud = [_uses_defs(it['op'], it['ops']) for it in insts]
+    live_in = [set() for _ in range(n)]
+    live_out = [set() for _ in range(n)]
+    changed = True
+    while changed:
+        changed = False
+        for i in reversed(range(n)):
+            out = set().union(*(live_in[j] for j in succ[i])) if succ[i] else set()
+            inn = ud[i][0] | (out - ud[i][1])
+            if out != live_out[i] or inn != live_in[i]:
+                live_out[i], live_in[i] = out, inn
+                changed = True
+
+    dead = {id(it) for i, it in enumerate(insts)
+            if it['op'] in ('MOV', 'LOAD') and not (ud[i][1] & live_out[i])}
+    items[:] = [it for it in items if id(it) not in dead]
+    return len(dead)
+
+def peephole(code):
+    """Pasada peephole: direcciones constantes a modo directo y eliminación
+    de MOV/LOAD muertos, hasta punto fijo. Retorna (código, plegados, eliminados)."""
+    items = _parse_asm(code)
+    folded = removed = 0
+    while True:
+        f = _fold_addresses(items)
+        r = _remove_dead(items)
+        folded += f
+        removed += r
+        if f == 0 and r == 0:
+            break
+    return _emit_asm(items), folded, removed
+
+def _unrolled_partial_product(pe_id, segment_size):
+    """Producto punto parcial con el bucle desenrollado a BLOCK_SIZE
+    elementos por iteración. El número de iteraciones se especializa en
+    generación (config.h es la fuente tanto del .asm como de SHARED_CONFIG)."""
+    cfg_start_idx_addr = CFG_PE_START_ADDR + pe_id * 2
+    trips, rest = divmod(segment_size, BLOCK_SIZE)
+    body = """FADD R4, R5, R1     # R4 = VECTOR_A_ADDR + i
+LOAD R4, [R4]       # R4 = A[i]
+FADD R6, R2, R1     # R6 = VECTOR_B_ADDR + i
+LOAD R6, [R6]       # R6 = B[i]
+FMUL R4, R4, R6     # R4 = A[i] * B[i]
+FADD R0, R0, R4     # acumulador += producto
+INC R1              # i++
+"""
+    code = f"""# Cargar VECTOR_A_ADDR (addr 0)
+MOV R4, {float(CFG_VECTOR_A_ADDR)}
+LOAD R5, [R4]        # R5 = VECTOR_A_ADDR
+
+MOV R4, {float(CFG_VECTOR_B_ADDR)}
+LOAD R2, [R4]        # R2 = VECTOR_B_ADDR
+
+MOV R4, {float(cfg_start_idx_addr)}
+LOAD R1, [R4]        # R1 = start_index
+ROI                  # inicio de la región de interés (fin de SIM_FASTFWD=roi)
+
+MOV R0, 0.0         # R0 = acumulador (resultado parcial)
+"""
+    if trips > 0:
+        code += f"""MOV R3, {float(trips)}         # iteraciones de {BLOCK_SIZE} elementos
+
+LOOP_START:
+{body * BLOCK_SIZE}DEC R3              # contador--
+JNZ LOOP_START      # Repetir si contador != 0
+"""
+    if rest > 0:
+        code += f"\n# resto: {rest} elemento(s)\n" + body * rest
+    return code
+
+def _unrolled_reduce():
+    """Reducción desenrollada: NUM_PES resultados parciales sin bucle"""
+    code = "\n# reducción de resultados parciales (desenrollada)\n\nMOV R0, 0.0          # R0 = acumulador final\n"
+    for i in range(NUM_PES):
+        code += f"""MOV R1, {float(_result_addr(i))}
+LOAD R4, [R1]        # R4 = resultado_parcial[{i}]
+FADD R0, R0, R4      # acumulador += resultado_parcial[{i}]
+"""
+    code += f"""
 MOV R2, {float(FINAL_RESULT_ADDR)}
 STORE R0, [R2]       # guardar producto punto final
+"""
+    return code
 
+def generate_opt_pe(pe_id):
+    """Variante optimizada del kernel escalar (misma barrera por flags):
+    desenrollado opcional (ASM_UNROLL) y pasada peephole"""
+    is_master = pe_id == NUM_PES - 1
+    if ASM_UNROLL:
+        segment = SEGMENT_SIZE_MASTER if is_master else SEGMENT_SIZE_WORKER
+        code = _unrolled_partial_product(pe_id, segment)
+    else:
+        code = _scalar_partial_product(pe_id)
+
+    if is_master:
+        code += f"""
+MOV R5, {float(_result_addr(pe_id))}
+STORE R0, [R5]      # guardar en RESULTS_ADDR + {pe_id}
+{_flag_barrier()}{_unrolled_reduce() if ASM_UNROLL else _reduce()}
 HALT
+{_wait_sleep()}"""
+    else:
+        code += f"""
+MOV R5, {float(_result_addr(pe_id))}
+STORE R0, [R5]      # Guardar resultado parcial
+
+MOV R7, {float(_flag_addr(pe_id))}
+MOV R6, 1.0         # Flag value
+STORE R6, [R7]      # Señalizar finalización
+
+HALT
+"""
+    return peephole(code)
+
+# ============================================================================
+# Workloads (SIM_WORKLOAD): un programa SPMD por carga, asm/wl_<nombre>.asm
+# ============================================================================
+# Direcciones y tamaños salen de config.h (WORKLOAD_VARS); el reparto de
+# trabajo lo escribe el C en CFG_PE(pe, 0..1) y cada programa lo lee con PEID.
+# La ISA no tiene comparaciones ni saltos incondicionales: las condiciones son
+# restas que dejan zero_flag para JNZ.
+
+def _wl(name):
+    return config[name]
+
+def _goto(label, tmp="R4"):
+    """Salto incondicional (JNZ tras un resultado distinto de 0; pisa tmp)"""
+    return f"""MOV {tmp}, 1.0
+FADD {tmp}, {tmp}, {tmp}
+JNZ {label}
+"""
+
+def _pe_share(start_reg, count_reg):
+    """Parte del trabajo de este PE: CFG_PE(pe, 0) y CFG_PE(pe, 1) (pisa R4, R5)"""
+    return f"""PEID R4
+MOV R5, {float(CFG_PE_START_ADDR)}
+FADD R5, R5, R4
+FADD R5, R5, R4      # R5 = CFG_PE(pe, 0)
+LOAD {start_reg}, [R5]
+INC R5
+LOAD {count_reg}, [R5]
+"""
+
+def _skip_if_zero(reg, work_label, skip_label):
+    """Si reg == 0 salta a skip_label; si no, sigue en work_label"""
+    return f"""MOV R4, 0.0
+FADD R4, {reg}, R4
+JNZ {work_label}
+{_goto(skip_label)}{work_label}:
+"""
+
+def _counter_arrive_wait(counter, label, tails):
+    """Barrera por contador que no se reinicia: FAA +1 y espera a que valga
+    -R7 (R7 = -(NUM_PES * pasos hechos)). Cada contador se reutiliza solo
+    tras pasar la barrera del otro, así que nadie lo incrementa mientras
+    otro PE aún espera el valor anterior."""
+    tails.append(f"""
+{label}_SLEEP:
+MWAIT                # dormir hasta que otro PE incremente el contador
+JNZ {label}          # zero_flag sigue a 0: volver a comprobar
+""")
+    return f"""MOV R4, {float(counter)}
+MOV R5, 1.0
+FAA R5, R5, [R4]     # llegada a la barrera
+{label}:
+MONITOR [R4]
+LOAD R5, [R4]
+FADD R5, R5, R7      # R5 = llegadas - esperadas
+JNZ {label}_SLEEP
+"""
+
+def generate_wl_matmul():
+    """C = A * B: cada PE calcula sus filas de C; B está traspuesta en
+    memoria (BT), así el bucle interno avanza de uno en uno en A y en BT"""
+    n = _wl('MATMUL_N')
+    a, bt, c = _wl('MATMUL_A_ADDR'), _wl('MATMUL_BT_ADDR'), _wl('MATMUL_C_ADDR')
+    return f"""# matmul: C = A * B ({n}x{n}), filas de C repartidas entre PEs (SPMD)
+{_pe_share('R1', 'R7')}# R1 = fila * N (desplazamiento de la primera fila), R7 = filas
+ROI                  # inicio de la región de interés (fin de SIM_FASTFWD=roi)
+MOV R4, {float(c)}
+FADD R6, R1, R4      # R6 = &C[fila][0]
+MOV R4, {float(a)}
+FADD R1, R1, R4      # R1 = &A[fila][0]
+{_skip_if_zero('R7', 'ROW_LOOP', 'DONE')}MOV R2, {float(bt)}   # R2 = &BT[0][0] (columna 0 de B)
+
+COL_LOOP:
+MOV R0, 0.0          # R0 = C[fila][col]
+MOV R3, {float(n)}
+K_LOOP:
+LOAD R4, [R1]        # A[fila][k]
+LOAD R5, [R2]        # B[k][col] = BT[col][k]
+FMUL R4, R4, R5
+FADD R0, R0, R4
+INC R1
+INC R2
+DEC R3
+JNZ K_LOOP
+
+STORE R0, [R6]
+INC R6
+MOV R4, {float(-n)}
+FADD R1, R1, R4      # volver al inicio de la fila de A
+MOV R4, {float(-(bt + n * n))}
+FADD R4, R2, R4      # 0 tras la última columna de B
+JNZ COL_LOOP
+
+MOV R4, {float(n)}
+FADD R1, R1, R4      # siguiente fila de A
+DEC R7
+JNZ ROW_LOOP
+
+DONE:
+HALT
+"""
+
+def generate_wl_histogram():
+    """Histograma: cada PE recorre su tramo de la entrada y hace FAA +1 sobre
+    el bin compartido"""
+    return f"""# histogram: {_wl('HIST_SIZE')} entradas, {_wl('HIST_BINS')} bins compartidos (SPMD)
+{_pe_share('R1', 'R3')}ROI                  # inicio de la región de interés (fin de SIM_FASTFWD=roi)
+MOV R4, {float(_wl('HIST_INPUT_ADDR'))}
+FADD R1, R1, R4      # R1 = &X[inicio]
+MOV R6, {float(_wl('HIST_BINS_ADDR'))}   # R6 = &bins[0]
+MOV R2, 1.0
+{_skip_if_zero('R3', 'HIST_LOOP', 'DONE')}LOAD R4, [R1]        # R4 = X[i] (número de bin)
+FADD R4, R4, R6      # R4 = &bins[X[i]]
+FAA R0, R2, [R4]     # bins[X[i]] += 1 (atómico)
+INC R1
+DEC R3
+JNZ HIST_LOOP
+
+DONE:
+HALT
+"""
+
+def _stencil_step(src, dst, counter, tag, tails):
+    """Un paso de Jacobi src -> dst sobre las filas (2D) o celdas (1D) de
+    este PE, seguido de la barrera"""
+    rows, cols = _wl('STENCIL_ROWS'), _wl('STENCIL_COLS')
+    delta = dst - src
+    neighbours = ""
+    if rows > 1:
+        neighbours = f"""MOV R4, {float(-cols)}
+FADD R4, R1, R4
+LOAD R5, [R4]        # norte
+MOV R4, {float(cols)}
+FADD R4, R1, R4
+LOAD R4, [R4]        # sur
+FADD R5, R5, R4
+MOV R4, -1.0
+FADD R4, R1, R4
+LOAD R4, [R4]        # oeste
+FADD R5, R5, R4
+"""
+        weight = 0.125
+    else:
+        neighbours = f"""MOV R4, -1.0
+FADD R4, R1, R4
+LOAD R5, [R4]        # oeste
+"""
+        weight = 0.25
+    cell = f"""LOAD R0, [R1]
+MOV R4, 0.5
+FMUL R0, R0, R4      # R0 = centro / 2
+{neighbours}MOV R4, 1.0
+FADD R4, R1, R4
+LOAD R4, [R4]        # este
+FADD R5, R5, R4
+MOV R4, {weight}
+FMUL R5, R5, R4
+FADD R0, R0, R5      # R0 = centro / 2 + vecinos * {weight}
+MOV R4, {float(delta)}
+FADD R4, R1, R4
+STORE R0, [R4]       # dst[celda]
+"""
+    if rows > 1:
+        body = f"""ROW_{tag}:
+MOV R3, {float(cols - 2)}
+CELL_{tag}:
+{cell}INC R1
+DEC R3
+JNZ CELL_{tag}
+INC R1
+INC R1               # saltar el borde derecho y el izquierdo de la fila siguiente
+DEC R6
+JNZ ROW_{tag}
+"""
+    else:
+        body = f"""ROW_{tag}:
+{cell}INC R1
+DEC R6
+JNZ ROW_{tag}
 """
+    return f"""
+# paso {tag}: 0x{src:X} -> 0x{dst:X}
+{_pe_share('R1', 'R6')}MOV R4, {float(src)}
+FADD R1, R1, R4      # R1 = &src[primera celda]
+{_skip_if_zero('R6', f'STEP_{tag}', f'DONE_{tag}')}{body}
+DONE_{tag}:
+{_counter_arrive_wait(counter, f'WAIT_{tag}', tails)}"""
+
+def generate_wl_stencil():
+    """Jacobi con bordes fijos: 2D (5 puntos) o 1D (3 puntos) si ROWS == 1.
+    Los pasos van de dos en dos (GRID0 -> GRID1 -> GRID0) con un contador
+    de barrera por paso del par"""
+    rows, cols, steps = _wl('STENCIL_ROWS'), _wl('STENCIL_COLS'), _wl('STENCIL_STEPS')
+    g0, g1 = _wl('STENCIL_GRID0_ADDR'), _wl('STENCIL_GRID1_ADDR')
+    b0, b1 = _wl('STENCIL_BARRIER0_ADDR'), _wl('STENCIL_BARRIER1_ADDR')
+    pairs = steps // 2
+    tails = []
+    kind = f"2D {rows}x{cols}" if rows > 1 else f"1D {cols}"
+    code = f"""# stencil: Jacobi {kind}, {steps} pasos, intercambio de halo por barrera (SPMD)
+MOV R7, 0.0          # R7 = -(llegadas esperadas en la barrera)
+ROI                  # inicio de la región de interés (fin de SIM_FASTFWD=roi)
+"""
+    if pairs:
+        code += f"""
+STEP_PAIR:
+MOV R4, {float(-NUM_PES)}
+FADD R7, R7, R4
+{_stencil_step(g0, g1, b0, 'A', tails)}{_stencil_step(g1, g0, b1, 'B', tails)}
+MOV R4, {float(NUM_PES * pairs)}
+FADD R4, R7, R4
+JNZ STEP_PAIR
+"""
+    if steps % 2:
+        code += f"""
+MOV R4, {float(-NUM_PES)}
+FADD R7, R7, R4
+{_stencil_step(g0, g1, b0, 'C', tails)}"""
+    return code + "\nHALT\n" + "".join(tails)
+
+def generate_wl_prodcons():
+    """Cola productor-consumidor por parejas (PE 2k -> PE 2k+1): el productor
+    espera hueco sobre head y publica tail; el consumidor espera sobre tail,
+    copia el elemento a su salida y publica head"""
+    slots, items = _wl('QUEUE_SLOTS'), _wl('QUEUE_ITEMS')
+    head, tail, out = _wl('QUEUE_HEAD_OFFSET'), _wl('QUEUE_TAIL_OFFSET'), _wl('QUEUE_OUT_OFFSET')
+    return f"""# prodcons: cola de {slots} slots, {items} elementos por pareja de PEs (SPMD)
+{_pe_share('R7', 'R6')}# R7 = base de la cola del par, R6 = rol (1 productor, 2 consumidor, 0 sin pareja)
+ROI                  # inicio de la región de interés (fin de SIM_FASTFWD=roi)
+{_skip_if_zero('R6', 'HAS_ROLE', 'DONE')}MOV R1, 0.0          # R1 = elementos producidos / consumidos
+MOV R2, 0.0
+FADD R2, R2, R7      # R2 = slot actual
+MOV R3, {float(slots)}   # R3 = slots hasta dar la vuelta
+DEC R6
+JNZ CONSUMER
+MOV R6, {float(items)}
+
+P_LOOP:
+MOV R4, {float(head)}
+FADD R4, R7, R4      # R4 = &head
+P_WAIT:
+MONITOR [R4]
+LOAD R5, [R4]        # R5 = consumidos
+MOV R0, {float(slots)}
+FADD R5, R5, R0
+MOV R0, -1.0
+FMUL R0, R1, R0
+FADD R5, R5, R0      # R5 = huecos = consumidos + SLOTS - producidos
+JNZ P_PUT
+MWAIT                # cola llena: dormir hasta que el consumidor publique head
+{_goto('P_WAIT', 'R0')}P_PUT:
+INC R1
+FADD R0, R1, R7      # R0 = elemento: base del par + número de orden (1..ITEMS)
+STORE R0, [R2]
+MOV R5, {float(tail)}
+FADD R5, R7, R5
+STORE R1, [R5]       # publicar tail
+INC R2
+DEC R3
+JNZ P_NEXT
+MOV R2, 0.0
+FADD R2, R2, R7      # volver al primer slot
+MOV R3, {float(slots)}
+P_NEXT:
+DEC R6
+JNZ P_LOOP
+HALT
+
+CONSUMER:
+MOV R6, {float(items)}
+C_LOOP:
+MOV R4, {float(tail)}
+FADD R4, R7, R4      # R4 = &tail
+C_WAIT:
+MONITOR [R4]
+LOAD R5, [R4]        # R5 = producidos
+MOV R0, -1.0
+FMUL R0, R1, R0
+FADD R5, R5, R0      # R5 = disponibles = producidos - consumidos
+JNZ C_GET
+MWAIT                # cola vacía: dormir hasta que el productor publique tail
+{_goto('C_WAIT', 'R0')}C_GET:
+LOAD R0, [R2]        # R0 = elemento
+MOV R5, {float(out)}
+FADD R5, R7, R5
+FADD R5, R5, R1
+STORE R0, [R5]       # salida[consumidos] = elemento
+INC R1
+MOV R5, {float(head)}
+FADD R5, R7, R5
+STORE R1, [R5]       # publicar head
+INC R2
+DEC R3
+JNZ C_NEXT
+MOV R2, 0.0
+FADD R2, R2, R7      # volver al primer slot
+MOV R3, {float(slots)}
+C_NEXT:
+DEC R6
+JNZ C_LOOP
+
+DONE:
+HALT
+"""
+
+def generate_wl_lookup():
+    """Tabla de consulta de lectura mayoritaria: cada pasada suma
+    tabla[clave] sobre las claves del PE; entre pasadas PE0 incrementa una
+    entrada, entre dos barreras"""
+    rounds = _wl('LOOKUP_ROUNDS')
+    table, keys = _wl('LOOKUP_TABLE_ADDR'), _wl('LOOKUP_KEYS_ADDR')
+    tails = []
+    stride = "" if SYNC_STRIDE == 1 else f"""MOV R5, {float(SYNC_STRIDE)}
+FMUL R4, R4, R5      # R4 = pe * SYNC_STRIDE
+"""
+    code = f"""# lookup: {_wl('LOOKUP_ENTRIES')} entradas, {_wl('LOOKUP_QUERIES')} consultas, {rounds} pasadas (SPMD)
+MOV R0, 0.0          # R0 = suma de este PE
+MOV R7, 0.0          # R7 = -(llegadas esperadas en la barrera)
+MOV R2, {float(table)}   # R2 = entrada que PE0 actualiza tras esta pasada
+ROI                  # inicio de la región de interés (fin de SIM_FASTFWD=roi)
+
+ROUND:
+{_pe_share('R1', 'R3')}MOV R4, {float(keys)}
+FADD R1, R1, R4      # R1 = &claves[inicio]
+{_skip_if_zero('R3', 'LOOKUP_LOOP', 'ROUND_DONE')}LOAD R4, [R1]        # clave
+MOV R5, {float(table)}
+FADD R4, R4, R5
+LOAD R4, [R4]        # tabla[clave]
+FADD R0, R0, R4
+INC R1
+DEC R3
+JNZ LOOKUP_LOOP
+
+ROUND_DONE:
+MOV R4, {float(-NUM_PES)}
+FADD R7, R7, R4
+MOV R4, {float(NUM_PES * rounds)}
+FADD R4, R7, R4      # 0 tras la última pasada
+JNZ UPDATE
+{_goto('FINISH')}
+UPDATE:
+{_counter_arrive_wait(_wl('LOOKUP_BARRIER0_ADDR'), 'WAIT_READ', tails)}PEID R4
+MOV R5, 0.0
+FADD R4, R4, R5
+JNZ UPDATED          # solo PE0 escribe
+LOAD R5, [R2]
+MOV R4, 1.0
+FADD R5, R5, R4
+STORE R5, [R2]       # tabla[pasada] += 1
+UPDATED:
+INC R2
+{_counter_arrive_wait(_wl('LOOKUP_BARRIER1_ADDR'), 'WAIT_WRITE', tails)}{_goto('ROUND')}
+FINISH:
+PEID R4
+{stride}MOV R5, {float(RESULTS_ADDR)}
+FADD R5, R5, R4      # R5 = RESULT_ADDR(pe)
+STORE R0, [R5]
+HALT
+""" + "".join(tails)
     return code
 
+WORKLOAD_GENERATORS = {
+    "matmul": generate_wl_matmul,
+    "histogram": generate_wl_histogram,
+    "stencil": generate_wl_stencil,
+    "prodcons": generate_wl_prodcons,
+    "lookup": generate_wl_lookup,
+}
+
 def main():
     """Genera todos los archivos .asm"""
     
+    os.makedirs(ASM_DIR, exist_ok=True)
     print(f"Generando archivos assembly para:")
     print(f"  VECTOR_SIZE = {VECTOR_SIZE}")
     print(f"  NUM_PES = {NUM_PES}")
     print(f"  SEGMENT_SIZE_WORKER = {SEGMENT_SIZE_WORKER}")
     print(f"  SEGMENT_SIZE_MASTER = {SEGMENT_SIZE_MASTER}")
     print(f"  RESIDUE = {RESIDUE}")
+    print(f"  BLOCK_SIZE = {BLOCK_SIZE}")
     print()
     
     # Generar PEs trabajadores (PE0 - PE2)
     for pe_id in range(NUM_PES - 1):
-        filename = f"asm/dotprod_pe{pe_id}.asm"
+        filename = os.path.join(ASM_DIR, f"dotprod_pe{pe_id}.asm")
         code = generate_worker_pe(pe_id)
         with open(filename, 'w') as f:
             f.write(code)
         print(f" Generado: {filename}")
     
     # Generar PE master (PE3)
-    filename = f"asm/dotprod_pe{NUM_PES - 1}.asm"
+    filename = os.path.join(ASM_DIR, f"dotprod_pe{NUM_PES - 1}.asm")
     code = generate_master_pe(NUM_PES - 1)
     with open(filename, 'w') as f:
         f.write(code)
     print(f" Generado: {filename}")
     
-    print(f"\n {NUM_PES} archivos generados correctamente")
+    # Variante vectorizada (VLOAD/VFMA/VREDUCE)
+    for pe_id in range(NUM_PES):
+        filename = os.path.join(ASM_DIR, f"dotprod_vec_pe{pe_id}.asm")
+        if pe_id < NUM_PES - 1:
+            code = generate_worker_pe_vector(pe_id)
+        else:
+            code = generate_master_pe_vector(pe_id)
+        with open(filename, 'w') as f:
+            f.write(code)
+        print(f" Generado: {filename}")
+    
+    # Variante con barrera por contador atómico (FAA)
+    for pe_id in range(NUM_PES):
+        filename = os.path.join(ASM_DIR, f"dotprod_atomic_pe{pe_id}.asm")
+        if pe_id < NUM_PES - 1:
+            code = generate_worker_pe_atomic(pe_id)
+        else:
+            code = generate_master_pe_atomic(pe_id)
+        with open(filename, 'w') as f:
+            f.write(code)
+        print(f" Generado: {filename}")
+    
+    # Variante optimizada (peephole + desenrollado opcional)
+    for pe_id in range(NUM_PES):
+        filename = os.path.join(ASM_DIR, f"dotprod_opt_pe{pe_id}.asm")
+        code, folded, removed = generate_opt_pe(pe_id)
+        with open(filename, 'w') as f:
+            f.write(code)
+        print(f" Generado: {filename} (peephole: {folded} direcciones directas, {removed} instrucciones muertas)")
+    
+    # Programa SPMD único (todos los PEs)
+    filename = os.path.join(ASM_DIR, "dotprod_spmd.asm")
+    with open(filename, 'w') as f:
+        f.write(generate_spmd())
+    print(f" Generado: {filename}")
+    
+    # Cargas de trabajo SPMD (SIM_WORKLOAD)
+    if config:
+        for name, generate in WORKLOAD_GENERATORS.items():
+            filename = os.path.join(ASM_DIR, f"wl_{name}.asm")
+            with open(filename, 'w') as f:
+                f.write(generate())
+            print(f" Generado: {filename}")
+    
+    print(f"\n {4 * NUM_PES + 1 + (len(WORKLOAD_GENERATORS) if config else 0)} archivos generados correctamente")
 
 if __name__ == "__main__":
     main()
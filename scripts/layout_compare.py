@@ -0,0 +1,70 @@
+#!/usr/bin/env python3
+"""
+Compara el layout empaquetado con el layout con padding (LAYOUT_PADDED)
+Compila las dos variantes con scripts/sweep.py (obj/sweep/<variante>/), ejecuta
+cada kernel en ambas y reporta la reducción de transacciones de bus e
+invalidaciones del layout con padding respecto al empaquetado. Un valor
+negativo es un aumento: con vectores pequeños el master lee NUM_PES bloques en
+lugar de uno y los fallos extra pueden superar al false sharing eliminado.
+
+Uso:
+    python3 scripts/layout_compare.py
+    python3 scripts/layout_compare.py --align-segments --kernels scalar,atomic
+"""
+
+import argparse
+import os
+import sys
+from concurrent.futures import ThreadPoolExecutor
+
+import sweep
+
+COLUMNS = [("bus_total", "bus_txns"), ("bus_invalidations", "invalidations"),
+           ("false_sharing_invalidations", "false_sharing_invs")]
+
+
+def _reduction(packed, padded):
+    if not packed:
+        return "-"
+    return f"{100.0 * (packed - padded) / packed:+.1f}%"
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Layout empaquetado vs con padding")
+    parser.add_argument("--kernels", default="scalar,vector,atomic,opt,spmd",
+                        help="valores de SIM_KERNEL separados por comas")
+    parser.add_argument("--align-segments", action="store_true",
+                        help="la variante con padding alinea también los segmentos (LAYOUT_ALIGN_SEGMENTS=1)")
+    parser.add_argument("--jobs", type=int, default=os.cpu_count() or 1)
+    args = parser.parse_args()
+
+    os.chdir(sweep.ROOT)
+    packed = {"LAYOUT_PADDED": "0", "LAYOUT_ALIGN_SEGMENTS": "0"}
+    padded = {"LAYOUT_PADDED": "1", "LAYOUT_ALIGN_SEGMENTS": "1" if args.align_segments else "0"}
+    with ThreadPoolExecutor(max_workers=args.jobs) as pool:
+        builds = list(pool.map(sweep.build_variant, [packed, padded]))
+    for (vdir, error) in builds:
+        if error:
+            sys.exit(f"{vdir}: {' '.join(error)}")
+
+    kernels = args.kernels.split(",")
+    points = [(vdir, k) for k in kernels for vdir, _ in builds]
+    with ThreadPoolExecutor(max_workers=args.jobs) as pool:
+        rows = list(pool.map(lambda p: sweep.run_point(p[0], {"SIM_KERNEL": p[1]}, 600), points))
+
+    print(f"{'kernel':<8} {'metric':<20} {'packed':>8} {'padded':>8} {'reduction':>10}")
+    failed = 0
+    for i, kernel in enumerate(kernels):
+        base, pad = rows[2 * i], rows[2 * i + 1]
+        for row in (base, pad):
+            failed += row["status"] != "CORRECT"
+        for column, label in COLUMNS:
+            a, b = base.get(column, 0), pad.get(column, 0)
+            print(f"{kernel:<8} {label:<20} {a:>8} {b:>8} {_reduction(a, b):>10}")
+        if base["status"] != "CORRECT" or pad["status"] != "CORRECT":
+            print(f"{kernel:<8} status: packed={base['status']} padded={pad['status']}")
+    sys.exit(1 if failed else 0)
+
+
+if __name__ == "__main__":
+    main()
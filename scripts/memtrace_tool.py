@@ -0,0 +1,158 @@
+#!/usr/bin/env python3
+"""
+Herramienta de trazas de memoria para el modo trace-driven (SIM_MEMTRACE=<dir>)
+Cada PE reproduce <dir>/pe<N>.mtr (formato en src/pe/memtrace.h).
+
+Uso:
+    # Texto -> binario. Una referencia por línea: "R|W <addr> [gap]", '#' comenta
+    python3 scripts/memtrace_tool.py convert pe0.txt traces/pe0.mtr
+
+    # Patrones sintéticos para NUM_PES PEs
+    python3 scripts/memtrace_tool.py synth traces --pattern stream --accesses 100000
+    python3 scripts/memtrace_tool.py synth traces --pattern falseshare
+
+    # Primeros registros de una traza
+    python3 scripts/memtrace_tool.py dump traces/pe0.mtr --limit 20
+
+Patrones:
+    stream      cada PE recorre su propio segmento de memoria (MEM_SIZE / NUM_PES palabras),
+                leyendo cada palabra y escribiendo la última de cada bloque
+    pingpong    todos los PEs leen y escriben la misma palabra (compartición real)
+    falseshare  el PE i lee y escribe la palabra i del mismo bloque (compartición falsa)
+"""
+
+import argparse
+import os
+import re
+import struct
+import sys
+
+HEADER = struct.Struct("<8sIIQ")
+RECORD = struct.Struct("<IBBH")
+MAGIC = b"MPMTRC"
+VERSION = 1
+OPS = {"R": 0, "W": 1}
+CONFIG_H = "src/include/config.h"
+
+
+def _config_int(name, default):
+    """Lee un #define numérico simple de config.h."""
+    try:
+        with open(CONFIG_H) as f:
+            match = re.search(rf"#define\s+{name}\s+(\d+)", f.read())
+        return int(match.group(1)) if match else default
+    except FileNotFoundError:
+        return default
+
+
+def write_trace(path, records):
+    """records: iterable de (op, addr, gap). Escribe la cabecera al final con el total."""
+    os.makedirs(os.path.dirname(path) or ".", exist_ok=True)
+    count = 0
+    with open(path, "wb") as f:
+        f.write(HEADER.pack(MAGIC, VERSION, RECORD.size, 0))
+        chunk = []
+        for op, addr, gap in records:
+            chunk.append(RECORD.pack(addr, op, 0, min(gap, 0xFFFF)))
+            count += 1
+            if len(chunk) == 65536:
+                f.write(b"".join(chunk))
+                chunk = []
+        f.write(b"".join(chunk))
+        f.seek(0)
+        f.write(HEADER.pack(MAGIC, VERSION, RECORD.size, count))
+    return count
+
+
+def _parse_text(path):
+    with open(path) as f:
+        for lineno, line in enumerate(f, 1):
+            line = line.split("#", 1)[0].strip()
+            if not line:
+                continue
+            fields = line.replace(",", " ").split()
+            if fields[0].upper() not in OPS or len(fields) not in (2, 3):
+                sys.exit(f"{path}:{lineno}: se esperaba 'R|W <addr> [gap]'")
+            gap = int(fields[2], 0) if len(fields) == 3 else 0
+            yield OPS[fields[0].upper()], int(fields[1], 0), gap
+
+
+def _pattern(name, pe, num_pes, accesses, block_size, base, gap, mem_size):
+    if name == "stream":
+        # Segmento propio por PE; si no alcanza, se recorre de nuevo desde el principio
+        segment = (mem_size - base) // num_pes
+        segment -= segment % block_size
+        start = base + pe * segment
+        for i in range(accesses):
+            addr = start + i % segment
+            yield OPS["R"], addr, gap
+            if i % block_size == block_size - 1:
+                yield OPS["W"], addr, gap
+    elif name == "pingpong":
+        for _ in range(accesses):
+            yield OPS["R"], base, gap
+            yield OPS["W"], base, gap
+    elif name == "falseshare":
+        for _ in range(accesses):
+            yield OPS["R"], base + pe % block_size, gap
+            yield OPS["W"], base + pe % block_size, gap
+
+
+def cmd_convert(args):
+    count = write_trace(args.output, _parse_text(args.input))
+    print(f" {args.output}: {count} accesos")
+
+
+def cmd_synth(args):
+    num_pes = args.pes or _config_int("NUM_PES", 4)
+    block_size = _config_int("BLOCK_SIZE", 4)
+    mem_size = _config_int("MEM_SIZE", 512)
+    if args.base + num_pes * block_size > mem_size:
+        sys.exit(f"--base {args.base} deja menos de un bloque por PE en MEM_SIZE={mem_size}")
+    for pe in range(num_pes):
+        path = os.path.join(args.dir, f"pe{pe}.mtr")
+        count = write_trace(path, _pattern(args.pattern, pe, num_pes, args.accesses,
+                                           block_size, args.base, args.gap, mem_size))
+        print(f" {path}: {count} accesos ({args.pattern})")
+
+
+def cmd_dump(args):
+    with open(args.trace, "rb") as f:
+        magic, version, record_size, count = HEADER.unpack(f.read(HEADER.size))
+        if magic.rstrip(b"\0") != MAGIC or version != VERSION or record_size != RECORD.size:
+            sys.exit(f"{args.trace}: no es una traza de memoria válida")
+        print(f"{args.trace}: {count} accesos")
+        for i in range(min(count, args.limit) if args.limit else count):
+            addr, op, _, gap = RECORD.unpack(f.read(RECORD.size))
+            print(f"  {i:>8}  {'RW'[op]} {addr:#06x}  gap={gap}")
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Trazas de memoria para SIM_MEMTRACE")
+    sub = parser.add_subparsers(dest="cmd", required=True)
+
+    p = sub.add_parser("convert", help="texto (R|W addr [gap]) a binario")
+    p.add_argument("input")
+    p.add_argument("output")
+    p.set_defaults(func=cmd_convert)
+
+    p = sub.add_parser("synth", help="genera <dir>/pe<N>.mtr con un patrón sintético")
+    p.add_argument("dir")
+    p.add_argument("--pattern", choices=["stream", "pingpong", "falseshare"], default="stream")
+    p.add_argument("--accesses", type=int, default=64, help="referencias base por PE")
+    p.add_argument("--pes", type=int, default=0, help="número de PEs (por defecto NUM_PES)")
+    p.add_argument("--base", type=int, default=0, help="primera dirección usada")
+    p.add_argument("--gap", type=int, default=0, help="instrucciones sin memoria entre accesos")
+    p.set_defaults(func=cmd_synth)
+
+    p = sub.add_parser("dump", help="imprime los registros de una traza")
+    p.add_argument("trace")
+    p.add_argument("--limit", type=int, default=20)
+    p.set_defaults(func=cmd_dump)
+
+    args = parser.parse_args()
+    args.func(args)
+
+
+if __name__ == "__main__":
+    main()
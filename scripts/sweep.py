@@ -0,0 +1,199 @@
+#!/usr/bin/env python3
+"""
+Barrido del espacio de diseño del simulador
+Compila una variante del binario por cada combinación de parámetros de config.h
+(SIM_DEFS) y ejecuta todos los puntos del barrido en paralelo, un proceso por
+punto, usando los núcleos del host. Cada proceso tiene su propia Memory, Bus y
+Caches, así que los puntos no comparten estado.
+
+Uso:
+    # 2 x 3 variantes compiladas, x 2 kernels = 12 ejecuciones
+    python3 scripts/sweep.py --grid SETS=4,8 --grid WAYS=1,2,4 --env SIM_KERNEL=scalar,vector
+
+    # Número de PEs y política del planificador
+    python3 scripts/sweep.py --grid NUM_PES=2,4,8 --grid MEM_SIZE=1024 --env SIM_SCHED=quantum,yield --jobs 4
+
+    # Repeticiones por punto (para promediar el tiempo de host)
+    python3 scripts/sweep.py --grid BLOCK_SIZE=4,8 --repeat 3
+
+Ejes:
+    --grid NOMBRE=v1,v2,...   #define de config.h (compilación, vía make SIM_DEFS)
+    --env  NOMBRE=v1,v2,...   variable de entorno en tiempo de ejecución
+                              (SIM_KERNEL, SIM_SCHED, SIM_QUANTUM, SIM_ICACHE, ...)
+
+Salida: obj/sweep/results.csv y obj/sweep/results.json (una fila por ejecución).
+Las variantes se compilan en obj/sweep/<variante>/ con su propio OBJ_DIR y
+ASM_DIR, sin tocar asm/ ni el binario del repositorio.
+"""
+
+import argparse
+import csv
+import itertools
+import json
+import os
+import re
+import subprocess
+import sys
+import time
+from concurrent.futures import ThreadPoolExecutor
+
+ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+SWEEP_DIR = os.path.join("obj", "sweep")
+
+# Líneas de estadísticas impresas por main.c -> columnas del resultado
+PATTERNS = [
+    (r"^Total: accesses=(\d+) hits=(\d+) misses=(\d+)",
+     ["cache_accesses", "cache_hits", "cache_misses"]),
+    (r"^Total: received=(\d+) broadcast_sent=(\d+)",
+     ["invalidations_received", "broadcasts_sent"]),
+    (r"^Transactions: BUS_RD=(\d+) BUS_RDX=(\d+) BUS_UPGR=(\d+) BUS_WB=(\d+) BUS_IFETCH=(\d+) Total=(\d+)",
+     ["bus_rd", "bus_rdx", "bus_upgr", "bus_wb", "bus_ifetch", "bus_total"]),
+    (r"^Coherence: broadcast_invalidations=(\d+)", ["bus_invalidations"]),
+    (r"^False sharing: (\d+) of \d+ invalidations", ["false_sharing_invalidations"]),
+    (r"^Traffic: data=(\d+) .*control=(\d+) .*total=(\d+)",
+     ["bus_data_bytes", "bus_control_bytes", "bus_total_bytes"]),
+    (r"^Accesses: reads=(\d+) writes=(\d+) total=(\d+)",
+     ["mem_reads", "mem_writes", "mem_accesses"]),
+    (r"^Host throughput: instructions=(\d+) wall=([\d.]+) s rate=(\d+)",
+     ["instructions", "wall_s", "instr_per_s"]),
+    (r"^Host CPU: pe_user=([\d.]+) pe_sys=([\d.]+) bus_user=([\d.]+) bus_sys=([\d.]+) "
+     r"mem_user=([\d.]+) mem_sys=([\d.]+)",
+     ["cpu_pe_user_s", "cpu_pe_sys_s", "cpu_bus_user_s", "cpu_bus_sys_s", "cpu_mem_user_s", "cpu_mem_sys_s"]),
+]
+STATUS = re.compile(r"^\s*Status: (\w+)")
+
+
+def _parse_axis(spec):
+    """'NOMBRE=v1,v2' -> ('NOMBRE', ['v1', 'v2'])."""
+    name, sep, values = spec.partition("=")
+    if not sep or not name or not values:
+        sys.exit(f"eje inválido '{spec}': se esperaba NOMBRE=v1,v2,...")
+    return name, values.split(",")
+
+
+def _combinations(axes):
+    names = [name for name, _ in axes]
+    for values in itertools.product(*(vals for _, vals in axes)):
+        yield dict(zip(names, values))
+
+
+def _variant_name(params):
+    return "_".join(f"{k}{v}" for k, v in params.items()) or "default"
+
+
+def build_variant(params):
+    """Compila la variante en obj/sweep/<variante>/. Devuelve (dir, error o None)."""
+    name = _variant_name(params)
+    vdir = os.path.join(SWEEP_DIR, name)
+    os.makedirs(vdir, exist_ok=True)
+    data_link = os.path.join(vdir, "data")
+    if not os.path.lexists(data_link):
+        os.symlink(os.path.join(ROOT, "data"), data_link)
+
+    defs = " ".join(f"-D{k}={v}" for k, v in params.items())
+    cmd = ["make", "-s", f"TARGET={vdir}/mp_mesi", f"OBJ_DIR={vdir}/obj",
+           f"ASM_DIR={vdir}/asm", f"SIM_DEFS={defs}"]
+    proc = subprocess.run(cmd, cwd=ROOT, capture_output=True, text=True)
+    if proc.returncode != 0:
+        return vdir, (proc.stderr or proc.stdout).strip().splitlines()[-1:] or ["make falló"]
+    return vdir, None
+
+
+def parse_output(text):
+    row = {}
+    for line in text.splitlines():
+        for pattern, columns in PATTERNS:
+            match = re.match(pattern, line)
+            if match:
+                for col, value in zip(columns, match.groups()):
+                    row[col] = float(value) if "." in value else int(value)
+        match = STATUS.match(line)
+        if match:
+            row["status"] = match.group(1)
+    return row
+
+
+def run_point(vdir, env_params, timeout):
+    env = dict(os.environ, NO_COLOR="1", LOG_LEVEL="WARN", **env_params)
+    start = time.perf_counter()
+    try:
+        proc = subprocess.run(["./mp_mesi"], cwd=vdir, env=env, capture_output=True,
+                              text=True, timeout=timeout)
+    except subprocess.TimeoutExpired:
+        return {"status": "TIMEOUT", "elapsed_s": round(time.perf_counter() - start, 3)}
+    row = parse_output(proc.stdout)
+    row["elapsed_s"] = round(time.perf_counter() - start, 3)
+    if proc.returncode != 0 and row.get("status", "CORRECT") == "CORRECT":
+        row["status"] = f"EXIT{proc.returncode}"
+    row.setdefault("status", "NO_STATUS")
+    return row
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Barrido paralelo de parámetros del simulador")
+    parser.add_argument("--grid", action="append", default=[], metavar="NOMBRE=v1,v2",
+                        help="parámetro de config.h (una variante compilada por valor)")
+    parser.add_argument("--env", action="append", default=[], metavar="NOMBRE=v1,v2",
+                        help="variable de entorno por ejecución")
+    parser.add_argument("--repeat", type=int, default=1, help="ejecuciones por punto")
+    parser.add_argument("--jobs", type=int, default=os.cpu_count() or 1,
+                        help="compilaciones/ejecuciones concurrentes (por defecto: núcleos del host)")
+    parser.add_argument("--timeout", type=float, default=600, help="segundos por ejecución")
+    parser.add_argument("--out", default=os.path.join(SWEEP_DIR, "results.csv"),
+                        help="CSV de salida (se escribe también el .json)")
+    args = parser.parse_args()
+
+    os.chdir(ROOT)
+    grid = [_parse_axis(s) for s in args.grid]
+    env_axes = [_parse_axis(s) for s in args.env]
+    variants = list(_combinations(grid))
+    env_points = list(_combinations(env_axes))
+
+    print(f"Compilando {len(variants)} variante(s) con {args.jobs} trabajo(s)...")
+    with ThreadPoolExecutor(max_workers=args.jobs) as pool:
+        builds = list(pool.map(build_variant, variants))
+    for params, (vdir, error) in zip(variants, builds):
+        if error:
+            print(f"  {_variant_name(params)}: ERROR {' '.join(error)}")
+
+    points = [(params, vdir, error, env_params, rep)
+              for params, (vdir, error) in zip(variants, builds)
+              for env_params in env_points
+              for rep in range(args.repeat)]
+    print(f"Ejecutando {len(points)} punto(s)...")
+
+    def run(point):
+        params, vdir, error, env_params, rep = point
+        if error:
+            result = {"status": "BUILD_FAILED"}
+        else:
+            result = run_point(vdir, env_params, args.timeout)
+        row = {"variant": _variant_name(params), **params, **env_params, "repeat": rep, **result}
+        print(f"  {row['variant']} {' '.join(f'{k}={v}' for k, v in env_params.items())}"
+              f" #{rep}: {row['status']}", flush=True)
+        return row
+
+    start = time.perf_counter()
+    with ThreadPoolExecutor(max_workers=args.jobs) as pool:
+        rows = list(pool.map(run, points))
+    elapsed = time.perf_counter() - start
+
+    columns = []
+    for row in rows:
+        columns += [c for c in row if c not in columns]
+    os.makedirs(os.path.dirname(args.out) or ".", exist_ok=True)
+    with open(args.out, "w", newline="") as f:
+        writer = csv.DictWriter(f, fieldnames=columns)
+        writer.writeheader()
+        writer.writerows(rows)
+    json_path = os.path.splitext(args.out)[0] + ".json"
+    with open(json_path, "w") as f:
+        json.dump(rows, f, indent=2)
+
+    failed = sum(1 for r in rows if r["status"] != "CORRECT")
+    print(f"{len(rows)} ejecuciones en {elapsed:.2f} s ({failed} con error) -> {args.out}, {json_path}")
+    sys.exit(1 if failed else 0)
+
+
+if __name__ == "__main__":
+    main()
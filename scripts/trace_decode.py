@@ -0,0 +1,150 @@
+#!/usr/bin/env python3
+"""
+Decodificador de la traza binaria del simulador (SIM_TRACE=<archivo>)
+Imprime los eventos en orden global o los agrega por mensaje, PE y bloque.
+
+Uso:
+    python3 scripts/trace_decode.py obj/trace.bin              # eventos
+    python3 scripts/trace_decode.py obj/trace.bin --summary    # agregados
+    python3 scripts/trace_decode.py obj/trace.bin --pe 3 --msg BUS_UPGR --addr 0x10
+
+Formato (src/trace/trace.h): cabecera TraceHeader y registros TraceRecord de
+32 bytes escritos por bloques de cada hilo; el campo seq da el orden global.
+Un evento BUS cierra su transacción: las transiciones STATE que causó llevan
+un seq menor.
+"""
+
+import argparse
+import struct
+import sys
+from collections import Counter, defaultdict
+
+HEADER = struct.Struct("<8sIIII")
+RECORD = struct.Struct("<QQiBBBBBBHI")
+MAGIC = b"MPTRACE"
+VERSION = 1
+
+KINDS = ["BUS", "STATE", "UPGR_LOST"]
+MSGS = ["BUS_RD", "BUS_RDX", "BUS_UPGR", "BUS_WB", "BUS_IFETCH"]
+STATES = "MESI"
+NONE = 0xFF
+
+
+def _msg_name(msg):
+    if msg == NONE:
+        return "local"
+    return MSGS[msg] if msg < len(MSGS) else f"MSG{msg}"
+
+
+def _state_name(state):
+    if state == NONE:
+        return "-"
+    return STATES[state] if state < len(STATES) else "?"
+
+
+def read_trace(path):
+    """Devuelve (cabecera, lista de registros ordenada por seq)."""
+    with open(path, "rb") as f:
+        data = f.read()
+
+    if len(data) < HEADER.size:
+        sys.exit(f"{path}: archivo demasiado corto")
+    magic, version, record_size, num_pes, block_size = HEADER.unpack_from(data, 0)
+    if magic.rstrip(b"\0") != MAGIC:
+        sys.exit(f"{path}: no es una traza ({magic!r})")
+    if version != VERSION or record_size != RECORD.size:
+        sys.exit(f"{path}: versión {version} / registro de {record_size} bytes no soportados")
+
+    body = data[HEADER.size:]
+    usable = len(body) - len(body) % RECORD.size
+    records = []
+    for seq, time_ns, addr, kind, pe, src_pe, msg, old, new, invs, _ in RECORD.iter_unpack(body[:usable]):
+        records.append({
+            "seq": seq, "time_ns": time_ns, "addr": addr, "kind": kind, "pe": pe,
+            "src_pe": src_pe, "msg": msg, "old": old, "new": new, "invs": invs,
+        })
+    records.sort(key=lambda r: r["seq"])
+    header = {"num_pes": num_pes, "block_size": block_size}
+    return header, records
+
+
+def _transition(r):
+    if r["old"] == NONE and r["new"] == NONE:
+        return "-"
+    return f"{_state_name(r['old'])}->{_state_name(r['new'])}"
+
+
+def print_events(records, limit):
+    print(f"{'seq':>7} {'time_us':>10}  {'kind':<9} {'PE':>3} {'src':>3}  {'msg':<10} {'addr':>6}  trans  inv")
+    for r in records[:limit] if limit else records:
+        print(f"{r['seq']:>7} {r['time_ns'] / 1000:>10.1f}  {KINDS[r['kind']]:<9} "
+              f"{r['pe']:>3} {r['src_pe']:>3}  {_msg_name(r['msg']):<10} {r['addr']:#6x}  "
+              f"{_transition(r):<5}  {r['invs'] if r['kind'] == 0 else '':>3}")
+
+
+def print_summary(header, records, top):
+    bus = [r for r in records if r["kind"] == 0]
+    states = [r for r in records if r["kind"] == 1]
+    lost = [r for r in records if r["kind"] == 2]
+
+    span = (records[-1]["time_ns"] - records[0]["time_ns"]) / 1e6 if records else 0.0
+    print(f"Records: {len(records)} (bus={len(bus)} state={len(states)} upgr_lost={len(lost)}) "
+          f"span={span:.3f} ms PEs={header['num_pes']} BLOCK_SIZE={header['block_size']}")
+
+    print("\nBus transactions per PE:")
+    per_pe = defaultdict(Counter)
+    for r in bus:
+        per_pe[r["pe"]][r["msg"]] += 1
+    print("  " + f"{'PE':<4}" + "".join(f"{m:>11}" for m in MSGS) + f"{'inv':>6}")
+    for pe in sorted(per_pe):
+        invs = sum(r["invs"] for r in bus if r["pe"] == pe)
+        print("  " + f"PE{pe:<2}" + "".join(f"{per_pe[pe][i]:>11}" for i in range(len(MSGS))) + f"{invs:>6}")
+
+    print(f"\nHottest blocks (top {top}):")
+    per_block = defaultdict(Counter)
+    for r in bus:
+        per_block[r["addr"]][r["msg"]] += 1
+    ranked = sorted(per_block.items(), key=lambda kv: -sum(kv[1].values()))
+    for addr, msgs in ranked[:top]:
+        detail = " ".join(f"{_msg_name(m)}={n}" for m, n in sorted(msgs.items()))
+        sharers = sorted({r["pe"] for r in bus if r["addr"] == addr})
+        print(f"  {addr:#06x}: {sum(msgs.values()):>4}  {detail}  PEs={sharers}")
+
+    print("\nMESI transitions (cause):")
+    trans = Counter((_state_name(r["old"]), _state_name(r["new"]), _msg_name(r["msg"])) for r in states)
+    for (old, new, cause), n in sorted(trans.items(), key=lambda kv: -kv[1]):
+        print(f"  {old}->{new} {cause:<10} {n:>5}")
+
+    if lost:
+        print("\nBUS_UPGR served as BUS_RDX (S copy lost while queued):")
+        for addr, n in Counter(r["addr"] for r in lost).most_common(top):
+            print(f"  {addr:#06x}: {n}")
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Decodifica una traza SIM_TRACE")
+    parser.add_argument("trace", help="archivo escrito con SIM_TRACE=<archivo>")
+    parser.add_argument("--summary", action="store_true", help="agregados en lugar de eventos")
+    parser.add_argument("--pe", type=int, help="solo eventos de este PE (cache afectada o solicitante)")
+    parser.add_argument("--msg", choices=MSGS, help="solo eventos causados por este mensaje")
+    parser.add_argument("--addr", type=lambda s: int(s, 0), help="solo este bloque")
+    parser.add_argument("--limit", type=int, default=0, help="máximo de eventos a imprimir")
+    parser.add_argument("--top", type=int, default=8, help="bloques en el ranking del resumen")
+    args = parser.parse_args()
+
+    header, records = read_trace(args.trace)
+    if args.pe is not None:
+        records = [r for r in records if args.pe in (r["pe"], r["src_pe"])]
+    if args.msg:
+        records = [r for r in records if r["msg"] == MSGS.index(args.msg)]
+    if args.addr is not None:
+        records = [r for r in records if r["addr"] == args.addr]
+
+    if args.summary:
+        print_summary(header, records, args.top)
+    else:
+        print_events(records, args.limit)
+
+
+if __name__ == "__main__":
+    main()
@@ -1,10 +1,22 @@
 #define LOG_MODULE "BUS"
 #include "bus.h"
 #include "handlers.h"
+#include "trace.h"
+#include "block_stats.h"
+#include "coherence_check.h"
 #include <stdio.h>
+#include <time.h>
 #include <pthread.h>
 #include "log.h"
 
+_Static_assert(BUS_NUM_MSGS == BUS_LATENCY_MSGS, "latency_stats.h names one histogram per BusMsg");
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
 // INICIALIZACIÓN Y LIMPIEZA
 
 void bus_init(Bus* bus, Cache* caches[], Memory* memory) {
@@ -14,6 +26,7 @@ void bus_init(Bus* bus, Cache* caches[], Memory* memory) {
     
     bus->memory = memory;
     bus_stats_init(&bus->stats);
+    bus_latency_init(&bus->latency);
 
     pthread_mutex_init(&bus->mutex, NULL);
     pthread_cond_init(&bus->request_ready, NULL);
@@ -51,6 +64,7 @@ void bus_broadcast(Bus* bus, BusMsg msg, int addr, int src_pe) {
 
 void bus_broadcast_with_callback(Bus* bus, BusMsg msg, int addr, int src_pe,
                                    BusCallback callback, void* callback_context) {
+    uint64_t t0 = now_ns();
     pthread_mutex_lock(&bus->mutex);
     
     // Esperar si este PE ya tiene una solicitud pendiente
@@ -66,6 +80,7 @@ void bus_broadcast_with_callback(Bus* bus, BusMsg msg, int addr, int src_pe,
     bus->requests[src_pe].processed = false;
     bus->requests[src_pe].callback = callback;
     bus->requests[src_pe].callback_context = callback_context;
+    bus->requests[src_pe].enqueue_ns = now_ns();
     
     pthread_cond_signal(&bus->request_ready);
     
@@ -76,6 +91,9 @@ void bus_broadcast_with_callback(Bus* bus, BusMsg msg, int addr, int src_pe,
     
     bus->requests[src_pe].has_request = false;
     pthread_mutex_unlock(&bus->mutex);
+
+    // Round trip seen by the PE: arbitration + service + waking this thread up
+    latency_record(&bus->latency.pe[src_pe].roundtrip[msg], now_ns() - t0);
 }
 
 // THREAD DEL BUS (Round-Robin)
@@ -84,6 +102,9 @@ void* bus_thread_func(void* arg) {
     Bus* bus = (Bus*)arg;
     LOGD("Thread started (round-robin)");
     
+    // Snoops and callbacks update the caches' counters from this thread
+    stats_thread_shard = STATS_SHARD_BUS;
+    
     while (bus->running) {
         pthread_mutex_lock(&bus->mutex);
         
@@ -123,6 +144,10 @@ void* bus_thread_func(void* arg) {
         
     LOGD("RR: PE%d signal=%d addr=%d", selected_pe, req->msg, req->addr);
         
+        // Espera de arbitraje: desde el registro hasta que el round-robin la elige
+        uint64_t service_start = now_ns();
+        latency_record(&bus->latency.wait[req->src_pe][req->msg], service_start - req->enqueue_ns);
+        
         // Registrar estadísticas
         switch (req->msg) {
             case BUS_RD:
@@ -148,8 +173,34 @@ void* bus_thread_func(void* arg) {
                 bus_stats_record_control_base(&bus->stats, BUS_CONTROL_SIGNAL_SIZE);
                 bus_stats_record_data_transfer(&bus->stats, BLOCK_SIZE * sizeof(double));
                 break;
+            case BUS_IFETCH:
+                bus_stats_record_bus_ifetch(&bus->stats, req->src_pe);
+                // BUS_IFETCH transfiere un bloque de código + señal de control
+                bus_stats_record_control_base(&bus->stats, BUS_CONTROL_SIGNAL_SIZE);
+                bus_stats_record_data_transfer(&bus->stats, BLOCK_SIZE * sizeof(double));
+                break;
+            default:
+                break;
+        }
+        
+        // Tráfico sobre bloques del área de sincronización (flags, contador de barrera)
+        if (req->addr >= ALIGN_DOWN(SYNC_AREA_START) && req->addr < SYNC_AREA_END) {
+            bus_stats_record_sync(&bus->stats);
         }
         
+        // Traza: estado del solicitante antes de la transacción e invalidaciones que causa
+        int trace_old = TRACE_NO_STATE;
+        uint64_t invs_before = bus->stats.invalidations_sent;
+        if (trace_enabled) {
+            if (req->msg != BUS_IFETCH) {
+                trace_old = cache_get_state(bus->caches[req->src_pe], req->addr);
+            }
+            trace_set_context(req->msg, req->src_pe);
+        }
+        
+        // Estado del solicitante antes de la transacción (comprobación de writeback)
+        MESI_State coherence_old = coherence_shadow_state(req->src_pe, req->addr);
+        
         // Ejecutar handler
         if (bus->handlers[req->msg]) {
             bus->handlers[req->msg](bus, req->addr, req->src_pe);
@@ -163,6 +214,30 @@ void* bus_thread_func(void* arg) {
             req->callback(req->callback_context);
         }
         
+        // Servicio: handler (snoops, memoria) + callback
+        latency_record(&bus->latency.service[req->src_pe][req->msg], now_ns() - service_start);
+        
+        int invalidations = (int)(bus->stats.invalidations_sent - invs_before);
+        if (trace_enabled) {
+            int trace_new = (req->msg == BUS_IFETCH) ? TRACE_NO_STATE
+                          : (int)cache_get_state(bus->caches[req->src_pe], req->addr);
+            trace_record(TRACE_BUS, req->src_pe, req->msg, req->addr, trace_old, trace_new,
+                         invalidations);
+            trace_clear_context();
+        }
+        
+        // Invariantes MESI sobre el bloque, con la transacción completa
+        if (coherence_check_enabled) {
+            coherence_check_transaction(req->msg, req->addr, req->src_pe, coherence_old);
+        }
+        
+        // Contención por bloque (el código no es coherente: BUS_IFETCH no cuenta)
+        if (req->msg != BUS_IFETCH) {
+            block_stats_record_bus(req->addr, req->src_pe,
+                                   req->msg == BUS_RDX || req->msg == BUS_UPGR,
+                                   req->msg == BUS_UPGR, invalidations);
+        }
+        
         // Marcar como procesada y señalizar al PE
         req->processed = true;
         pthread_cond_broadcast(&bus->requests[selected_pe].done);
@@ -170,6 +245,7 @@ void* bus_thread_func(void* arg) {
         pthread_mutex_unlock(&bus->mutex);
     }
     
+    host_cpu_self(&bus->cpu);
     LOGD("Thread finished");
     return NULL;
 }
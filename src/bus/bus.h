@@ -3,13 +3,15 @@
 
 #include "config.h"
 #include "bus_stats.h"
+#include "latency_stats.h"
+#include "sched_stats.h"
 #include "memory.h"
 #include "cache.h"
 #include <pthread.h>
 #include <stdbool.h>
 
 // Bus message types
-typedef enum { BUS_RD, BUS_RDX, BUS_UPGR, BUS_WB } BusMsg;
+typedef enum { BUS_RD, BUS_RDX, BUS_UPGR, BUS_WB, BUS_IFETCH, BUS_NUM_MSGS } BusMsg;
 
 struct Bus; // Forward declaration
 
@@ -30,19 +32,22 @@ typedef struct {
     pthread_cond_t done;         // Condition variable for this PE
     BusCallback callback;        // Optional callback to run after handler
     void* callback_context;      // Context passed to the callback
+    uint64_t enqueue_ns;         // Host time the request was registered (arbitration wait)
 } PERequest;
 
 // Bus main structure
 typedef struct Bus {
     Cache* caches[NUM_PES];
     Memory* memory;              // Memory reference
-    BusHandler handlers[4];      // Dispatch table
+    BusHandler handlers[BUS_NUM_MSGS]; // Dispatch table
     pthread_mutex_t mutex;       // Bus protection
     pthread_cond_t request_ready; // New request signal
     PERequest requests[NUM_PES]; // One request per PE
     int next_pe;                 // Next PE to serve (round-robin)
     bool running;                // Bus is running
-    BusStats stats;              // Bus statistics
+    _Alignas(HOST_CACHE_LINE) BusStats stats; // Bus statistics (written by the bus thread only)
+    BusLatencyStats latency;     // Wait/service (bus thread) and round trip (each PE) histograms
+    HostCpu cpu;                 // Host CPU of the bus thread, taken when it exits
 } Bus;
 
 // Public API
@@ -0,0 +1,215 @@
+#define LOG_MODULE "COHERENCE"
+#include "coherence_check.h"
+#include "bus.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "log.h"
+
+bool coherence_check_enabled = false;
+
+static bool ABORT = false;               // SIM_COHERENCE_CHECK=abort
+static uint64_t* SHADOW = NULL;          // COHERENCE_WORDS words per block
+static Bus* BUS = NULL;
+
+// Bus thread only
+static uint64_t transactions = 0;
+static uint64_t violations = 0;
+
+#define LO_BITS 0x5555555555555555ull
+
+// 2-bit codes indexed by MESI_State (M, E, S, I): the high bit means exclusive
+static const uint64_t CODE[4] = { 3, 2, 1, 0 };
+static const MESI_State STATE[4] = { I, S, E, M };
+
+static const char* MSG_NAMES[BUS_NUM_MSGS] = {
+    "BUS_RD", "BUS_RDX", "BUS_UPGR", "BUS_WB", "BUS_IFETCH"
+};
+
+// INIT
+
+int coherence_check_init(void) {
+    const char* env = getenv("SIM_COHERENCE_CHECK");
+    if (!env || !*env || strcmp(env, "0") == 0) {
+        return 0;
+    }
+    if (strcmp(env, "abort") == 0) {
+        ABORT = true;
+    } else if (strcmp(env, "1") != 0) {
+        LOGE("Invalid SIM_COHERENCE_CHECK=%s (use 0, 1 or abort)", env);
+        return -1;
+    }
+
+    SHADOW = calloc((size_t)COHERENCE_BLOCKS * COHERENCE_WORDS, sizeof(uint64_t));
+    if (!SHADOW) {
+        LOGW("Out of memory for the coherence shadow table, checker disabled");
+        return 0;
+    }
+    coherence_check_enabled = true;
+    return 0;
+}
+
+void coherence_check_start(Bus* bus) {
+    if (!coherence_check_enabled) return;
+    BUS = bus;
+    for (int i = 0; i < NUM_PES; i++) {
+        pthread_mutex_lock(&bus->caches[i]->mutex);
+        coherence_resync(bus->caches[i]);
+        pthread_mutex_unlock(&bus->caches[i]->mutex);
+    }
+}
+
+void coherence_check_free(void) {
+    free(SHADOW);
+    SHADOW = NULL;
+    coherence_check_enabled = false;
+}
+
+// SHADOW TABLE
+
+static uint64_t* shadow_word(int pe_id, int block_base, int* shift) {
+    int block = block_base / BLOCK_SIZE;
+    if (block < 0 || block >= COHERENCE_BLOCKS) return NULL;
+    *shift = 2 * (pe_id % COHERENCE_PES_WORD);
+    return &SHADOW[(size_t)block * COHERENCE_WORDS + pe_id / COHERENCE_PES_WORD];
+}
+
+void coherence_shadow_set(int pe_id, int block_base, MESI_State state) {
+    int shift;
+    uint64_t* word = shadow_word(pe_id, block_base, &shift);
+    if (!word) return;
+    // Only this PE's field changes here (its cache mutex is held); the XOR
+    // leaves the fields of the other PEs in the same word untouched
+    uint64_t old = (__atomic_load_n(word, __ATOMIC_RELAXED) >> shift) & 3;
+    uint64_t diff = old ^ CODE[state];
+    if (diff) {
+        __atomic_fetch_xor(word, diff << shift, __ATOMIC_RELAXED);
+    }
+}
+
+MESI_State coherence_shadow_state(int pe_id, int block_base) {
+    if (!coherence_check_enabled) return I;
+    int shift;
+    uint64_t* word = shadow_word(pe_id, block_base, &shift);
+    return word ? STATE[(__atomic_load_n(word, __ATOMIC_RELAXED) >> shift) & 3] : I;
+}
+
+void coherence_resync(Cache* cache) {
+    if (!coherence_check_enabled) return;
+    int pe_id = cache->pe_id;
+    for (int block = 0; block < COHERENCE_BLOCKS; block++) {
+        coherence_shadow_set(pe_id, block * BLOCK_SIZE, I);
+    }
+    // Lines are scanned in way order, like cache_get_line: the first valid
+    // line with the tag is the one the cache uses
+    for (int set = 0; set < SETS; set++) {
+        for (int way = WAYS - 1; way >= 0; way--) {
+            CacheLine* line = &cache->sets[set].lines[way];
+            if (line->valid) {
+                coherence_shadow_set(pe_id, (int)(line->tag * SETS + set), line->state);
+            }
+        }
+    }
+}
+
+// CHECK
+
+static void shadow_states(int block_base, char* buf, size_t size) {
+    size_t len = 0;
+    buf[0] = '\0';
+    for (int i = 0; i < NUM_PES && len < size; i++) {
+        MESI_State state = coherence_shadow_state(i, block_base);
+        if (state == I) continue;
+        len += snprintf(buf + len, size - len, " PE%d:%c", i, "MESI"[state]);
+    }
+}
+
+static void violation(const char* what, int msg, int block_base, int src_pe) {
+    violations++;
+    if (violations <= COHERENCE_REPORT_MAX || ABORT) {
+        char states[NUM_PES * 8 + 1];
+        shadow_states(block_base, states, sizeof(states));
+        LOGE("%s: block 0x%X after %s from PE%d, copies:%s", what, block_base,
+             MSG_NAMES[msg], src_pe, states[0] ? states : " none");
+    }
+    if (ABORT) {
+        log_flush();
+        abort();
+    }
+}
+
+// Compares a line of this cache with memory if it still holds the block in
+// one of the given states. Returns 1 on mismatch.
+static int line_differs(Cache* cache, int block_base, bool clean_only) {
+    int differs = 0;
+    pthread_mutex_lock(&cache->mutex);
+    CacheLine* line = cache_get_line(cache, block_base);
+    if (line && (!clean_only || line->state == S || line->state == E)) {
+        differs = memcmp(line->data, &BUS->memory->data[block_base], sizeof(line->data)) != 0;
+    }
+    pthread_mutex_unlock(&cache->mutex);
+    return differs;
+}
+
+void coherence_check_transaction(int msg, int block_base, int src_pe, MESI_State src_before) {
+    if (msg == BUS_IFETCH) return;
+    int block = block_base / BLOCK_SIZE;
+    if (block < 0 || block >= COHERENCE_BLOCKS) return;
+    transactions++;
+
+    // Counts from the 2-bit fields: valid = any bit, exclusive = high bit, M = both
+    uint64_t words[COHERENCE_WORDS];
+    int valid = 0, exclusive = 0;
+    for (int w = 0; w < COHERENCE_WORDS; w++) {
+        words[w] = __atomic_load_n(&SHADOW[(size_t)block * COHERENCE_WORDS + w], __ATOMIC_RELAXED);
+        uint64_t lo = words[w] & LO_BITS;
+        uint64_t hi = (words[w] >> 1) & LO_BITS;
+        valid += __builtin_popcountll(lo | hi);
+        exclusive += __builtin_popcountll(hi);
+    }
+    if (exclusive > 1) {
+        violation("Multiple M/E owners", msg, block_base, src_pe);
+    } else if (exclusive == 1 && valid > 1) {
+        violation("M/E copy coexists with other copies", msg, block_base, src_pe);
+    }
+
+    // Clean copies (S, or E not yet silently written) must match memory
+    for (int w = 0; w < COHERENCE_WORDS; w++) {
+        uint64_t lo = words[w] & LO_BITS;
+        uint64_t hi = (words[w] >> 1) & LO_BITS;
+        uint64_t clean = lo ^ hi;   // Exactly one bit set: S (01) or E (10)
+        while (clean) {
+            int pe_id = w * COHERENCE_PES_WORD + __builtin_ctzll(clean) / 2;
+            clean &= clean - 1;
+            if (line_differs(BUS->caches[pe_id], block_base, true)) {
+                violation("Clean copy differs from memory", msg, block_base, src_pe);
+            }
+        }
+    }
+
+    // The writer waits for the BUS_WB: its line keeps the tag and the data
+    if (msg == BUS_WB && src_before == M &&
+        line_differs(BUS->caches[src_pe], block_base, false)) {
+        violation("Evicted M line did not reach memory", msg, block_base, src_pe);
+    }
+
+    // The requestor is blocked on the bus: its line cannot change meanwhile
+    MESI_State actual = cache_get_state(BUS->caches[src_pe], block_base);
+    if (actual != coherence_shadow_state(src_pe, block_base)) {
+        violation("Untracked state transition", msg, block_base, src_pe);
+    }
+}
+
+// REPORT
+
+uint64_t coherence_check_violations(void) {
+    return violations;
+}
+
+void coherence_check_print(void) {
+    if (!coherence_check_enabled) return;
+    const char* BLUE = log_color_blue();
+    const char* RESET = log_color_reset();
+    printf("\n%s[Coherence check]%s%s transactions=%lu violations=%lu\n", BLUE, RESET,
+           ABORT ? " (abort)" : "", (unsigned long)transactions, (unsigned long)violations);
+}
@@ -0,0 +1,86 @@
+#ifndef COHERENCE_CHECK_H
+#define COHERENCE_CHECK_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "config.h"
+#include "cache.h"
+
+/**
+ * @file coherence_check.h
+ * @brief Verificación en línea de los invariantes de coherencia (SIM_COHERENCE_CHECK)
+ *
+ * Después de cada transacción de bus (salvo BUS_IFETCH), el hilo del bus
+ * comprueba sobre el bloque transaccionado:
+ *   single writer   como mucho una copia en M/E, y una copia M/E no convive
+ *                   con ninguna otra copia válida (ni M con S)
+ *   datos           cada copia S/E (limpia) coincide con memoria
+ *   writeback       un BUS_WB de una línea en M deja sus datos en memoria
+ *   contabilidad    el estado real de la línea del solicitante coincide con
+ *                   la tabla de estados (detecta una transición sin registrar)
+ *
+ * En lugar de recorrer las NUM_PES cachés, se mantiene una tabla sombra con
+ * el estado de cada bloque en cada PE: 2 bits por PE (I=0, S=1, E=2, M=3)
+ * en COHERENCE_WORDS palabras de 64 bits por bloque. Cada transición de
+ * línea la actualiza con un XOR atómico (cache_transition, los hits E->M
+ * silenciosos y los reemplazos silenciosos de E/S), y los contadores del
+ * bloque salen de popcount sobre esas palabras: el coste por transacción es
+ * O(1) en el tamaño de las cachés. Solo se bloquean las cachés con una copia
+ * S/E del bloque, para comparar sus datos.
+ *
+ * Los campos de un PE solo se escriben con el mutex de su caché tomado. El
+ * modo funcional (fast-forward) cambia estados sin registrarlos: la columna
+ * de un PE se reconstruye al volver al modo detallado.
+ *
+ * SIM_COHERENCE_CHECK=1 cuenta y registra las violaciones (las primeras
+ * COHERENCE_REPORT_MAX en detalle) y el código de salida pasa a ser 1;
+ * SIM_COHERENCE_CHECK=abort aborta en la primera. Desactivado, cada punto de
+ * enganche cuesta una comparación.
+ */
+
+#define COHERENCE_BLOCKS     (MEM_SIZE / BLOCK_SIZE)
+#define COHERENCE_PES_WORD   32                          // 2 bits per PE
+#define COHERENCE_WORDS      ((NUM_PES + COHERENCE_PES_WORD - 1) / COHERENCE_PES_WORD)
+#define COHERENCE_REPORT_MAX 10
+
+// Checked inline at every hook
+extern bool coherence_check_enabled;
+
+/**
+ * @brief Lee SIM_COHERENCE_CHECK y reserva la tabla sombra
+ * @return 0 si OK, -1 si el valor es inválido
+ */
+int coherence_check_init(void);
+
+// Builds the shadow table from the caches (after a checkpoint restore, before the threads start)
+void coherence_check_start(Bus* bus);
+
+void coherence_check_free(void);
+
+// Shadow update of one PE's state for a block. Cache mutex of pe_id held.
+void coherence_shadow_set(int pe_id, int block_base, MESI_State state);
+
+static inline void coherence_track(int pe_id, int block_base, MESI_State state) {
+    if (coherence_check_enabled) {
+        coherence_shadow_set(pe_id, block_base, state);
+    }
+}
+
+// Rebuilds the cache's column from its lines (leaving functional mode). Cache mutex held.
+void coherence_resync(Cache* cache);
+
+// Shadow state of a block in one PE (I if the checker is off)
+MESI_State coherence_shadow_state(int pe_id, int block_base);
+
+/**
+ * @brief Comprueba los invariantes tras una transacción (hilo del bus)
+ * @param src_before Estado del solicitante antes del handler (coherence_shadow_state)
+ */
+void coherence_check_transaction(int msg, int block_base, int src_pe, MESI_State src_before);
+
+uint64_t coherence_check_violations(void);
+
+// Prints the [Coherence check] section (nothing if the checker is off)
+void coherence_check_print(void);
+
+#endif // COHERENCE_CHECK_H
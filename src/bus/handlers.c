@@ -2,6 +2,7 @@
 #include "handlers.h"
 #include "memory.h"
 #include "cache.h"
+#include "trace.h"
 #include <stdio.h>
 #include "log.h"
 
@@ -12,6 +13,7 @@ void bus_register_handlers(Bus* bus) {
     bus->handlers[BUS_RDX]  = handle_busrdx;
     bus->handlers[BUS_UPGR] = handle_busupgr;
     bus->handlers[BUS_WB]   = handle_buswb;
+    bus->handlers[BUS_IFETCH] = handle_busifetch;
 }
 
 // HANDLER: BUS_RD (Shared read)
@@ -25,22 +27,18 @@ void handle_busrd(Bus* bus, int addr, int src_pe) {
             Cache* cache = bus->caches[i];
             MESI_State state = cache_get_state(cache, addr);
             
-            if (state == M) {
+            if (state == M || state == E) {
+                // Copy and downgrade under the owner's lock: the owner keeps
+                // running and may write-hit (or silently E->M) in between
                 double block[BLOCK_SIZE];
-                cache_get_block(cache, addr, block);
-                LOGD("Cache PE%d: M -> writeback and move to S", i);
-                mem_write_block(bus->memory, addr, block, src_pe);
-                cache_set_block(requestor, addr, block);
-                cache_set_state(cache, addr, S);      // M->S (record transition)
-                cache_set_state(requestor, addr, S);  // I->S (record transition)
-                data_found = 1;
-                return;
-            } else if (state == E) {
-                double block[BLOCK_SIZE];
-                cache_get_block(cache, addr, block);
-                LOGD("Cache PE%d: E -> move to S", i);
+                MESI_State owned = cache_snoop(cache, addr, S, block);  // M->S or E->S
+                if (owned == M) {
+                    LOGD("Cache PE%d: M -> writeback and move to S", i);
+                    mem_write_block(bus->memory, addr, block, src_pe);
+                } else {
+                    LOGD("Cache PE%d: E -> move to S", i);
+                }
                 cache_set_block(requestor, addr, block);
-                cache_set_state(cache, addr, S);      // E->S (record transition)
                 cache_set_state(requestor, addr, S);  // I->S (record transition)
                 data_found = 1;
                 return;
@@ -82,11 +80,10 @@ void handle_busrdx(Bus* bus, int addr, int src_pe) {
             
             if (state == M) {
                 double block[BLOCK_SIZE];
-                cache_get_block(cache, addr, block);
+                cache_snoop(cache, addr, I, block);   // M->I (record transition)
                 LOGD("Cache PE%d: M -> writeback and invalidate", i);
                 mem_write_block(bus->memory, addr, block, src_pe);
                 cache_set_block(requestor, addr, block);
-                cache_set_state(cache, addr, I);      // M->I (record transition)
                 cache_set_state(requestor, addr, M);  // I->M (record transition)
                 data_found = 1;
                 invalidations_count++;
@@ -104,13 +101,14 @@ void handle_busrdx(Bus* bus, int addr, int src_pe) {
             } else if (state == E || state == S) {
                 if (!data_found) {
                     double block[BLOCK_SIZE];
-                    cache_get_block(cache, addr, block);
+                    cache_snoop(cache, addr, I, block);   // E->I or S->I (record transition)
                     LOGD("Cache PE%d: %c -> provide and invalidate", i, state == E ? 'E' : 'S');
                     cache_set_block(requestor, addr, block);
                     cache_set_state(requestor, addr, M);  // I->M (record transition)
                     data_found = 1;
+                } else {
+                    cache_set_state(cache, addr, I);  // S->I (record transition)
                 }
-                cache_set_state(cache, addr, I);  // E->I or S->I (record transition)
                 invalidations_count++;
             }
         }
@@ -144,6 +142,17 @@ void handle_busupgr(Bus* bus, int addr, int src_pe) {
     Cache* requestor = bus->caches[src_pe];
     int invalidations_count = 0;
     
+    // The S copy may have been invalidated while this request waited for the
+    // bus; the requestor then holds no valid data and is served as BUS_RDX
+    if (cache_get_state(requestor, addr) != S) {
+        LOGD("PE%d: upgrade lost its S copy -> serve as BUS_RDX", src_pe);
+        if (trace_enabled) {
+            trace_record(TRACE_UPGR_LOST, src_pe, BUS_UPGR, addr, I, M, 0);
+        }
+        handle_busrdx(bus, addr, src_pe);
+        return;
+    }
+    
     for (int i = 0; i < NUM_PES; i++) {
         if (i != src_pe) {
             Cache* cache = bus->caches[i];
@@ -184,3 +193,13 @@ void handle_buswb(Bus* bus, int addr, int src_pe) {
     
     cache_set_state(writer, addr, I);
 }
+
+// HANDLER: BUS_IFETCH (Instruction fetch, not coherent)
+
+void handle_busifetch(Bus* bus, int addr, int src_pe) {
+    // Code is read-only: no snooping, the block always comes from memory.
+    // The requesting I-cache installs the tag in the bus callback.
+    double block[BLOCK_SIZE];
+    mem_read_block(bus->memory, addr, block, src_pe);
+    LOGD("I-fetch PE%d: code block 0x%X from memory", src_pe, addr);
+}
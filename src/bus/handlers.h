@@ -11,5 +11,6 @@ void handle_busrd(Bus* bus, int addr, int src_pe);
 void handle_busrdx(Bus* bus, int addr, int src_pe);
 void handle_busupgr(Bus* bus, int addr, int src_pe);
 void handle_buswb(Bus* bus, int addr, int src_pe);
+void handle_busifetch(Bus* bus, int addr, int src_pe);
 
 #endif
\ No newline at end of file
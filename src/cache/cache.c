@@ -1,7 +1,11 @@
 #define LOG_MODULE "CACHE"
 #include "cache.h"
 #include "bus.h"
+#include "trace.h"
+#include "block_stats.h"
+#include "coherence_check.h"
 #include <stdio.h>
+#include <time.h>
 #include "log.h"
 
 // PRIVATE STRUCTURES
@@ -9,23 +13,124 @@
 typedef struct {
     CacheLine* victim;
     int offset;
-    double value;
+    const double* values;
+    int count;
     int set_index;
     int victim_way;
     int pe_id;
+    Cache* cache;           // Upgrade only: the line is looked up again under the mutex
+    int block_base;
 } WriteCallbackContext;
 
 static void write_callback(void* context) {
     WriteCallbackContext* ctx = (WriteCallbackContext*)context;
     
-    // Write the value into the block
-    ctx->victim->data[ctx->offset] = ctx->value;
+    // Write the values into the block
+    for (int k = 0; k < ctx->count; k++) {
+        ctx->victim->data[ctx->offset + k] = ctx->values[k];
+    }
     
     // Change state to Modified (I->M already recorded by handler)
     ctx->victim->state = M;
     
-    LOGD("PE%d write callback: way=%d offset=%d value=%.2f state=M", 
-        ctx->pe_id, ctx->victim_way, ctx->offset, ctx->value);
+    LOGD("PE%d write callback: way=%d offset=%d count=%d value=%.2f state=M", 
+        ctx->pe_id, ctx->victim_way, ctx->offset, ctx->count, ctx->values[0]);
+}
+
+// BUS_UPGR of a write hit in S. Runs in the bus thread right after the
+// handler granted M: a BUS_RD served between the upgrade and a write done by
+// the PE thread would copy the old data and leave this line in M next to S
+// copies. The handler may have served it as BUS_RDX (S copy lost meanwhile).
+static void upgrade_write_callback(void* context) {
+    WriteCallbackContext* ctx = (WriteCallbackContext*)context;
+    Cache* cache = ctx->cache;
+    
+    pthread_mutex_lock(&cache->mutex);
+    CacheLine* line = cache_get_line(cache, ctx->block_base);
+    if (line) {
+        for (int k = 0; k < ctx->count; k++) {
+            line->data[ctx->offset + k] = ctx->values[k];
+        }
+        line->state = M;
+    }
+    pthread_mutex_unlock(&cache->mutex);
+    
+    LOGD("PE%d upgrade callback: offset=%d count=%d value=%.2f state=M",
+        ctx->pe_id, ctx->offset, ctx->count, ctx->values[0]);
+}
+
+// Copy lanes between a line and a caller buffer
+static void copy_from_line(const CacheLine* line, int offset, double* out, int count) {
+    for (int k = 0; k < count; k++) {
+        out[k] = line->data[offset + k];
+    }
+}
+
+static void copy_to_line(CacheLine* line, int offset, const double* values, int count) {
+    for (int k = 0; k < count; k++) {
+        line->data[offset + k] = values[k];
+    }
+}
+
+// Clamp a span so it never crosses the end of its block
+static int clamp_span(int offset, int count, int pe_id) {
+    if (count < 1) count = 1;
+    if (offset + count > BLOCK_SIZE) {
+        LOGE("PE%d access of %d words at offset %d crosses block boundary", pe_id, count, offset);
+        count = BLOCK_SIZE - offset;
+    }
+    return count;
+}
+
+typedef struct {
+    Cache* cache;
+    AtomicOp op;
+    int block_base;
+    int offset;
+    double operand;
+    double expected;
+    double old;
+    int success;
+} AtomicContext;
+
+// Apply an atomic operation on a line held in M. Cache mutex must be held.
+static void atomic_apply(Cache* cache, CacheLine* line, AtomicContext* ctx) {
+    ctx->old = line->data[ctx->offset];
+    
+    switch (ctx->op) {
+        case ATOMIC_FAA:
+            line->data[ctx->offset] = ctx->old + ctx->operand;
+            ctx->success = 1;
+            break;
+        case ATOMIC_CAS:
+            ctx->success = (ctx->old == ctx->expected);
+            if (ctx->success) line->data[ctx->offset] = ctx->operand;
+            break;
+        case ATOMIC_SC:
+            ctx->success = cache->link_valid && cache->link_addr == ctx->block_base;
+            if (ctx->success) line->data[ctx->offset] = ctx->operand;
+            cache->link_valid = 0;
+            break;
+    }
+    
+    if (!ctx->success) stats_record_atomic_failure(&cache->stats);
+}
+
+// Runs in the bus thread right after the handler granted M, so no other
+// transaction can steal the line between ownership and the update
+static void atomic_callback(void* context) {
+    AtomicContext* ctx = (AtomicContext*)context;
+    Cache* cache = ctx->cache;
+    
+    pthread_mutex_lock(&cache->mutex);
+    CacheLine* line = cache_get_line(cache, ctx->block_base);
+    if (line) {
+        line->state = M;
+        atomic_apply(cache, line, ctx);
+    }
+    pthread_mutex_unlock(&cache->mutex);
+    
+    LOGD("PE%d atomic callback: op=%d old=%.2f success=%d", cache->pe_id, ctx->op, ctx->old, ctx->success);
 }
 
 // INIT AND CLEANUP
@@ -33,8 +138,23 @@ static void write_callback(void* context) {
 void cache_init(Cache* cache) {
     cache->bus = NULL;
     cache->pe_id = -1;
+    cache->link_valid = 0;
+    cache->link_addr = -1;
+    cache->monitor_valid = 0;
+    cache->monitor_addr = -1;
+    cache->monitor_triggered = 0;
+    cache->mwait_enabled = 1;
+    cache->functional = 0;
+    cache->functional_warm = 0;
+    
+    icache_init(&cache->icache);
     
     pthread_mutex_init(&cache->mutex, NULL);
+    pthread_condattr_t attr;
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_cond_init(&cache->monitor_cond, &attr);
+    pthread_condattr_destroy(&attr);
     stats_init(&cache->stats);
     
     for (int i = 0; i < SETS; i++) {
@@ -48,11 +168,24 @@ void cache_init(Cache* cache) {
 
 void cache_destroy(Cache* cache) {
     pthread_mutex_destroy(&cache->mutex);
+    pthread_cond_destroy(&cache->monitor_cond);
+}
+
+// Losing the block (invalidation or eviction) breaks the LL/SC link and
+// fires the monitor. Must be called with the mutex held.
+void cache_lose_block(Cache* cache, int block_base) {
+    if (cache->link_valid && cache->link_addr == block_base) {
+        cache->link_valid = 0;
+    }
+    if (cache->monitor_valid && cache->monitor_addr == block_base) {
+        cache->monitor_triggered = 1;
+        pthread_cond_signal(&cache->monitor_cond);
+    }
 }
 
 // LRU POLICY
 
-static void cache_update_lru(Cache* cache, int set_index, int accessed_way) {
+void cache_update_lru(Cache* cache, int set_index, int accessed_way) {
     CacheSet* set = &cache->sets[set_index];
     for (int i = 0; i < WAYS; i++) {
         set->lines[i].lru_bit = (i == accessed_way) ? 1 : 0;
@@ -62,9 +195,22 @@ static void cache_update_lru(Cache* cache, int set_index, int accessed_way) {
 // READ AND WRITE OPERATIONS
 
 double cache_read(Cache* cache, int addr, int pe_id) {
+    double result;
+    cache_read_span(cache, addr, &result, 1, pe_id);
+    return result;
+}
+
+void cache_read_span(Cache* cache, int addr, double* out, int count, int pe_id) {
     // Compute block base address and offset within block
     int block_base = GET_BLOCK_BASE(addr);
     int offset = GET_BLOCK_OFFSET(addr);
+    count = clamp_span(offset, count, pe_id);
+    
+    if (cache->functional) {
+        cache_functional_read(cache, addr, out, count);
+        return;
+    }
+    block_stats_touch(pe_id, block_base, offset, count, false);
     
     // Log only when offset != 0 (unaligned address)
     if (offset != 0) {
@@ -85,13 +231,13 @@ double cache_read(Cache* cache, int addr, int pe_id) {
             
             // HIT: line in valid state (M, E, or S)
             if (state == M || state == E || state == S) {
-                double result = set->lines[i].data[offset];
+                copy_from_line(&set->lines[i], offset, out, count);
                 cache_update_lru(cache, set_index, i);
                 stats_record_read_hit(&cache->stats);
              LOGD("PE%d read hit: set=%d way=%d state=%c offset=%d value=%.2f", 
-                 pe_id, set_index, i, "MESI"[state], offset, result);
+                 pe_id, set_index, i, "MESI"[state], offset, out[0]);
                 pthread_mutex_unlock(&cache->mutex);
-                return result;
+                return;
             }
             
                 // Tag match but state I (invalidated line)
@@ -119,19 +265,30 @@ double cache_read(Cache* cache, int addr, int pe_id) {
     bus_broadcast(cache->bus, BUS_RD, block_base, pe_id);
     pthread_mutex_lock(&cache->mutex);
     
-    // Read the value from the fetched block
-    double result = victim->data[offset];
+    // Read the values from the fetched block
+    copy_from_line(victim, offset, out, count);
     cache_update_lru(cache, set_index, victim_way);
     LOGD("PE%d read complete: way=%d offset=%d value=%.2f state=%c", 
-        pe_id, victim_way, offset, result, "MESI"[victim->state]);
+        pe_id, victim_way, offset, out[0], "MESI"[victim->state]);
     pthread_mutex_unlock(&cache->mutex);
-    return result;
 }
 
 void cache_write(Cache* cache, int addr, double value, int pe_id) {
+    cache_write_span(cache, addr, &value, 1, pe_id);
+}
+
+void cache_write_span(Cache* cache, int addr, const double* values, int count, int pe_id) {
     // Compute block base address and offset within block
     int block_base = GET_BLOCK_BASE(addr);
     int offset = GET_BLOCK_OFFSET(addr);
+    count = clamp_span(offset, count, pe_id);
+    double value = values[0];  // First lane, for tracing
+    
+    if (cache->functional) {
+        cache_functional_write(cache, addr, values, count);
+        return;
+    }
+    block_stats_touch(pe_id, block_base, offset, count, true);
     
     // Log only when offset != 0 (unaligned address)
     if (offset != 0) {
@@ -153,7 +310,7 @@ void cache_write(Cache* cache, int addr, double value, int pe_id) {
             // Case 1: hit in M
             // Already have exclusive write permission
             if (state == M) {
-                set->lines[i].data[offset] = value;
+                copy_to_line(&set->lines[i], offset, values, count);
                 cache_update_lru(cache, set_index, i);
                 stats_record_write_hit(&cache->stats);
              LOGD("PE%d write hit: set=%d way=%d state=M offset=%d value=%.2f", 
@@ -164,10 +321,12 @@ void cache_write(Cache* cache, int addr, double value, int pe_id) {
             // Case 2: hit in E
             // We have the block exclusive but not modified; write and switch to M
             else if (state == E) {
-                set->lines[i].data[offset] = value;
+                copy_to_line(&set->lines[i], offset, values, count);
                 MESI_State old_state = set->lines[i].state;
                 set->lines[i].state = M;
                 stats_record_mesi_transition(&cache->stats, old_state, M);
+                TRACE_STATE(pe_id, block_base, old_state, M);
+                coherence_track(pe_id, block_base, M);
                 cache_update_lru(cache, set_index, i);
                 stats_record_write_hit(&cache->stats);
              LOGD("PE%d write hit: set=%d way=%d E->M offset=%d value=%.2f", 
@@ -179,21 +338,28 @@ void cache_write(Cache* cache, int addr, double value, int pe_id) {
             // We have a shared copy; we need exclusive permissions -> BUS_UPGR
             else if (state == S) {
                 stats_record_write_hit(&cache->stats);
-                cache->stats.bus_upgrades++;
+                stats_record_bus_upgrade(&cache->stats);
                 stats_record_invalidation_requested(&cache->stats);  // Request may cause invalidations
                  LOGD("PE%d write hit: set=%d way=%d S->M offset=%d BUS_UPGR value=%.2f", 
                  pe_id, set_index, i, offset, value);
                 
-                pthread_mutex_unlock(&cache->mutex);
-                bus_broadcast(cache->bus, BUS_UPGR, block_base, pe_id);
-                pthread_mutex_lock(&cache->mutex);
-                
-                set->lines[i].data[offset] = value;
-                MESI_State old_state = set->lines[i].state;
-                set->lines[i].state = M;
-                stats_record_mesi_transition(&cache->stats, old_state, M);
                 cache_update_lru(cache, set_index, i);
+                WriteCallbackContext ctx = {
+                    .offset = offset,
+                    .values = values,
+                    .count = count,
+                    .set_index = set_index,
+                    .victim_way = i,
+                    .pe_id = pe_id,
+                    .cache = cache,
+                    .block_base = block_base
+                };
                 pthread_mutex_unlock(&cache->mutex);
+                
+                // Handler invalidates the other copies (S->M recorded there),
+                // callback writes the values before the bus takes another request
+                bus_broadcast_with_callback(cache->bus, BUS_UPGR, block_base, pe_id,
+                                            upgrade_write_callback, &ctx);
                 return;
             }
             break;
@@ -220,7 +386,8 @@ void cache_write(Cache* cache, int addr, double value, int pe_id) {
     WriteCallbackContext ctx = {
         .victim = victim,
         .offset = offset,
-        .value = value,
+        .values = values,
+        .count = count,
         .set_index = set_index,
         .victim_way = victim_way,
         .pe_id = pe_id
@@ -239,6 +406,168 @@ void cache_write(Cache* cache, int addr, double value, int pe_id) {
     pthread_mutex_unlock(&cache->mutex);
 }
 
+// ATOMIC OPERATIONS
+
+int cache_atomic(Cache* cache, AtomicOp op, int addr, double operand, double expected,
+                 double* old, int pe_id) {
+    if (cache->functional) {
+        return cache_functional_atomic(cache, op, addr, operand, expected, old);
+    }
+    
+    int block_base = GET_BLOCK_BASE(addr);
+    block_stats_touch(pe_id, block_base, GET_BLOCK_OFFSET(addr), 1, false);
+    block_stats_touch(pe_id, block_base, GET_BLOCK_OFFSET(addr), 1, true);
+    
+    AtomicContext ctx = {
+        .cache = cache,
+        .op = op,
+        .block_base = block_base,
+        .offset = GET_BLOCK_OFFSET(addr),
+        .operand = operand,
+        .expected = expected,
+        .old = 0.0,
+        .success = 0
+    };
+    
+    pthread_mutex_lock(&cache->mutex);
+    stats_record_atomic(&cache->stats);
+    
+    // SC without a reservation fails locally, no bus traffic
+    if (op == ATOMIC_SC && !(cache->link_valid && cache->link_addr == block_base)) {
+        cache->link_valid = 0;
+        stats_record_atomic_failure(&cache->stats);
+        pthread_mutex_unlock(&cache->mutex);
+        if (old) *old = 0.0;
+        LOGD("PE%d SC fail: no reservation for 0x%X", pe_id, block_base);
+        return 0;
+    }
+    
+    int set_index = block_base % SETS;
+    unsigned long tag = block_base / SETS;
+    CacheSet* set = &cache->sets[set_index];
+    
+    for (int i = 0; i < WAYS; i++) {
+        if (set->lines[i].valid && set->lines[i].tag == tag) {
+            MESI_State state = set->lines[i].state;
+            
+            // Hit in M or E: already exclusive, update under the cache mutex
+            if (state == M || state == E) {
+                if (state == E) {
+                    set->lines[i].state = M;
+                    stats_record_mesi_transition(&cache->stats, E, M);
+                    TRACE_STATE(pe_id, block_base, E, M);
+                    coherence_track(pe_id, block_base, M);
+                }
+                atomic_apply(cache, &set->lines[i], &ctx);
+                cache_update_lru(cache, set_index, i);
+                stats_record_write_hit(&cache->stats);
+                pthread_mutex_unlock(&cache->mutex);
+                LOGD("PE%d atomic hit: state=%c old=%.2f success=%d", pe_id, "MESI"[state], ctx.old, ctx.success);
+                if (old) *old = ctx.old;
+                return ctx.success;
+            }
+            
+            // Hit in S: BUS_UPGR, update in the bus callback
+            if (state == S) {
+                stats_record_write_hit(&cache->stats);
+                stats_record_bus_upgrade(&cache->stats);
+                stats_record_invalidation_requested(&cache->stats);
+                cache_update_lru(cache, set_index, i);
+                pthread_mutex_unlock(&cache->mutex);
+                LOGD("PE%d atomic hit: state=S -> BUS_UPGR", pe_id);
+                bus_broadcast_with_callback(cache->bus, BUS_UPGR, block_base, pe_id,
+                                            atomic_callback, &ctx);
+                if (old) *old = ctx.old;
+                return ctx.success;
+            }
+            break;
+        }
+    }
+    
+    // MISS: BUS_RDX, update in the bus callback
+    stats_record_write_miss(&cache->stats);
+    stats_record_bus_traffic(&cache->stats, BLOCK_SIZE * sizeof(double), 0);
+    stats_record_invalidation_requested(&cache->stats);
+    LOGD("PE%d atomic miss: set=%d -> BUS_RDX", pe_id, set_index);
+    
+    CacheLine* victim = cache_select_victim(cache, set_index, pe_id);
+    int victim_way = victim - set->lines;
+    victim->valid = 1;
+    victim->tag = tag;
+    victim->state = I;
+    
+    pthread_mutex_unlock(&cache->mutex);
+    bus_broadcast_with_callback(cache->bus, BUS_RDX, block_base, pe_id,
+                                atomic_callback, &ctx);
+    
+    pthread_mutex_lock(&cache->mutex);
+    cache_update_lru(cache, set_index, victim_way);
+    pthread_mutex_unlock(&cache->mutex);
+    
+    if (old) *old = ctx.old;
+    return ctx.success;
+}
+
+double cache_load_linked(Cache* cache, int addr, int pe_id) {
+    // Reserve first: any invalidation seen after this point clears it,
+    // and the read below is ordered after any earlier write on the bus
+    pthread_mutex_lock(&cache->mutex);
+    cache->link_valid = 1;
+    cache->link_addr = GET_BLOCK_BASE(addr);
+    pthread_mutex_unlock(&cache->mutex);
+    
+    LOGD("PE%d LL: reservation on 0x%X", pe_id, GET_BLOCK_BASE(addr));
+    return cache_read(cache, addr, pe_id);
+}
+
+// MONITOR / MWAIT
+
+void cache_monitor(Cache* cache, int addr, int pe_id) {
+    // Arm first, as LL does: an invalidation after this point is not lost
+    pthread_mutex_lock(&cache->mutex);
+    cache->monitor_valid = 1;
+    cache->monitor_addr = GET_BLOCK_BASE(addr);
+    cache->monitor_triggered = 0;
+    pthread_mutex_unlock(&cache->mutex);
+    
+    LOGD("PE%d MONITOR: armed on 0x%X", pe_id, GET_BLOCK_BASE(addr));
+    // Only blocks present in this cache see the writer's invalidation
+    cache_read(cache, addr, pe_id);
+}
+
+int cache_mwait(Cache* cache, int pe_id) {
+    struct timespec t0, deadline;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    deadline = t0;
+    deadline.tv_nsec += (long)MWAIT_TIMEOUT_US * 1000L;
+    deadline.tv_sec += deadline.tv_nsec / 1000000000L;
+    deadline.tv_nsec %= 1000000000L;
+    
+    pthread_mutex_lock(&cache->mutex);
+    int timed_out = 0;
+    int slept = cache->monitor_valid && cache->mwait_enabled && !cache->monitor_triggered;
+    if (slept) {
+        while (!cache->monitor_triggered && !timed_out) {
+            timed_out = pthread_cond_timedwait(&cache->monitor_cond, &cache->mutex, &deadline) != 0;
+        }
+    }
+    int woken = cache->monitor_valid && cache->monitor_triggered;
+    cache->monitor_valid = 0;  // MWAIT consumes the monitor
+    
+    struct timespec t1;
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    uint64_t stall_ns = 0;
+    if (slept) {
+        stall_ns = (uint64_t)(t1.tv_sec - t0.tv_sec) * 1000000000ull
+                 + (uint64_t)(t1.tv_nsec - t0.tv_nsec);
+    }
+    stats_record_mwait(&cache->stats, stall_ns, slept && !woken);
+    pthread_mutex_unlock(&cache->mutex);
+    
+    LOGD("PE%d MWAIT: woken=%d timed_out=%d stall=%lu ns", pe_id, woken, timed_out, stall_ns);
+    return woken;
+}
+
 // Victim selection and replacement policy
 
 CacheLine* cache_select_victim(Cache* cache, int set_index, int pe_id) {
@@ -278,13 +607,27 @@ CacheLine* cache_select_victim(Cache* cache, int set_index, int pe_id) {
     LOGD("PE%d victim: way=0 (fallback)", pe_id);
     }
     
+    // Evicting a reserved or monitored block
+    if (victim->valid && victim->state != I) {
+        cache_lose_block(cache, (int)(victim->tag * SETS + set_index));
+    }
+    
     // Write back if the victim is in state M
     if (victim->state == M) {
         int victim_addr = (int)(victim->tag * SETS + set_index);
-        cache->stats.bus_writebacks++;
-        stats_record_bus_traffic(&cache->stats, 0, BLOCK_SIZE * sizeof(double));
+        stats_record_writeback(&cache->stats);
         LOGD("PE%d eviction: line M addr=0x%X -> BUS_WB", pe_id, victim_addr);
+        // The caller holds the cache mutex, which the BUS_WB handler needs:
+        // release it for the transaction. Snoops may only downgrade the
+        // victim meanwhile; its tag is replaced by the caller afterwards.
+        pthread_mutex_unlock(&cache->mutex);
         bus_broadcast(cache->bus, BUS_WB, victim_addr, pe_id);
+        pthread_mutex_lock(&cache->mutex);
+    }
+    
+    // A clean victim (E or S) is dropped silently: the caller replaces its tag
+    if (victim->valid && victim->state != I) {
+        coherence_track(pe_id, (int)(victim->tag * SETS + set_index), I);
     }
     
     return victim;
@@ -317,26 +660,54 @@ MESI_State cache_get_state(Cache* cache, int addr) {
     return state;
 }
 
+// Must be called with the mutex held
+static void cache_transition(Cache* cache, CacheLine* line, int addr, MESI_State new_state) {
+    MESI_State old_state = line->state;
+    line->state = new_state;
+    
+    // Record transition in statistics
+    if (old_state != new_state) {
+        stats_record_mesi_transition(&cache->stats, old_state, new_state);
+        TRACE_STATE(cache->pe_id, GET_BLOCK_BASE(addr), old_state, new_state);
+        coherence_track(cache->pe_id, GET_BLOCK_BASE(addr), new_state);
+    }
+    
+    // Record invalidation if changed from a valid state to I
+    if (new_state == I && old_state != I) {
+        stats_record_invalidation_received(&cache->stats);
+    }
+    
+    // Losing the line breaks the LL/SC link and fires the monitor
+    if (new_state == I) {
+        cache_lose_block(cache, addr);
+    }
+}
+
 void cache_set_state(Cache* cache, int addr, MESI_State new_state) {
     pthread_mutex_lock(&cache->mutex);
     CacheLine* line = cache_get_line(cache, addr);
     
     if (line) {
-        MESI_State old_state = line->state;
-        line->state = new_state;
-        
-        // Record transition in statistics
-        if (old_state != new_state) {
-            stats_record_mesi_transition(&cache->stats, old_state, new_state);
-        }
-        
-        // Record invalidation if changed from a valid state to I
-        if (new_state == I && old_state != I) {
-            stats_record_invalidation_received(&cache->stats);
-        }
+        cache_transition(cache, line, addr, new_state);
+    }
+    
+    pthread_mutex_unlock(&cache->mutex);
+}
+
+MESI_State cache_snoop(Cache* cache, int addr, MESI_State new_state, double block[BLOCK_SIZE]) {
+    pthread_mutex_lock(&cache->mutex);
+    CacheLine* line = cache_get_line(cache, addr);
+    MESI_State old_state = line ? line->state : I;
+    
+    for (int i = 0; i < BLOCK_SIZE; i++) {
+        block[i] = old_state != I ? line->data[i] : 0.0;
+    }
+    if (old_state != I) {
+        cache_transition(cache, line, addr, new_state);
     }
     
     pthread_mutex_unlock(&cache->mutex);
+    return old_state;
 }
 
 void cache_get_block(Cache* cache, int addr, double block[BLOCK_SIZE]) {
@@ -398,8 +769,7 @@ void cache_flush(Cache* cache, int pe_id) {
     // Write back all modified blocks
     for (int i = 0; i < count; i++) {
         // Record per-PE writeback stats and data bytes
-        cache->stats.bus_writebacks++;
-        stats_record_bus_traffic(&cache->stats, 0, BLOCK_SIZE * sizeof(double));
+        stats_record_writeback(&cache->stats);
         bus_broadcast(cache->bus, BUS_WB, modified_blocks[i], pe_id);
     }
     
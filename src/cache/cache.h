@@ -3,6 +3,7 @@
 
 #include "config.h"
 #include "cache_stats.h"
+#include "icache.h"
 #include <pthread.h>
 
 // FORWARD DECLARATIONS
@@ -39,10 +40,30 @@ typedef struct {
     Bus* bus;                   // Reference to shared bus
     CacheSet sets[SETS];        // Array of sets
     pthread_mutex_t mutex;      // Synchronization mutex
-    CacheStats stats;           // Access statistics
+    CacheStatsShards stats;     // Access statistics (PE and bus shards)
     int pe_id;                  // Owning PE id
+    int link_valid;             // LL/SC reservation active
+    int link_addr;              // Block base of the LL/SC reservation
+    int monitor_valid;          // MONITOR armed
+    int monitor_addr;           // Block base being monitored
+    int monitor_triggered;      // Monitored block invalidated/evicted since MONITOR
+    int mwait_enabled;          // 0: MWAIT returns at once (plain polling)
+    pthread_cond_t monitor_cond; // Signaled when the monitor triggers
+    ICache icache;              // Private instruction cache
+    int functional;             // Fast-forward: accesses bypass the bus (functional.c)
+    int functional_warm;        // Fast-forward: misses still install the tag
 } Cache;
 
+/**
+ * Atomic read-modify-write operations
+ * Executed in the cache with the line held in M (exclusive ownership)
+ */
+typedef enum {
+    ATOMIC_FAA,   // Fetch-and-add: mem += operand
+    ATOMIC_CAS,   // Compare-and-swap: if mem == expected then mem = operand
+    ATOMIC_SC     // Store-conditional: mem = operand if the LL reservation holds
+} AtomicOp;
+
 // PUBLIC API
 
 // Init and cleanup
@@ -53,7 +74,32 @@ void cache_destroy(Cache* cache);
 double cache_read(Cache* cache, int addr, int pe_id);
 void cache_write(Cache* cache, int addr, double value, int pe_id);
 
+// Multi-word access inside one block (one cache access, counts as one hit/miss)
+// addr + count must not cross the end of the block of addr
+void cache_read_span(Cache* cache, int addr, double* out, int count, int pe_id);
+void cache_write_span(Cache* cache, int addr, const double* values, int count, int pe_id);
+
+// Atomic operations (return 1 on success; *old receives the previous value)
+// FAA always succeeds; CAS/SC fail without modifying memory
+int cache_atomic(Cache* cache, AtomicOp op, int addr, double operand, double expected,
+                 double* old, int pe_id);
+double cache_load_linked(Cache* cache, int addr, int pe_id);
+
+// MONITOR/MWAIT: arm a monitor on the block of addr (and bring it into the
+// cache), then sleep until another PE's write invalidates it or it is evicted.
+// MWAIT returns at once if the monitor already triggered; the sleep is bounded
+// by MWAIT_TIMEOUT_US. Returns 1 if woken by the monitor, 0 otherwise.
+void cache_monitor(Cache* cache, int addr, int pe_id);
+int cache_mwait(Cache* cache, int pe_id);
+
+// Instruction fetch of the code word at code_addr through the I-cache.
+// A miss issues BUS_IFETCH (no snooping) and waits like a data miss.
+void cache_fetch(Cache* cache, int code_addr, int pe_id);
+
 // Replacement policy
+// An M victim is written back with BUS_WB, and the caller's cache mutex is
+// released around that transaction: callers must not keep pointers or state
+// read from the cache across the call other than the returned victim.
 CacheLine* cache_select_victim(Cache* cache, int set_index, int pe_id);
 
 // MESI coherence operations
@@ -61,6 +107,15 @@ CacheLine* cache_get_line(Cache* cache, int addr);
 MESI_State cache_get_state(Cache* cache, int addr);
 void cache_set_state(Cache* cache, int addr, MESI_State new_state);
 
+// Snoop: copy the block and move it to new_state under one lock, so a write
+// hit of the owner cannot land between the copy and the downgrade.
+// Returns the state the line had (I: not present, block filled with zeros).
+MESI_State cache_snoop(Cache* cache, int addr, MESI_State new_state, double block[BLOCK_SIZE]);
+
+// LRU and link/monitor helpers (cache mutex must be held)
+void cache_update_lru(Cache* cache, int set_index, int accessed_way);
+void cache_lose_block(Cache* cache, int block_base);
+
 // Block operations
 void cache_get_block(Cache* cache, int addr, double block[BLOCK_SIZE]);
 void cache_set_block(Cache* cache, int addr, const double block[BLOCK_SIZE]);
@@ -68,4 +123,19 @@ void cache_set_block(Cache* cache, int addr, const double block[BLOCK_SIZE]);
 // Flush
 void cache_flush(Cache* cache, int pe_id);
 
+// FUNCTIONAL MODE (fast-forward, see functional.c)
+// While cache->functional is set, reads, writes and atomics go straight to
+// main memory under one global lock: no bus, no statistics, no MESI events.
+// Memory stays authoritative (no line is ever in M) and a write invalidates
+// the other copies, so the detailed model resumes without any fix-up.
+// Entering the mode writes M lines back to memory and leaves them in E.
+// Only call at a quantum barrier, when no PE has a bus request in flight.
+void cache_set_functional(Cache* cache, int functional, int warm);
+
+// Called by the regular entry points while cache->functional is set
+void cache_functional_read(Cache* cache, int addr, double* out, int count);
+void cache_functional_write(Cache* cache, int addr, const double* values, int count);
+int cache_functional_atomic(Cache* cache, AtomicOp op, int addr, double operand,
+                            double expected, double* old);
+
 #endif
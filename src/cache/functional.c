@@ -0,0 +1,189 @@
+#define LOG_MODULE "CACHE"
+#include "cache.h"
+#include "bus.h"
+#include "memory.h"
+#include "coherence_check.h"
+#include "log.h"
+
+// Functional accesses run one at a time: the memory word and every copy of
+// its block change together, as a bus transaction would. Lock order:
+// func_mutex first, then the cache mutexes one at a time.
+static pthread_mutex_t func_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+static double* memory_block(Cache* cache, int block_base) {
+    return &cache->bus->memory->data[block_base];
+}
+
+// Valid copy of the block in this cache (E or S), or NULL. Cache mutex held.
+static CacheLine* present_line(Cache* cache, int block_base) {
+    CacheLine* line = cache_get_line(cache, block_base);
+    return (line && line->state != I) ? line : NULL;
+}
+
+static void touch_line(Cache* cache, int block_base, CacheLine* line) {
+    int set_index = block_base % SETS;
+    cache_update_lru(cache, set_index, (int)(line - cache->sets[set_index].lines));
+}
+
+// Install the block clean in this cache. There is no M line in functional
+// mode, so the victim never needs a BUS_WB. Cache mutex held.
+static void warm_line(Cache* cache, int block_base, MESI_State state) {
+    int set_index = block_base % SETS;
+    CacheLine* line = cache_get_line(cache, block_base);
+    if (!line) {
+        line = cache_select_victim(cache, set_index, cache->pe_id);
+        line->valid = 1;
+        line->tag = block_base / SETS;
+    }
+    line->state = state;
+    const double* mem = memory_block(cache, block_base);
+    for (int k = 0; k < BLOCK_SIZE; k++) {
+        line->data[k] = mem[k];
+    }
+    touch_line(cache, block_base, line);
+}
+
+// Another reader appears: E copies elsewhere become S.
+// Returns 1 if any other cache holds the block.
+static int share_block(Cache* cache, int block_base) {
+    int shared = 0;
+    for (int i = 0; i < NUM_PES; i++) {
+        Cache* other = cache->bus->caches[i];
+        if (other == cache) continue;
+        pthread_mutex_lock(&other->mutex);
+        CacheLine* line = present_line(other, block_base);
+        if (line) {
+            shared = 1;
+            if (line->state == E) line->state = S;
+        }
+        pthread_mutex_unlock(&other->mutex);
+    }
+    return shared;
+}
+
+// A write removes every other copy, breaks their LL/SC links and fires their monitors
+static void invalidate_others(Cache* cache, int block_base) {
+    for (int i = 0; i < NUM_PES; i++) {
+        Cache* other = cache->bus->caches[i];
+        if (other == cache) continue;
+        pthread_mutex_lock(&other->mutex);
+        CacheLine* line = present_line(other, block_base);
+        if (line) line->state = I;
+        cache_lose_block(other, block_base);
+        pthread_mutex_unlock(&other->mutex);
+    }
+}
+
+// func_mutex held
+static void write_locked(Cache* cache, int addr, const double* values, int count) {
+    int block_base = GET_BLOCK_BASE(addr);
+    int offset = GET_BLOCK_OFFSET(addr);
+    double* mem = memory_block(cache, block_base);
+    for (int k = 0; k < count; k++) {
+        mem[offset + k] = values[k];
+    }
+
+    invalidate_others(cache, block_base);
+
+    // The writer's own copy stays clean: memory already has the data
+    pthread_mutex_lock(&cache->mutex);
+    CacheLine* line = present_line(cache, block_base);
+    if (line || cache->functional_warm) {
+        warm_line(cache, block_base, E);
+    }
+    pthread_mutex_unlock(&cache->mutex);
+}
+
+// MODE SWITCH
+
+void cache_set_functional(Cache* cache, int functional, int warm) {
+    pthread_mutex_lock(&cache->mutex);
+    if (functional && !cache->functional) {
+        // Memory becomes authoritative: M lines are written back without a
+        // bus transaction (and without statistics) and stay as E
+        for (int set = 0; set < SETS; set++) {
+            for (int way = 0; way < WAYS; way++) {
+                CacheLine* line = &cache->sets[set].lines[way];
+                if (!line->valid || line->state != M) continue;
+                double* mem = memory_block(cache, (int)(line->tag * SETS + set));
+                for (int k = 0; k < BLOCK_SIZE; k++) {
+                    mem[k] = line->data[k];
+                }
+                line->state = E;
+            }
+        }
+    }
+    if (!functional && cache->functional) {
+        // States changed here without bookkeeping: rebuild this PE's shadow
+        coherence_resync(cache);
+    }
+    cache->functional = functional;
+    cache->functional_warm = warm;
+    pthread_mutex_unlock(&cache->mutex);
+}
+
+// ACCESSES
+
+void cache_functional_read(Cache* cache, int addr, double* out, int count) {
+    int block_base = GET_BLOCK_BASE(addr);
+    int offset = GET_BLOCK_OFFSET(addr);
+
+    pthread_mutex_lock(&func_mutex);
+    const double* mem = memory_block(cache, block_base);
+    for (int k = 0; k < count; k++) {
+        out[k] = mem[offset + k];
+    }
+
+    if (cache->functional_warm) {
+        pthread_mutex_lock(&cache->mutex);
+        CacheLine* line = present_line(cache, block_base);
+        if (line) touch_line(cache, block_base, line);
+        pthread_mutex_unlock(&cache->mutex);
+
+        if (!line) {
+            // E only if no other cache has the block, as BUS_RD would grant
+            MESI_State state = share_block(cache, block_base) ? S : E;
+            pthread_mutex_lock(&cache->mutex);
+            warm_line(cache, block_base, state);
+            pthread_mutex_unlock(&cache->mutex);
+        }
+    }
+    pthread_mutex_unlock(&func_mutex);
+}
+
+void cache_functional_write(Cache* cache, int addr, const double* values, int count) {
+    pthread_mutex_lock(&func_mutex);
+    write_locked(cache, addr, values, count);
+    pthread_mutex_unlock(&func_mutex);
+}
+
+int cache_functional_atomic(Cache* cache, AtomicOp op, int addr, double operand,
+                            double expected, double* old) {
+    int block_base = GET_BLOCK_BASE(addr);
+
+    pthread_mutex_lock(&func_mutex);
+    double value = memory_block(cache, block_base)[GET_BLOCK_OFFSET(addr)];
+    int success = 0;
+    switch (op) {
+        case ATOMIC_FAA:
+            success = 1;
+            operand = value + operand;
+            break;
+        case ATOMIC_CAS:
+            success = (value == expected);
+            break;
+        case ATOMIC_SC:
+            pthread_mutex_lock(&cache->mutex);
+            success = cache->link_valid && cache->link_addr == block_base;
+            cache->link_valid = 0;
+            pthread_mutex_unlock(&cache->mutex);
+            break;
+    }
+    if (success) {
+        write_locked(cache, addr, &operand, 1);
+    }
+    pthread_mutex_unlock(&func_mutex);
+
+    if (old) *old = value;
+    return success;
+}
@@ -0,0 +1,78 @@
+#define LOG_MODULE "ICACHE"
+#include "icache.h"
+#include "cache.h"
+#include "bus.h"
+#include <string.h>
+#include "log.h"
+
+// PRIVATE STRUCTURES
+
+typedef struct {
+    ICacheLine* line;
+    unsigned long tag;
+    uint64_t tick;
+} IFetchContext;
+
+// Runs in the bus thread once the block has been read from memory
+static void ifetch_callback(void* context) {
+    IFetchContext* ctx = (IFetchContext*)context;
+    ctx->line->tag = ctx->tag;
+    ctx->line->valid = 1;
+    ctx->line->last_use = ctx->tick;
+}
+
+// INIT
+
+void icache_init(ICache* icache) {
+    memset(icache->sets, 0, sizeof(icache->sets));
+    icache->tick = 0;
+    icache->enabled = 1;
+}
+
+// FETCH
+
+void cache_fetch(Cache* cache, int code_addr, int pe_id) {
+    ICache* icache = &cache->icache;
+    if (!icache->enabled) {
+        return;
+    }
+
+    int block_base = GET_BLOCK_BASE(code_addr);
+    int block_num = block_base / BLOCK_SIZE;
+    int set_index = block_num % ICACHE_SETS;
+    unsigned long tag = (unsigned long)(block_num / ICACHE_SETS);
+    ICacheLine* set = icache->sets[set_index];
+
+    icache->tick++;
+    ICacheLine* victim = &set[0];
+    for (int i = 0; i < ICACHE_WAYS; i++) {
+        if (set[i].valid && set[i].tag == tag) {
+            set[i].last_use = icache->tick;
+            if (!cache->functional) {
+                stats_record_ifetch(&cache->stats, 0);
+            }
+            return;
+        }
+        // Prefer an empty way, otherwise the least recently used one
+        if (victim->valid && (!set[i].valid || set[i].last_use < victim->last_use)) {
+            victim = &set[i];
+        }
+    }
+
+    // Fast-forward: no BUS_IFETCH, the tag is installed directly when warming
+    if (cache->functional) {
+        if (cache->functional_warm) {
+            victim->tag = tag;
+            victim->valid = 1;
+            victim->last_use = icache->tick;
+        }
+        return;
+    }
+
+    // Miss: read the code block over the shared bus (competes with data traffic)
+    stats_record_ifetch(&cache->stats, 1);
+    LOGD("PE%d I-fetch miss: addr=0x%X block=0x%X set=%d", pe_id, code_addr, block_base, set_index);
+
+    IFetchContext ctx = { victim, tag, icache->tick };
+    bus_broadcast_with_callback(cache->bus, BUS_IFETCH, block_base, pe_id, ifetch_callback, &ctx);
+}
@@ -0,0 +1,31 @@
+#ifndef ICACHE_H
+#define ICACHE_H
+
+#include "config.h"
+#include <stdint.h>
+
+/**
+ * Instruction cache line
+ * Only the tag is kept: instructions are already decoded in the Program,
+ * the line records which code block of CODE_REGION is resident.
+ */
+typedef struct {
+    unsigned long tag;          // Code block tag
+    int valid;                  // 1 = valid, 0 = invalid
+    uint64_t last_use;          // Fetch counter value at last use (LRU)
+} ICacheLine;
+
+/**
+ * Private L1 instruction cache (read-only, not coherent)
+ * Only touched by the owning PE thread, and by the bus thread while that
+ * PE is blocked on its fetch miss, so it needs no mutex.
+ */
+typedef struct {
+    ICacheLine sets[ICACHE_SETS][ICACHE_WAYS];
+    uint64_t tick;              // Fetches seen (LRU clock)
+    int enabled;                // 0: instruction fetch is free (SIM_ICACHE=0)
+} ICache;
+
+void icache_init(ICache* icache);
+
+#endif
@@ -0,0 +1,349 @@
+#define LOG_MODULE "CKPT"
+#include "checkpoint.h"
+#include "program_image.h"
+#include "memtrace.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include "log.h"
+
+bool checkpoint_pending = false;
+
+static const char* SAVE_PATH;
+static const char* RESTORE_PATH;
+static uint64_t SAVE_AT;             // Instructions retired before the snapshot
+
+static Memory* MEM;
+static Bus* BUS;
+static Cache* CACHES;
+static PE* PES;
+
+// Raw structs copied as-is: a build with a different layout must not load them
+#define LAYOUT_SIZE (sizeof(CheckpointPE) + sizeof(CacheLine) + sizeof(ICache) + \
+                     sizeof(CacheStatsShards) + sizeof(MemoryStats) + sizeof(BusStats) + sizeof(SchedStats) + \
+                     sizeof(BlockStats) + sizeof(BusLatencyStats))
+
+// FILE I/O
+
+typedef struct {
+    FILE* file;
+    int ok;
+} Stream;
+
+static void put(Stream* s, const void* data, size_t size) {
+    if (s->ok && fwrite(data, size, 1, s->file) != 1) {
+        s->ok = 0;
+    }
+}
+
+static void get(Stream* s, void* data, size_t size) {
+    if (s->ok && fread(data, size, 1, s->file) != 1) {
+        s->ok = 0;
+    }
+}
+
+// HEADER
+
+static void kernel_name(char out[16]) {
+    const char* env_kernel = getenv("SIM_KERNEL");
+    memset(out, 0, 16);
+    if (env_kernel) {
+        strncpy(out, env_kernel, 15);
+    }
+}
+
+// Hash of every PE's ASM source (0 if it cannot be read)
+static void program_hashes(uint64_t hashes[NUM_PES]) {
+    for (int i = 0; i < NUM_PES; i++) {
+        char path[256];
+        pe_program_path(i, path, sizeof(path));
+        if (program_source_hash(path, &hashes[i]) != 0) {
+            hashes[i] = 0;
+        }
+    }
+}
+
+static void fill_header(CheckpointHeader* header) {
+    memset(header, 0, sizeof(*header));
+    memcpy(header->magic, CHECKPOINT_MAGIC, sizeof(CHECKPOINT_MAGIC));
+    header->version = CHECKPOINT_VERSION;
+    header->num_pes = NUM_PES;
+    header->sets = SETS;
+    header->ways = WAYS;
+    header->block_size = BLOCK_SIZE;
+    header->mem_size = MEM_SIZE;
+    header->icache_sets = ICACHE_SETS;
+    header->icache_ways = ICACHE_WAYS;
+    header->layout_size = (uint32_t)LAYOUT_SIZE;
+    kernel_name(header->kernel);
+    program_hashes(header->prog_hash);
+}
+
+// Reason the saved header does not match this build and run, or NULL
+static const char* header_mismatch(const CheckpointHeader* saved) {
+    CheckpointHeader current;
+    fill_header(&current);
+
+    if (memcmp(saved->magic, CHECKPOINT_MAGIC, sizeof(CHECKPOINT_MAGIC)) != 0) return "bad magic";
+    if (saved->version != CHECKPOINT_VERSION) return "version mismatch";
+    if (saved->num_pes != current.num_pes || saved->sets != current.sets ||
+        saved->ways != current.ways || saved->block_size != current.block_size ||
+        saved->mem_size != current.mem_size || saved->icache_sets != current.icache_sets ||
+        saved->icache_ways != current.icache_ways) return "different architecture parameters";
+    if (saved->layout_size != current.layout_size) return "different struct layout";
+    if (memcmp(saved->kernel, current.kernel, sizeof(current.kernel)) != 0) return "different SIM_KERNEL";
+    if (memcmp(saved->prog_hash, current.prog_hash, sizeof(current.prog_hash)) != 0) return "ASM programs changed";
+    return NULL;
+}
+
+// INIT
+
+int checkpoint_init(void) {
+    const char* save = getenv("SIM_CHECKPOINT");
+    const char* restore = getenv("SIM_RESTORE");
+    SAVE_PATH = (save && *save) ? save : NULL;
+    RESTORE_PATH = (restore && *restore) ? restore : NULL;
+
+    if ((SAVE_PATH || RESTORE_PATH) && memtrace_dir()) {
+        LOGE("SIM_CHECKPOINT/SIM_RESTORE are not supported with SIM_MEMTRACE");
+        return -1;
+    }
+
+    const char* env_at = getenv("SIM_CHECKPOINT_AT");
+    SAVE_AT = env_at ? strtoull(env_at, NULL, 0) : 0;
+    checkpoint_pending = SAVE_PATH != NULL;
+    return 0;
+}
+
+void checkpoint_register(Memory* mem, Bus* bus, Cache* caches, PE* pes, Scheduler* sched) {
+    MEM = mem;
+    BUS = bus;
+    CACHES = caches;
+    PES = pes;
+
+    if (checkpoint_pending && sched->mode != SCHED_QUANTUM) {
+        LOGW("SIM_CHECKPOINT needs quantum barriers (SIM_SCHED=quantum), not taken");
+        checkpoint_pending = false;
+    }
+}
+
+bool checkpoint_restoring(void) {
+    return RESTORE_PATH != NULL;
+}
+
+// SAVE
+
+static void save_cache(Stream* s, Cache* cache, const PE* pe) {
+    pthread_mutex_lock(&cache->mutex);
+
+    CheckpointPE state;
+    memset(&state, 0, sizeof(state));
+    state.rf = pe->rf;
+    state.iterations = pe->iterations;
+    state.finished = pe->finished;
+    state.link_valid = cache->link_valid;
+    state.link_addr = cache->link_addr;
+    state.monitor_valid = cache->monitor_valid;
+    state.monitor_addr = cache->monitor_addr;
+    state.monitor_triggered = cache->monitor_triggered;
+    put(s, &state, sizeof(state));
+    put(s, &cache->stats, sizeof(cache->stats));
+    put(s, &cache->icache, sizeof(cache->icache));
+
+    // Only valid lines: most of a cold or small working set is empty
+    uint32_t valid = 0;
+    for (int set = 0; set < SETS; set++) {
+        for (int way = 0; way < WAYS; way++) {
+            valid += cache->sets[set].lines[way].valid ? 1 : 0;
+        }
+    }
+    put(s, &valid, sizeof(valid));
+    for (uint16_t set = 0; set < SETS; set++) {
+        for (uint16_t way = 0; way < WAYS; way++) {
+            const CacheLine* line = &cache->sets[set].lines[way];
+            if (!line->valid) continue;
+            put(s, &set, sizeof(set));
+            put(s, &way, sizeof(way));
+            put(s, line, sizeof(*line));
+        }
+    }
+
+    pthread_mutex_unlock(&cache->mutex);
+}
+
+static int save(Scheduler* sched, uint64_t instructions) {
+    CheckpointHeader header;
+    fill_header(&header);
+    header.epoch = sched->epoch;
+    header.instructions = instructions;
+
+    // Unique temporary name, then rename(): a crash never leaves half a checkpoint
+    char tmp_path[512];
+    snprintf(tmp_path, sizeof(tmp_path), "%s.XXXXXX", SAVE_PATH);
+    int fd = mkstemp(tmp_path);
+    if (fd < 0) {
+        LOGE("Could not create %s: %s", tmp_path, strerror(errno));
+        return -1;
+    }
+    fchmod(fd, 0644);  // mkstemp creates 0600
+
+    Stream s = { fdopen(fd, "wb"), 1 };
+    if (!s.file) {
+        close(fd);
+        unlink(tmp_path);
+        return -1;
+    }
+
+    put(&s, &header, sizeof(header));
+
+    pthread_mutex_lock(&MEM->mutex);
+    put(&s, MEM->data, sizeof(MEM->data));
+    put(&s, &MEM->stats, sizeof(MEM->stats));
+    pthread_mutex_unlock(&MEM->mutex);
+
+    pthread_mutex_lock(&BUS->mutex);
+    int32_t next_pe = BUS->next_pe;
+    put(&s, &next_pe, sizeof(next_pe));
+    put(&s, &BUS->stats, sizeof(BUS->stats));
+    put(&s, &BUS->latency, sizeof(BUS->latency));
+    pthread_mutex_unlock(&BUS->mutex);
+
+    for (int i = 0; i < NUM_PES; i++) {
+        save_cache(&s, &CACHES[i], &PES[i]);
+    }
+
+    put(&s, &sched->stats, sizeof(sched->stats));
+
+    // Absent if the table could not be allocated (tracking off)
+    uint32_t has_blocks = block_stats != NULL;
+    put(&s, &has_blocks, sizeof(has_blocks));
+    if (has_blocks) {
+        put(&s, block_stats, sizeof(*block_stats));
+    }
+
+    s.ok = (fclose(s.file) == 0) && s.ok;
+    if (!s.ok || rename(tmp_path, SAVE_PATH) != 0) {
+        LOGE("Could not write checkpoint %s", SAVE_PATH);
+        unlink(tmp_path);
+        return -1;
+    }
+    return 0;
+}
+
+void checkpoint_at_barrier(Scheduler* sched) {
+    uint64_t instructions = sched_stats_instructions(&sched->stats);
+    if (instructions < SAVE_AT) {
+        return;
+    }
+
+    checkpoint_pending = false;
+    if (save(sched, instructions) == 0) {
+        LOGI("Checkpoint written to %s (epoch=%lu instructions=%lu)", SAVE_PATH,
+             (unsigned long)sched->epoch, (unsigned long)instructions);
+    }
+}
+
+void checkpoint_finish(void) {
+    if (checkpoint_pending) {
+        LOGW("No quantum barrier reached SIM_CHECKPOINT_AT=%lu, checkpoint not written",
+             (unsigned long)SAVE_AT);
+        checkpoint_pending = false;
+    }
+}
+
+// RESTORE
+
+static void restore_cache(Stream* s, Cache* cache, PE* pe) {
+    CheckpointPE state;
+    get(s, &state, sizeof(state));
+    get(s, &cache->stats, sizeof(cache->stats));
+    get(s, &cache->icache, sizeof(cache->icache));
+
+    pe->rf = state.rf;
+    pe->iterations = state.iterations;
+    pe->finished = state.finished;
+    cache->link_valid = state.link_valid;
+    cache->link_addr = state.link_addr;
+    cache->monitor_valid = state.monitor_valid;
+    cache->monitor_addr = state.monitor_addr;
+    cache->monitor_triggered = state.monitor_triggered;
+
+    uint32_t valid = 0;
+    get(s, &valid, sizeof(valid));
+    for (uint32_t i = 0; i < valid && s->ok; i++) {
+        uint16_t set, way;
+        get(s, &set, sizeof(set));
+        get(s, &way, sizeof(way));
+        if (s->ok && (set >= SETS || way >= WAYS)) {
+            s->ok = 0;
+            break;
+        }
+        get(s, &cache->sets[set].lines[way], sizeof(CacheLine));
+    }
+}
+
+int checkpoint_restore(void) {
+    Stream s = { fopen(RESTORE_PATH, "rb"), 1 };
+    if (!s.file) {
+        LOGE("Could not open checkpoint %s: %s", RESTORE_PATH, strerror(errno));
+        return -1;
+    }
+
+    CheckpointHeader header;
+    get(&s, &header, sizeof(header));
+    const char* reason = s.ok ? header_mismatch(&header) : "truncated";
+    if (reason) {
+        LOGE("Cannot restore %s: %s", RESTORE_PATH, reason);
+        fclose(s.file);
+        return -1;
+    }
+
+    // No PE thread runs yet; the bus and memory threads are idle
+    get(&s, MEM->data, sizeof(MEM->data));
+    get(&s, &MEM->stats, sizeof(MEM->stats));
+
+    int32_t next_pe = 0;
+    get(&s, &next_pe, sizeof(next_pe));
+    BUS->next_pe = next_pe % NUM_PES;
+    get(&s, &BUS->stats, sizeof(BUS->stats));
+    get(&s, &BUS->latency, sizeof(BUS->latency));
+
+    for (int i = 0; i < NUM_PES; i++) {
+        restore_cache(&s, &CACHES[i], &PES[i]);
+    }
+
+    // Counters continue from the checkpoint; host time is measured from this run
+    Scheduler* sched = PES[0].sched;
+    SchedStats saved;
+    get(&s, &saved, sizeof(saved));
+    saved.start_ns = sched->stats.start_ns;
+    saved.end_ns = 0;
+    for (int i = 0; i < NUM_PES; i++) {
+        saved.pe[i].wait_ns = 0;
+        saved.pe[i].cpu = (HostCpu){ 0, 0 };
+    }
+
+    // A table this run cannot hold is skipped
+    uint32_t has_blocks = 0;
+    get(&s, &has_blocks, sizeof(has_blocks));
+    if (has_blocks && block_stats) {
+        get(&s, block_stats, sizeof(*block_stats));
+    } else if (has_blocks && s.ok && fseek(s.file, sizeof(BlockStats), SEEK_CUR) != 0) {
+        s.ok = 0;
+    }
+
+    fclose(s.file);
+    if (!s.ok) {
+        LOGE("Cannot restore %s: truncated", RESTORE_PATH);
+        return -1;
+    }
+
+    sched->stats = saved;
+    sched->epoch = header.epoch;
+    LOGI("Restored %s (epoch=%lu instructions=%lu)", RESTORE_PATH,
+         (unsigned long)header.epoch, (unsigned long)header.instructions);
+    return 0;
+}
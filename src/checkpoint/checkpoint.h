@@ -0,0 +1,107 @@
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "config.h"
+#include "bus.h"
+#include "cache.h"
+#include "memory.h"
+#include "pe.h"
+#include "scheduler.h"
+#include "block_stats.h"
+
+/**
+ * @file checkpoint.h
+ * @brief Checkpoint y restauración del estado completo del simulador
+ *
+ * SIM_CHECKPOINT=<archivo> guarda una foto en la primera barrera de quantum
+ * en la que los PEs llevan al menos SIM_CHECKPOINT_AT instrucciones retiradas
+ * (por defecto 0: la primera barrera). En una barrera todos los PEs activos
+ * están esperando y ninguno tiene una transacción de bus en curso; si algún
+ * PE duerme en MWAIT la foto se pospone a la siguiente barrera. La ejecución
+ * continúa normalmente después de guardar.
+ *
+ * SIM_RESTORE=<archivo> arranca desde la foto en lugar de dotprod_init_data.
+ * Requiere la misma geometría (NUM_PES, SETS, WAYS, ...), el mismo
+ * SIM_KERNEL y los mismos programas ASM con los que se guardó.
+ *
+ *   cabecera CheckpointHeader
+ *   memoria: double[MEM_SIZE] | MemoryStats
+ *   bus:     next_pe (int32) | BusStats | BusLatencyStats
+ *   por PE:  CheckpointPE | CacheStatsShards | ICache | n líneas válidas (uint32) |
+ *            n x (set uint16, way uint16, CacheLine)
+ *   planificador: SchedStats (sin los tiempos de host)
+ *   bloques: presente (uint32) | BlockStats si presente
+ *
+ * Solo con SIM_SCHED=quantum (el modo yield no tiene barreras) y sin SIM_MEMTRACE.
+ */
+
+#define CHECKPOINT_MAGIC   "MPCKPT"
+#define CHECKPOINT_VERSION 4
+
+typedef struct {
+    char magic[8];              // CHECKPOINT_MAGIC
+    uint32_t version;           // CHECKPOINT_VERSION
+    uint32_t num_pes;
+    uint32_t sets;
+    uint32_t ways;
+    uint32_t block_size;
+    uint32_t mem_size;
+    uint32_t icache_sets;
+    uint32_t icache_ways;
+    uint32_t layout_size;       // Sum of the sizes of the raw structs (layout check)
+    char kernel[16];            // SIM_KERNEL when saved ("" = scalar)
+    uint64_t prog_hash[NUM_PES]; // FNV-1a of each PE's ASM source
+    uint64_t epoch;             // Scheduler epoch of the barrier
+    uint64_t instructions;      // Instructions retired by all PEs
+} CheckpointHeader;
+
+// Per-PE architectural state saved next to its cache
+typedef struct {
+    RegisterFile rf;
+    int32_t iterations;
+    int32_t finished;
+    int32_t link_valid;
+    int32_t link_addr;
+    int32_t monitor_valid;
+    int32_t monitor_addr;
+    int32_t monitor_triggered;
+    int32_t reserved;
+} CheckpointPE;
+
+// true while SIM_CHECKPOINT is set and the snapshot has not been written yet
+extern bool checkpoint_pending;
+
+/**
+ * @brief Lee SIM_CHECKPOINT, SIM_CHECKPOINT_AT y SIM_RESTORE
+ * @return 0 si OK, -1 si la configuración es inválida
+ */
+int checkpoint_init(void);
+
+// Simulator objects saved and restored (not owned)
+void checkpoint_register(Memory* mem, Bus* bus, Cache* caches, PE* pes, Scheduler* sched);
+
+// true when SIM_RESTORE is set: main skips dotprod_init_data
+bool checkpoint_restoring(void);
+
+/**
+ * @brief Carga la foto de SIM_RESTORE en los objetos registrados
+ *
+ * Llamar antes de crear los hilos de los PEs.
+ * @return 0 si OK, -1 si el archivo no existe o no corresponde a esta configuración
+ */
+int checkpoint_restore(void);
+
+/**
+ * @brief Guarda la foto si ya se alcanzó SIM_CHECKPOINT_AT
+ *
+ * Llamado por el último PE que llega a una barrera de quantum, con el mutex
+ * del planificador tomado y sin PEs dormidos en MWAIT.
+ */
+void checkpoint_at_barrier(Scheduler* sched);
+
+// Warn if SIM_CHECKPOINT was requested but no barrier qualified
+void checkpoint_finish(void);
+
+#endif // CHECKPOINT_H
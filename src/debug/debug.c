@@ -226,6 +226,7 @@ void dbg_init(void) {
     if (env && (strcmp(env, "1")==0 || strcasecmp(env, "true")==0 || strcasecmp(env, "yes")==0)) {
         G.enabled = true;
         G.paused = true; // start paused in debug mode
+        log_shutdown();  // synchronous logs, interleaved in order with CLI output
     }
 }
 
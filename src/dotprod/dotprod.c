@@ -1,12 +1,61 @@
 #define LOG_MODULE "DOTPROD"
 #include "dotprod.h"
 #include "vector_loader.h"
+#include "reference.h"
 #include "config.h"
 #include <stdio.h>
 #include <pthread.h>
 #include <stdlib.h>
+#include <string.h>
 #include "log.h"
 
+static uint64_t VERIFY_MAX_ULPS = VERIFY_ULPS;    // SIM_VERIFY_ULPS
+static double VERIFY_MAX_REL = VERIFY_RTOL;       // SIM_VERIFY_RTOL
+
+int dotprod_verify_init(void) {
+    const char* env_ulps = getenv("SIM_VERIFY_ULPS");
+    if (env_ulps && *env_ulps) {
+        char* end;
+        long long ulps = strtoll(env_ulps, &end, 0);
+        if (*end != '\0' || ulps < 0) {
+            LOGE("Invalid SIM_VERIFY_ULPS=%s (units in the last place, >= 0)", env_ulps);
+            return -1;
+        }
+        VERIFY_MAX_ULPS = (uint64_t)ulps;
+    }
+    const char* env_rtol = getenv("SIM_VERIFY_RTOL");
+    if (env_rtol && *env_rtol) {
+        char* end;
+        double rtol = strtod(env_rtol, &end);
+        if (*end != '\0' || !(rtol >= 0.0)) {
+            LOGE("Invalid SIM_VERIFY_RTOL=%s (relative to sum(|a*b|), >= 0)", env_rtol);
+            return -1;
+        }
+        VERIFY_MAX_REL = rtol;
+    }
+    return 0;
+}
+
+// Compensated dot product of A and B as stored in memory (caller holds mem->mutex)
+static double reference_from_memory(const Memory* mem, double* abs_sum) {
+    double* a = malloc(VECTOR_SIZE * sizeof(double));
+    double* b = malloc(VECTOR_SIZE * sizeof(double));
+    double ref = 0.0;
+    *abs_sum = 0.0;
+    if (a && b) {
+        for (int i = 0; i < VECTOR_SIZE; i++) {
+            a[i] = mem->data[VECTOR_A_ADDR + VECTOR_INDEX(i)];
+            b[i] = mem->data[VECTOR_B_ADDR + VECTOR_INDEX(i)];
+        }
+        ref = reference_dot(a, b, VECTOR_SIZE, abs_sum);
+    } else {
+        LOGE("Out of memory for the reference dot product");
+    }
+    free(a);
+    free(b);
+    return ref;
+}
+
 void dotprod_init_data(Memory* mem) {
     pthread_mutex_lock(&mem->mutex);
     
@@ -36,7 +85,7 @@ void dotprod_init_data(Memory* mem) {
     // Per-PE configuration (start_index, segment_size)
         printf("  Per-PE configuration:\n");
     for (int pe = 0; pe < NUM_PES; pe++) {
-        int start_idx = pe * SEGMENT_SIZE_WORKER;
+        int start_idx = pe * SEGMENT_STRIDE;  // Index in memory: segments may be padded
         int segment_size = (pe == NUM_PES - 1) ? SEGMENT_SIZE_MASTER : SEGMENT_SIZE_WORKER;
         
         mem->data[CFG_PE(pe, PE_START_INDEX)] = (double)start_idx;
@@ -50,25 +99,32 @@ void dotprod_init_data(Memory* mem) {
     // ========================================================================
     // Initialize partial results area (1 block: 4 values)
     // ========================================================================
-        printf("[DotProd] Initializing results area (1 cache block at addr 0x%X)\n", RESULTS_ADDR);
+        printf("[DotProd] Layout: %s results/flags, %s segments\n",
+           LAYOUT_PADDED ? "padded (one block per PE)" : "packed",
+           LAYOUT_ALIGN_SEGMENTS ? "block-aligned" : "contiguous");
+        printf("[DotProd] Initializing results area (addr 0x%X, stride %d)\n", RESULTS_ADDR, SYNC_STRIDE);
     for (int pe = 0; pe < NUM_PES; pe++) {
-        mem->data[RESULTS_ADDR + pe] = 0.0;
-            printf("  PE%d result -> addr 0x%X\n", pe, RESULTS_ADDR + pe);
+        mem->data[RESULT_ADDR(pe)] = 0.0;
+            printf("  PE%d result -> addr 0x%X\n", pe, RESULT_ADDR(pe));
     }
     
     // ========================================================================
     // Initialize synchronization flags (1 block: first 3 values)
     // ========================================================================
-        printf("[DotProd] Initializing synchronization flags (1 cache block at addr 0x%X)\n", FLAGS_ADDR);
+        printf("[DotProd] Initializing synchronization flags (addr 0x%X, stride %d)\n", FLAGS_ADDR, SYNC_STRIDE);
     for (int pe = 0; pe < NUM_PES - 1; pe++) {  // Solo PE0-PE2 necesitan flags
-        mem->data[FLAGS_ADDR + pe] = 0.0;
-            printf("  PE%d flag -> addr 0x%X\n", pe, FLAGS_ADDR + pe);
+        mem->data[FLAG_ADDR(pe)] = 0.0;
+            printf("  PE%d flag -> addr 0x%X\n", pe, FLAG_ADDR(pe));
     }
     
     // Final result
     mem->data[FINAL_RESULT_ADDR] = 0.0;
     printf("[DotProd] Final result -> addr 0x%X\n", FINAL_RESULT_ADDR);
     
+    // Barrier counter (atomic kernels: workers FAA +1 on arrival)
+    mem->data[BARRIER_COUNTER_ADDR] = 0.0;
+    printf("[DotProd] Barrier counter -> addr 0x%X\n", BARRIER_COUNTER_ADDR);
+    
     // ========================================================================
     // Data vectors (at the end of memory)
     // ========================================================================
@@ -85,21 +141,28 @@ void dotprod_init_data(Memory* mem) {
            GET_BLOCK_OFFSET(VECTOR_B_ADDR));
     
     // Calculate how many cache blocks are needed
-    int blocks_a = (VECTOR_SIZE + GET_BLOCK_OFFSET(VECTOR_A_ADDR) + BLOCK_SIZE - 1) / BLOCK_SIZE;
-    int blocks_b = (VECTOR_SIZE + GET_BLOCK_OFFSET(VECTOR_B_ADDR) + BLOCK_SIZE - 1) / BLOCK_SIZE;
+    int blocks_a = (VECTOR_SPAN + GET_BLOCK_OFFSET(VECTOR_A_ADDR) + BLOCK_SIZE - 1) / BLOCK_SIZE;
+    int blocks_b = (VECTOR_SPAN + GET_BLOCK_OFFSET(VECTOR_B_ADDR) + BLOCK_SIZE - 1) / BLOCK_SIZE;
     int blocks_aligned = (VECTOR_SIZE + BLOCK_SIZE - 1) / BLOCK_SIZE;
     
     printf("  Required cache blocks:\n");
     printf("    Vector A: %d blocks (aligned would use %d)\n", blocks_a, blocks_aligned);
     printf("    Vector B: %d blocks (aligned would use %d)\n", blocks_b, blocks_aligned);
-    if (blocks_a > blocks_aligned || blocks_b > blocks_aligned) {
+    if (!LAYOUT_ALIGN_SEGMENTS && (blocks_a > blocks_aligned || blocks_b > blocks_aligned)) {
         printf("    Warning: misalignment causes extra cache blocks\n");
     }
     
     // ========================================================================
-    // Cargar vectores desde archivos CSV
+    // Cargar vectores desde archivos CSV (o sintéticos con SIM_VECTORS=synthetic)
     // ========================================================================
-        printf("\n[DotProd] Loading vectors from CSV files\n");
+    const char* env_vectors = getenv("SIM_VECTORS");
+    bool synthetic = env_vectors && strcmp(env_vectors, "synthetic") == 0;
+    if (env_vectors && *env_vectors && !synthetic && strcmp(env_vectors, "csv") != 0) {
+        LOGW("Unknown SIM_VECTORS=%s (csv|synthetic), loading CSV files", env_vectors);
+    }
+    const char* source_a = synthetic ? "synthetic" : VECTOR_A_FILE;
+    const char* source_b = synthetic ? "synthetic" : VECTOR_B_FILE;
+        printf("\n[DotProd] Loading vectors from %s\n", synthetic ? "synthetic data" : "CSV files");
     
     // Temporary buffers to load vectors
     double* vec_a_buffer = (double*)malloc(VECTOR_SIZE * sizeof(double));
@@ -112,7 +175,8 @@ void dotprod_init_data(Memory* mem) {
     }
     
     // Cargar Vector A
-    VectorLoadResult result_a = load_vector_from_csv(VECTOR_A_FILE, vec_a_buffer, VECTOR_SIZE);
+    VectorLoadResult result_a = synthetic ? synthetic_vector(vec_a_buffer, VECTOR_SIZE, 3)
+                                          : load_vector_from_csv(VECTOR_A_FILE, vec_a_buffer, VECTOR_SIZE);
     if (!result_a.success) {
         LOGE("Error loading vector A: %s", result_a.error_message);
         LOGE("Program cannot continue without valid vectors");
@@ -123,7 +187,7 @@ void dotprod_init_data(Memory* mem) {
     }
     
     printf("[DotProd] Vector A loaded from '%s' (%d values)\n", 
-        VECTOR_A_FILE, result_a.values_read);
+        source_a, result_a.values_read);
     
     // If fewer values were read than needed, fill with zeros
     if (result_a.values_read < VECTOR_SIZE) {
@@ -135,7 +199,8 @@ void dotprod_init_data(Memory* mem) {
     }
     
     // Cargar Vector B
-    VectorLoadResult result_b = load_vector_from_csv(VECTOR_B_FILE, vec_b_buffer, VECTOR_SIZE);
+    VectorLoadResult result_b = synthetic ? synthetic_vector(vec_b_buffer, VECTOR_SIZE, 5)
+                                          : load_vector_from_csv(VECTOR_B_FILE, vec_b_buffer, VECTOR_SIZE);
     if (!result_b.success) {
         LOGE("Error loading vector B: %s", result_b.error_message);
         LOGE("Program cannot continue without valid vectors");
@@ -146,7 +211,7 @@ void dotprod_init_data(Memory* mem) {
     }
     
     printf("[DotProd] Vector B loaded from '%s' (%d values)\n", 
-        VECTOR_B_FILE, result_b.values_read);
+        source_b, result_b.values_read);
     
     // If fewer values were read than needed, fill with zeros
     if (result_b.values_read < VECTOR_SIZE) {
@@ -160,24 +225,21 @@ void dotprod_init_data(Memory* mem) {
     // Copiar vectores a memoria y mostrarlos
     print_vector("Vector A", vec_a_buffer, VECTOR_SIZE, VECTOR_A_ADDR);
     for (int i = 0; i < VECTOR_SIZE; i++) {
-        mem->data[VECTOR_A_ADDR + i] = vec_a_buffer[i];
+        mem->data[VECTOR_A_ADDR + VECTOR_INDEX(i)] = vec_a_buffer[i];
     }
     
     print_vector("Vector B", vec_b_buffer, VECTOR_SIZE, VECTOR_B_ADDR);
     for (int i = 0; i < VECTOR_SIZE; i++) {
-        mem->data[VECTOR_B_ADDR + i] = vec_b_buffer[i];
+        mem->data[VECTOR_B_ADDR + VECTOR_INDEX(i)] = vec_b_buffer[i];
     }
     
+    // Expected result (compensated host reference of the loaded vectors)
+    double expected = reference_dot(vec_a_buffer, vec_b_buffer, VECTOR_SIZE, NULL);
+    printf("[DotProd] Expected result: %.2f\n", expected);
+    
     // Free temporary buffers
     free(vec_a_buffer);
     free(vec_b_buffer);
-    
-    // Expected calculation (true dot product of loaded vectors)
-    double expected = 0.0;
-    for (int i = 0; i < VECTOR_SIZE; i++) {
-        expected += mem->data[VECTOR_A_ADDR + i] * mem->data[VECTOR_B_ADDR + i];
-    }
-    printf("[DotProd] Expected result: %.2f\n", expected);
         printf("[DotProd] Data initialization complete\n\n");
     
     pthread_mutex_unlock(&mem->mutex);
@@ -190,7 +252,7 @@ double dotprod_get_result(Memory* mem) {
     return result;
 }
 
-void dotprod_print_results(Memory* mem) {
+int dotprod_print_results(Memory* mem) {
     // No need for a manual flush; HALT already wrote back all modified lines via the bus
     
     pthread_mutex_lock(&mem->mutex);
@@ -201,14 +263,14 @@ void dotprod_print_results(Memory* mem) {
     printf("\nInput vectors:\n");
     printf("  Vector A: [");
     for (int i = 0; i < VECTOR_SIZE; i++) {
-        printf("%.2f", mem->data[VECTOR_A_ADDR + i]);
+        printf("%.2f", mem->data[VECTOR_A_ADDR + VECTOR_INDEX(i)]);
         if (i < VECTOR_SIZE - 1) printf(", ");
     }
     printf("]\n");
     
     printf("  Vector B: [");
     for (int i = 0; i < VECTOR_SIZE; i++) {
-        printf("%.2f", mem->data[VECTOR_B_ADDR + i]);
+        printf("%.2f", mem->data[VECTOR_B_ADDR + VECTOR_INDEX(i)]);
         if (i < VECTOR_SIZE - 1) printf(", ");
     }
     printf("]\n");
@@ -218,7 +280,7 @@ void dotprod_print_results(Memory* mem) {
     for (int pe = 0; pe < NUM_PES; pe++) {
         int start_elem = pe * SEGMENT_SIZE_WORKER;
         int end_elem = start_elem + SEGMENT_SIZE_WORKER - 1;
-    int addr = RESULTS_ADDR + pe;  // Compact: consecutive addresses
+    int addr = RESULT_ADDR(pe);  // Consecutive, or one block each (LAYOUT_PADDED)
     printf("  PE%d (elements %d-%d):   %.2f (addr 0x%X)\n", 
                pe, start_elem, end_elem, mem->data[addr], addr);
     }
@@ -227,19 +289,21 @@ void dotprod_print_results(Memory* mem) {
     double final_result = mem->data[FINAL_RESULT_ADDR];
     printf("\nFinal dot product: %.2f (addr 0x%X)\n", final_result, FINAL_RESULT_ADDR);
     
-    // Verification (compute expected dot product from the loaded vectors)
-    double expected = 0.0;
-    for (int i = 0; i < VECTOR_SIZE; i++) {
-        expected += mem->data[VECTOR_A_ADDR + i] * mem->data[VECTOR_B_ADDR + i];
-    }
-    
+    // Verification against the compensated host reference of the loaded vectors
+    double abs_sum;
+    double expected = reference_from_memory(mem, &abs_sum);
     double error = final_result - expected;
+    uint64_t ulps = reference_ulp_distance(final_result, expected);
+    double rel = abs_sum > 0.0 ? (error < 0.0 ? -error : error) / abs_sum : 0.0;
+    int correct = ulps <= VERIFY_MAX_ULPS || (abs_sum > 0.0 && rel <= VERIFY_MAX_REL);
+
     printf("\nVerification:\n");
-    printf("  Expected: %.2f\n", expected);
+    printf("  Expected: %.2f (compensated reference %.17g)\n", expected, expected);
     printf("  Calculated: %.2f\n", final_result);
-    printf("  Error: %.10f\n", error);
+    printf("  Error: %.10f (%lu ulp, %.3g of sum|a*b|; tolerance %lu ulp or %.3g)\n", error,
+           (unsigned long)ulps, rel, (unsigned long)VERIFY_MAX_ULPS, VERIFY_MAX_REL);
     
-    if (error < 0.0001 && error > -0.0001) {
+    if (correct) {
         printf("  Status: CORRECT\n");
     } else {
         printf("  Status: INCORRECT\n");
@@ -248,4 +312,38 @@ void dotprod_print_results(Memory* mem) {
     printf("\n");
     
     pthread_mutex_unlock(&mem->mutex);
+    return correct ? 0 : 1;
+}
+
+// Regions of the layout in config.h, by address
+typedef struct {
+    const char* name;
+    int start;
+    int size;
+} DotprodRegion;
+
+void dotprod_block_regions(int block_base, char* buf, size_t size) {
+    const DotprodRegion regions[] = {
+        { "config",  SHARED_CONFIG_ADDR,   CFG_TOTAL_SIZE },
+        { "results", RESULTS_ADDR,         NUM_PES * SYNC_STRIDE },
+        { "flags",   FLAGS_ADDR,           NUM_PES * SYNC_STRIDE },
+        { "final",   FINAL_RESULT_ADDR,    SYNC_STRIDE },
+        { "barrier", BARRIER_COUNTER_ADDR, 1 },
+        { "vecA",    VECTOR_A_ADDR,        VECTOR_SPAN },
+        { "vecB",    VECTOR_B_ADDR,        VECTOR_SPAN },
+        { "code",    CODE_REGION_BASE,     CODE_REGION_SIZE },
+    };
+
+    size_t len = 0;
+    buf[0] = '\0';
+    for (size_t r = 0; r < sizeof(regions) / sizeof(regions[0]); r++) {
+        int start = regions[r].start;
+        int end = start + regions[r].size;
+        if (start < block_base + BLOCK_SIZE && end > block_base && len < size) {
+            len += snprintf(buf + len, size - len, "%s%s", len ? "+" : "", regions[r].name);
+        }
+    }
+    if (len == 0) {
+        snprintf(buf, size, "-");
+    }
 }
@@ -1,6 +1,7 @@
 #ifndef DOTPROD_H
 #define DOTPROD_H
 
+#include <stddef.h>
 #include "memory.h"
 
 /**
@@ -23,12 +24,31 @@ void dotprod_init_data(Memory* mem);
  */
 double dotprod_get_result(Memory* mem);
 
+/**
+ * @brief Lee la tolerancia de la verificación (SIM_VERIFY_ULPS, SIM_VERIFY_RTOL)
+ * @return 0 si OK, -1 si algún valor es inválido
+ */
+int dotprod_verify_init(void);
+
 /**
  * @brief Print vectors and dot product results
  * Includes automatic cache writeback to ensure coherence
  * 
+ * Checks the result against a compensated host reference (reference.h)
+ * within VERIFY_ULPS / VERIFY_RTOL.
+ * 
  * @param mem Pointer to Memory structure
+ * @return 0 if the result matches the reference, 1 otherwise
+ */
+int dotprod_print_results(Memory* mem);
+
+/**
+ * @brief Nombre de las regiones del layout que solapa un bloque
+ *
+ * Para la sección [Hot blocks]: "config", "results", "flags", "final",
+ * "barrier", "vecA", "vecB" o "code", unidas con '+' si el bloque cae en
+ * varias (p. ej. "results+flags").
  */
-void dotprod_print_results(Memory* mem);
+void dotprod_block_regions(int block_base, char* buf, size_t size);
 
 #endif // DOTPROD_H
@@ -0,0 +1,83 @@
+#include "reference.h"
+#include <string.h>
+
+typedef double RefVec __attribute__((vector_size(REFERENCE_LANES * sizeof(double))));
+typedef int64_t RefBits __attribute__((vector_size(REFERENCE_LANES * sizeof(double))));
+
+// Error-free transformations: exact only if a*b+c is never fused into an FMA
+#define REF_EXACT __attribute__((optimize("fp-contract=off")))
+
+#define DEKKER_SPLIT 134217729.0    // 2^27 + 1
+
+// x + y = a + b exactly (x may be a or b)
+#define TWO_SUM(a, b, x, y) do {                         \
+        __typeof__(x) a_ = (a), b_ = (b);                 \
+        __typeof__(x) s_ = a_ + b_;                       \
+        __typeof__(x) z_ = s_ - a_;                       \
+        (y) = (a_ - (s_ - z_)) + (b_ - z_);               \
+        (x) = s_;                                         \
+    } while (0)
+
+// x + y = a * b exactly (Dekker: a = ah + al with 26-bit halves)
+#define TWO_PRODUCT(a, b, x, y) do {                                 \
+        __typeof__(x) a_ = (a), b_ = (b);                             \
+        __typeof__(x) p_ = a_ * b_;                                   \
+        __typeof__(x) ca_ = DEKKER_SPLIT * a_;                        \
+        __typeof__(x) ah_ = ca_ - (ca_ - a_);                         \
+        __typeof__(x) al_ = a_ - ah_;                                 \
+        __typeof__(x) cb_ = DEKKER_SPLIT * b_;                        \
+        __typeof__(x) bh_ = cb_ - (cb_ - b_);                         \
+        __typeof__(x) bl_ = b_ - bh_;                                 \
+        (y) = al_ * bl_ - (((p_ - ah_ * bh_) - al_ * bh_) - ah_ * bl_); \
+        (x) = p_;                                                     \
+    } while (0)
+
+REF_EXACT
+double reference_dot(const double* a, const double* b, int n, double* abs_sum) {
+    RefVec p = {0}, s = {0}, mag = {0};
+    int i = 0;
+    for (; i + REFERENCE_LANES <= n; i += REFERENCE_LANES) {
+        RefVec va, vb, h, r, q;
+        memcpy(&va, a + i, sizeof(va));
+        memcpy(&vb, b + i, sizeof(vb));
+        TWO_PRODUCT(va, vb, h, r);
+        TWO_SUM(p, h, p, q);
+        s += q + r;
+        RefBits hb = (RefBits)h & INT64_MAX;    // |h|: clear the sign bits
+        mag += (RefVec)hb;
+    }
+
+    // Lanes, then the tail, through the same scalar recurrence
+    double sum = 0.0, err = 0.0, abs_total = 0.0;
+    for (int k = 0; k < REFERENCE_LANES; k++) {
+        double q;
+        TWO_SUM(sum, p[k], sum, q);
+        err += q + s[k];
+        abs_total += mag[k];
+    }
+    for (; i < n; i++) {
+        double h, r, q;
+        TWO_PRODUCT(a[i], b[i], h, r);
+        TWO_SUM(sum, h, sum, q);
+        err += q + r;
+        abs_total += h < 0 ? -h : h;
+    }
+
+    if (abs_sum) {
+        *abs_sum = abs_total;
+    }
+    return sum + err;
+}
+
+// Sign-magnitude bits -> integers ordered like the doubles
+static int64_t ordered_bits(double x) {
+    int64_t bits;
+    memcpy(&bits, &x, sizeof(bits));
+    return bits < 0 ? INT64_MIN - bits : bits;
+}
+
+uint64_t reference_ulp_distance(double x, double y) {
+    int64_t a = ordered_bits(x);
+    int64_t b = ordered_bits(y);
+    return a > b ? (uint64_t)a - (uint64_t)b : (uint64_t)b - (uint64_t)a;
+}
@@ -0,0 +1,32 @@
+#ifndef REFERENCE_H
+#define REFERENCE_H
+
+#include <stdint.h>
+
+/**
+ * @file reference.h
+ * @brief Producto punto de referencia en el host (verificación del resultado)
+ *
+ * Dot2 de Ogita-Rump-Oishi: cada producto se separa en valor y error
+ * (TwoProduct, con el split de Dekker) y cada suma también (TwoSum); los
+ * errores se acumulan aparte y se suman al final. El resultado es tan
+ * preciso como si se calculara con el doble de precisión y redondeara una
+ * vez, así que no depende del orden de reducción de los PEs.
+ *
+ * El bucle trabaja con REFERENCE_LANES acumuladores independientes en
+ * vectores de GCC (vector_size), que el compilador traduce a SSE/AVX/NEON
+ * según el -march del build sin intrínsecos de una arquitectura concreta.
+ */
+
+#define REFERENCE_LANES 4
+
+/**
+ * @brief Producto punto compensado de a y b
+ * @param abs_sum Si no es NULL, recibe sum(|a[i] * b[i]|) (escala del error de la suma ingenua)
+ */
+double reference_dot(const double* a, const double* b, int n, double* abs_sum);
+
+// Distance in units in the last place between two finite doubles (0: equal)
+uint64_t reference_ulp_distance(double x, double y);
+
+#endif // REFERENCE_H
@@ -109,6 +109,16 @@ VectorLoadResult load_vector_from_csv(const char* filename, double* buffer, int
     return result;
 }
 
+VectorLoadResult synthetic_vector(double* buffer, int size, int seed) {
+    VectorLoadResult result = {0};
+    for (int i = 0; i < size; i++) {
+        buffer[i] = (double)((i * seed + 7) % 17 - 8) * 0.25;
+    }
+    result.success = true;
+    result.values_read = size;
+    return result;
+}
+
 void print_vector(const char* name, const double* buffer, int size, int start_addr) {
     printf("[DotProd] Loading %s into addresses 0x%X-0x%X\n  %s = [", 
            name, start_addr, start_addr + size - 1, name);
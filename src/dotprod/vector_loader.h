@@ -25,6 +25,19 @@ typedef struct {
  */
 VectorLoadResult load_vector_from_csv(const char* filename, double* buffer, int max_size);
 
+/**
+ * Fill a vector with deterministic synthetic values (SIM_VECTORS=synthetic)
+ * 
+ * @param buffer     Buffer to store the values
+ * @param size       Number of values
+ * @param seed       Selects the sequence (A and B use different seeds)
+ * @return           Operation result (always successful)
+ * 
+ * Values are multiples of 0.25 in [-2, 2], so every product and partial sum
+ * is exact in double and the result does not depend on the reduction order.
+ */
+VectorLoadResult synthetic_vector(double* buffer, int size, int seed);
+
 /**
  * Print the contents of a vector in a readable format
  * 
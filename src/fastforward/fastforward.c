@@ -0,0 +1,175 @@
+#define LOG_MODULE "FFWD"
+#include "fastforward.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdatomic.h>
+#include "log.h"
+
+bool ff_pending = false;
+
+static bool CONFIGURED;              // SIM_FASTFWD or SIM_SAMPLE given
+static bool UNTIL_ROI;               // SIM_FASTFWD=roi
+static uint64_t FASTFWD;             // SIM_FASTFWD=N
+static uint64_t SAMPLE_DETAILED;     // SIM_SAMPLE=D:F (0: no sampling)
+static uint64_t SAMPLE_FUNCTIONAL;
+static int WARM = 1;
+
+static Cache* CACHES;
+static atomic_bool roi_seen;
+
+// Controller state, only touched with the scheduler mutex held
+static int functional;               // Current mode
+static uint64_t phase_start;         // Instructions retired when the phase began
+static uint64_t phase_length;        // Functional phase length (0: until ROI)
+static uint64_t functional_instr;
+static uint64_t detailed_instr;
+static uint64_t detailed_windows;
+
+// INIT
+
+int ff_init(void) {
+    const char* env_ff = getenv("SIM_FASTFWD");
+    if (env_ff && *env_ff) {
+        if (strcasecmp(env_ff, "roi") == 0) {
+            UNTIL_ROI = true;
+        } else {
+            char* end;
+            FASTFWD = strtoull(env_ff, &end, 0);
+            if (*end != '\0' || FASTFWD == 0) {
+                LOGE("Invalid SIM_FASTFWD=%s (use N > 0 or roi)", env_ff);
+                return -1;
+            }
+        }
+        CONFIGURED = true;
+    }
+
+    const char* env_sample = getenv("SIM_SAMPLE");
+    if (env_sample && *env_sample) {
+        unsigned long long d = 0, f = 0;
+        if (sscanf(env_sample, "%llu:%llu", &d, &f) != 2 || d == 0 || f == 0) {
+            LOGE("Invalid SIM_SAMPLE=%s (use D:F, both > 0)", env_sample);
+            return -1;
+        }
+        SAMPLE_DETAILED = d;
+        SAMPLE_FUNCTIONAL = f;
+        CONFIGURED = true;
+    }
+
+    const char* env_warm = getenv("SIM_FF_WARM");
+    WARM = !(env_warm && atoi(env_warm) == 0);
+    return 0;
+}
+
+static void set_mode(int on) {
+    for (int i = 0; i < NUM_PES; i++) {
+        cache_set_functional(&CACHES[i], on, WARM);
+    }
+    functional = on;
+}
+
+void ff_register(Cache* caches, Scheduler* sched) {
+    CACHES = caches;
+    if (!CONFIGURED) {
+        return;
+    }
+    if (sched->mode != SCHED_QUANTUM) {
+        LOGW("SIM_FASTFWD/SIM_SAMPLE need quantum barriers (SIM_SCHED=quantum), running detailed");
+        CONFIGURED = false;
+        return;
+    }
+
+    phase_start = sched_stats_instructions(&sched->stats);
+    if (UNTIL_ROI || FASTFWD > 0) {
+        phase_length = UNTIL_ROI ? 0 : FASTFWD;
+        set_mode(1);
+        LOGI("Fast-forward until %s", UNTIL_ROI ? "ROI" : "instruction count");
+    } else {
+        detailed_windows = 1;
+    }
+    ff_pending = true;
+}
+
+void ff_roi_reached(int pe_id) {
+    if (!atomic_exchange(&roi_seen, true)) {
+        LOGI("PE%d reached ROI", pe_id);
+    }
+}
+
+bool ff_waiting_for_roi(void) {
+    return UNTIL_ROI && functional;
+}
+
+// MODE SWITCH
+
+// A PE asleep in MWAIT cannot see the switch half done: it does not touch its
+// cache again before sched_pe_unpark, which waits for the scheduler mutex
+void ff_at_barrier(Scheduler* sched) {
+    uint64_t now = sched_stats_instructions(&sched->stats);
+    uint64_t run = now - phase_start;
+
+    if (functional) {
+        bool done = phase_length ? run >= phase_length : atomic_load(&roi_seen);
+        if (!done) {
+            return;
+        }
+        set_mode(0);
+        functional_instr += run;
+        detailed_windows++;
+        LOGI("Detailed window %lu at %lu instructions", (unsigned long)detailed_windows,
+             (unsigned long)now);
+    } else {
+        if (run < SAMPLE_DETAILED) {
+            return;
+        }
+        set_mode(1);
+        detailed_instr += run;
+        phase_length = SAMPLE_FUNCTIONAL;
+        LOGI("Functional phase at %lu instructions", (unsigned long)now);
+    }
+
+    phase_start = now;
+    // Without sampling, reaching the detailed model is the last switch
+    ff_pending = SAMPLE_DETAILED > 0;
+}
+
+// STATISTICS
+
+void ff_print_stats(const Scheduler* sched) {
+    if (!CONFIGURED) {
+        return;
+    }
+
+    // The phase in progress when the PEs finished
+    uint64_t functional_total = functional_instr;
+    uint64_t detailed_total = detailed_instr;
+    uint64_t run = sched_stats_instructions(&sched->stats) - phase_start;
+    if (functional) {
+        functional_total += run;
+    } else {
+        detailed_total += run;
+    }
+    uint64_t total = functional_total + detailed_total;
+
+    const char* B = log_color_bold();
+    const char* BLUE = log_color_blue();
+    const char* RESET = log_color_reset();
+
+    printf("\n%s[Fast-forward]%s\n", BLUE, RESET);
+    char fastfwd[32];
+    if (UNTIL_ROI) {
+        snprintf(fastfwd, sizeof(fastfwd), "roi");
+    } else {
+        snprintf(fastfwd, sizeof(fastfwd), "%lu", (unsigned long)FASTFWD);
+    }
+    printf("%sMode%s: fastforward=%s sample=%lu:%lu warm=%d\n", B, RESET, fastfwd,
+           (unsigned long)SAMPLE_DETAILED, (unsigned long)SAMPLE_FUNCTIONAL, WARM);
+    printf("%sSplit%s: functional=%lu (%.2f%%) detailed=%lu (%.2f%%) windows=%lu\n", B, RESET,
+           (unsigned long)functional_total, total ? 100.0 * functional_total / total : 0.0,
+           (unsigned long)detailed_total, total ? 100.0 * detailed_total / total : 0.0,
+           (unsigned long)detailed_windows);
+    printf("Cache, bus and memory statistics cover the detailed windows only\n");
+    if (detailed_windows == 0) {
+        LOGW("The run ended before the first detailed window");
+    }
+}
@@ -0,0 +1,64 @@
+#ifndef FASTFORWARD_H
+#define FASTFORWARD_H
+
+#include <stdbool.h>
+#include "config.h"
+#include "cache.h"
+#include "scheduler.h"
+
+/**
+ * @file fastforward.h
+ * @brief Fast-forward funcional y muestreo de ventanas detalladas
+ *
+ * En modo funcional los PEs ejecutan la ISA contra la memoria plana: sin bus,
+ * sin MESI y sin estadísticas (ver cache_set_functional). El controlador
+ * alterna entre ese modo y el modelo detallado, siempre en una barrera de
+ * quantum, cuando ningún PE tiene una transacción de bus en curso.
+ *
+ * Variables de entorno:
+ *   SIM_FASTFWD=N|roi   arrancar en modo funcional durante N instrucciones
+ *                       (sumadas entre todos los PEs) o hasta que algún PE
+ *                       ejecute la instrucción ROI
+ *   SIM_SAMPLE=D:F      después, alternar ventanas detalladas de D
+ *                       instrucciones con tramos funcionales de F
+ *   SIM_FF_WARM=0       no instalar tags durante el modo funcional (por
+ *                       defecto los fallos instalan la línea en E o S, así la
+ *                       primera ventana detallada no empieza con cachés frías)
+ *
+ * Las estadísticas de caché, bus y memoria cubren solo las ventanas
+ * detalladas. Requiere SIM_SCHED=quantum (el modo yield no tiene barreras).
+ */
+
+// true while a mode switch may still happen (checked at every quantum barrier)
+extern bool ff_pending;
+
+/**
+ * @brief Lee SIM_FASTFWD, SIM_SAMPLE y SIM_FF_WARM
+ * @return 0 si OK, -1 si algún valor es inválido
+ */
+int ff_init(void);
+
+// Caches switched by the controller (not owned). Enters functional mode
+// right away when SIM_FASTFWD is set. Call before the PE threads start.
+void ff_register(Cache* caches, Scheduler* sched);
+
+// ROI instruction executed by pe_id
+void ff_roi_reached(int pe_id);
+
+// true while SIM_FASTFWD=roi runs in functional mode: a PE that executes ROI
+// then ends its quantum so the switch happens at the next barrier. The mode
+// only changes while every PE is held at a barrier.
+bool ff_waiting_for_roi(void);
+
+/**
+ * @brief Cambia de modo si terminó la ventana actual
+ *
+ * Llamado por el último PE que llega a una barrera de quantum, con el mutex
+ * del planificador tomado.
+ */
+void ff_at_barrier(Scheduler* sched);
+
+// Print the functional/detailed split (nothing if fast-forward is off)
+void ff_print_stats(const Scheduler* sched);
+
+#endif // FASTFORWARD_H
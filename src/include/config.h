@@ -2,32 +2,138 @@
 #define CONFIG_H
 
 // SYSTEM CONFIGURATION
+// Architecture parameters can be overridden at build time without editing
+// this file: make SIM_DEFS="-DSETS=8 -DWAYS=4" (used by scripts/sweep.py)
+#ifndef NUM_PES
 #define NUM_PES 4
+#endif
+#ifndef SETS
 #define SETS 16
+#endif
+#ifndef WAYS
 #define WAYS 2
+#endif
+#ifndef BLOCK_SIZE
 #define BLOCK_SIZE 4  // 4 doubles (32 bytes)
+#endif
+#ifndef MEM_SIZE
 #define MEM_SIZE 512
+#endif
 
-// ASM program paths
-#define ASM_DOTPROD_PE0_PATH   "asm/dotprod_pe0.asm"
-#define ASM_DOTPROD_PE1_PATH   "asm/dotprod_pe1.asm"
-#define ASM_DOTPROD_PE2_PATH   "asm/dotprod_pe2.asm"
-#define ASM_DOTPROD_PE3_PATH   "asm/dotprod_pe3.asm"
+// INSTRUCTION CACHE (read-only, not coherent; SIM_ICACHE=0 makes fetch free)
+#ifndef ICACHE_SETS
+#define ICACHE_SETS 4
+#endif
+#ifndef ICACHE_WAYS
+#define ICACHE_WAYS 2
+#endif
+// Code region at the top of memory: one CODE_SLOT_SIZE slot per PE, enough
+// for the largest per-PE program in instructions (the dot-product master,
+// about 60 at 4 PEs). A shared SPMD image spans the whole region, at least two
+// slots so that the workload images (up to about 120) also run on one PE; a
+// larger program is rejected when it is loaded. With the default MEM_SIZE the
+// region fits up to 4 PEs: more PEs need a larger MEM_SIZE (the layout check fails).
+#ifndef CODE_SLOT_SIZE
+#define CODE_SLOT_SIZE 64
+#endif
+#define CODE_REGION_SIZE ((NUM_PES > 1 ? NUM_PES : 2) * CODE_SLOT_SIZE)
+#define CODE_REGION_BASE (MEM_SIZE - CODE_REGION_SIZE)
+
+// PE SCHEDULING
+// Instructions each PE runs before synchronizing with the others
+// (overridable with SIM_QUANTUM; SIM_SCHED=yield restores yield-per-instruction)
+#define SCHED_QUANTUM_DEFAULT 64
+
+// Upper bound for one MWAIT sleep (microseconds). A timeout is a spurious
+// wakeup: the polling loop re-checks and waits again.
+#define MWAIT_TIMEOUT_US 1000
+
+// Records per thread buffered before each write to the SIM_TRACE file (32 bytes each)
+#define TRACE_BUFFER_RECORDS 4096
+
+// Trace-driven mode (SIM_MEMTRACE): records replayed between releases of the consumed pages
+#define MEMTRACE_WINDOW 65536
+
+// Host cache line: counters written by different host threads never share one
+#define HOST_CACHE_LINE 64
+
+// Time-series sampler (SIM_STATS_SAMPLE): poll period of the retired
+// instruction count, and double reads tried per consistent snapshot. The
+// series has at most one row per poll: its step is SIM_STATS_SAMPLE or the
+// instructions retired in SAMPLER_POLL_US, whichever is larger
+#define SAMPLER_POLL_US 100
+#define SAMPLER_RETRIES 16
+
+// Blocks listed in the [Hot blocks] section (overridable with SIM_HOTBLOCKS)
+#define BLOCK_STATS_TOP_N 8
+
+// Result check against the compensated host reference (SIM_VERIFY_ULPS /
+// SIM_VERIFY_RTOL): accepted within VERIFY_ULPS units in the last place, or
+// within VERIFY_RTOL * sum(|a[i]*b[i]|), the error scale of a plain sum
+#define VERIFY_ULPS 4
+#define VERIFY_RTOL 1e-9
+
+// Cache of assembled binary program images (see program_image.h)
+#define PROGRAM_CACHE_DIR "obj/progcache"
+
+// ASM program paths, one file per PE (%d = PE id)
+#define ASM_DOTPROD_PE_PATH_FMT   "asm/dotprod_pe%d.asm"
+
+// Vectorized variant (VLOAD/VFMA/VREDUCE), selected with SIM_KERNEL=vector
+#define ASM_DOTPROD_VEC_PE_PATH_FMT   "asm/dotprod_vec_pe%d.asm"
+
+// Peephole-optimized scalar kernel, selected with SIM_KERNEL=opt.
+// ASM_UNROLL 1 also unrolls the main loop to BLOCK_SIZE elements per
+// iteration and the final reduction (0: peephole only)
+#define ASM_UNROLL 1
+#define ASM_DOTPROD_OPT_PE_PATH_FMT   "asm/dotprod_opt_pe%d.asm"
+
+// Single SPMD image shared by all PEs (PEID/NPES), selected with SIM_KERNEL=spmd
+#define ASM_DOTPROD_SPMD_PATH      "asm/dotprod_spmd.asm"
+
+// Counter barrier with atomic FAA, selected with SIM_KERNEL=atomic
+#define ASM_DOTPROD_ATOMIC_PE_PATH_FMT   "asm/dotprod_atomic_pe%d.asm"
+
+// Workloads other than the dot product (SIM_WORKLOAD): one SPMD image each (%s = name)
+#define ASM_WORKLOAD_PATH_FMT      "asm/wl_%s.asm"
 
 // VECTOR CONFIGURATION (Dot Product)
+// Overridable like the geometry (make SIM_DEFS="-DVECTOR_SIZE=64"); sizes
+// without CSV files in data/ run with SIM_VECTORS=synthetic
+#ifndef VECTOR_SIZE
 #define VECTOR_SIZE 16
+#endif
 
-// CSV input files
-#define VECTOR_A_FILE          "data/vector_decimals_a_16.csv"
-#define VECTOR_B_FILE          "data/vector_decimals_b_16.csv"
+// CSV input files (data/vector_decimals_{a,b}_<VECTOR_SIZE>.csv)
+#define CONFIG_STR_(x)         #x
+#define CONFIG_STR(x)          CONFIG_STR_(x)
+#define VECTOR_A_FILE          "data/vector_decimals_a_" CONFIG_STR(VECTOR_SIZE) ".csv"
+#define VECTOR_B_FILE          "data/vector_decimals_b_" CONFIG_STR(VECTOR_SIZE) ".csv"
 
 #define MISALIGNMENT_OFFSET    0    // Global misalignment (0 = aligned)
 
+// DATA LAYOUT (overridable like the geometry: make SIM_DEFS="-DLAYOUT_PADDED=1")
+// LAYOUT_PADDED 1: each PE's partial result and flag, the final result and the
+// barrier counter get a cache block of their own, so no store invalidates a
+// word another PE uses (0: packed, one word per PE in shared blocks).
+// LAYOUT_ALIGN_SEGMENTS 1: each PE's segment of A and B starts at a block
+// boundary, so PEs never share a vector block (MISALIGNMENT_OFFSET is ignored).
+#ifndef LAYOUT_PADDED
+#define LAYOUT_PADDED 0
+#endif
+#ifndef LAYOUT_ALIGN_SEGMENTS
+#define LAYOUT_ALIGN_SEGMENTS 0
+#endif
+
 // Work distribution with residue: PE0-PE2 process base, PE3 (master) handles residue
 #define SEGMENT_SIZE_WORKER (VECTOR_SIZE / NUM_PES)        // Base elements per worker PE
 #define RESIDUE ((VECTOR_SIZE) % NUM_PES)                  // Residual elements
 #define SEGMENT_SIZE_MASTER (SEGMENT_SIZE_WORKER + RESIDUE) // PE3 handles base + residue
 
+// Distance between the first elements of consecutive segments in memory
+#define SEGMENT_STRIDE (SEGMENT_SIZE_WORKER + LAYOUT_ALIGN_SEGMENTS * ((BLOCK_SIZE - SEGMENT_SIZE_WORKER % BLOCK_SIZE) % BLOCK_SIZE))
+#define VECTOR_SPAN    ((NUM_PES - 1) * SEGMENT_STRIDE + SEGMENT_SIZE_MASTER)  // Words of one vector
+
 // COHERENCE PROTOCOL OVERHEAD
 #define BUS_CONTROL_SIGNAL_SIZE 12   // bytes: msg (4) + addr (4) + src_pe (4)
 #define INVALIDATION_CONTROL_SIGNAL_SIZE 8 // bytes: msg (4) + addr (4)
@@ -59,16 +165,110 @@
 #define PE_SEGMENT_SIZE            1               // Number of elements to process
 
 // Shared space for synchronization and final results
+// (plain arithmetic: scripts/generate_asm.py evaluates these same macros)
+#define SYNC_STRIDE                (1 + LAYOUT_PADDED * (BLOCK_SIZE - 1))  // Words between slots
 #define SYNC_AREA_START            CFG_TOTAL_SIZE
-#define RESULTS_ADDR               SYNC_AREA_START
-#define FLAGS_ADDR                 (RESULTS_ADDR + NUM_PES)
-#define FINAL_RESULT_ADDR          (FLAGS_ADDR + NUM_PES)
+#define RESULTS_ADDR               (SYNC_AREA_START + LAYOUT_PADDED * ((BLOCK_SIZE - SYNC_AREA_START % BLOCK_SIZE) % BLOCK_SIZE))
+#define FLAGS_ADDR                 (RESULTS_ADDR + NUM_PES * SYNC_STRIDE)
+#define FINAL_RESULT_ADDR          (FLAGS_ADDR + NUM_PES * SYNC_STRIDE)
+#define BARRIER_COUNTER_ADDR       (FINAL_RESULT_ADDR + SYNC_STRIDE)  // Counter barrier (atomic kernels)
+#define RESULT_ADDR(pe)            (RESULTS_ADDR + (pe) * SYNC_STRIDE)
+#define FLAG_ADDR(pe)              (FLAGS_ADDR + (pe) * SYNC_STRIDE)
 
 // Vectors area with optional misalignment
-#define SYNC_AREA_END              (FINAL_RESULT_ADDR + 1)
+#define SYNC_AREA_END              (BARRIER_COUNTER_ADDR + 1)
 #define VECTORS_START_ALIGNED      ALIGN_UP(SYNC_AREA_END)
-#define VECTOR_A_ADDR              (VECTORS_START_ALIGNED + ((MISALIGNMENT_OFFSET) % BLOCK_SIZE))
-#define VECTOR_B_ADDR              (VECTOR_A_ADDR + VECTOR_SIZE + ((MISALIGNMENT_OFFSET) % BLOCK_SIZE))
+#define VECTOR_MISALIGN            ((1 - LAYOUT_ALIGN_SEGMENTS) * ((MISALIGNMENT_OFFSET) % BLOCK_SIZE))
+#define VECTOR_A_ADDR              (VECTORS_START_ALIGNED + VECTOR_MISALIGN)
+#define VECTOR_B_ADDR              (VECTOR_A_ADDR + VECTOR_SPAN + LAYOUT_ALIGN_SEGMENTS * ((BLOCK_SIZE - VECTOR_SPAN % BLOCK_SIZE) % BLOCK_SIZE) + VECTOR_MISALIGN)
+
+// Offset of element i (of A or B) from the vector start: segments are SEGMENT_STRIDE apart
+#define SEGMENT_OF(i)              ((i) / SEGMENT_SIZE_WORKER < NUM_PES - 1 ? (i) / SEGMENT_SIZE_WORKER : NUM_PES - 1)
+#define VECTOR_INDEX(i)            ((i) + SEGMENT_OF(i) * (SEGMENT_STRIDE - SEGMENT_SIZE_WORKER))
+
+// WORKLOADS (SIM_WORKLOAD, src/workloads/)
+// Overridable like the geometry. Their data starts at WL_DATA_ADDR, after the
+// synchronization area; the per-PE area of SHARED_CONFIG holds each PE's share
+// of the work (start, count). Plain arithmetic: scripts/generate_asm.py
+// evaluates these same macros to generate asm/wl_<name>.asm.
+#define WL_DATA_ADDR               ((SYNC_AREA_END + BLOCK_SIZE - 1) / BLOCK_SIZE * BLOCK_SIZE)
+
+// matmul: C = A * B (N x N), rows of C split among PEs. B is stored
+// transposed (read-shared by every PE), A and C rows are private
+#ifndef MATMUL_N
+#define MATMUL_N 4
+#endif
+#define MATMUL_SPAN                ((MATMUL_N * MATMUL_N + BLOCK_SIZE - 1) / BLOCK_SIZE * BLOCK_SIZE)
+#define MATMUL_A_ADDR              WL_DATA_ADDR
+#define MATMUL_BT_ADDR             (MATMUL_A_ADDR + MATMUL_SPAN)
+#define MATMUL_C_ADDR              (MATMUL_BT_ADDR + MATMUL_SPAN)
+#define MATMUL_END                 (MATMUL_C_ADDR + MATMUL_N * MATMUL_N)
+
+// histogram: HIST_SIZE inputs split among PEs, FAA +1 on HIST_BINS shared bins
+#ifndef HIST_SIZE
+#define HIST_SIZE 64
+#endif
+#ifndef HIST_BINS
+#define HIST_BINS 8
+#endif
+#define HIST_INPUT_ADDR            WL_DATA_ADDR
+#define HIST_BINS_ADDR             (HIST_INPUT_ADDR + (HIST_SIZE + BLOCK_SIZE - 1) / BLOCK_SIZE * BLOCK_SIZE)
+#define HIST_END                   (HIST_BINS_ADDR + HIST_BINS)
+
+// stencil: Jacobi sweeps over a ROWS x COLS grid with fixed borders, ping-pong
+// between two grids. Interior rows (cells if ROWS == 1) are split among PEs;
+// after each step a counter barrier, so the next step reads the neighbours'
+// boundary rows (halo). Two counters alternate between consecutive steps.
+#ifndef STENCIL_ROWS
+#define STENCIL_ROWS 6
+#endif
+#ifndef STENCIL_COLS
+#define STENCIL_COLS 6
+#endif
+#ifndef STENCIL_STEPS
+#define STENCIL_STEPS 4
+#endif
+#define STENCIL_SPAN               ((STENCIL_ROWS * STENCIL_COLS + BLOCK_SIZE - 1) / BLOCK_SIZE * BLOCK_SIZE)
+#define STENCIL_GRID0_ADDR         WL_DATA_ADDR
+#define STENCIL_GRID1_ADDR         (STENCIL_GRID0_ADDR + STENCIL_SPAN)
+#define STENCIL_BARRIER0_ADDR      (STENCIL_GRID1_ADDR + STENCIL_SPAN)
+#define STENCIL_BARRIER1_ADDR      (STENCIL_BARRIER0_ADDR + BLOCK_SIZE)
+#define STENCIL_END                (STENCIL_BARRIER1_ADDR + 1)
+
+// prodcons: PE 2k produces QUEUE_ITEMS items into a QUEUE_SLOTS ring read by
+// PE 2k+1 (an odd last PE idles). Per pair: ring, head (consumer count) and
+// tail (producer count) in blocks of their own, and the consumer's output
+#ifndef QUEUE_SLOTS
+#define QUEUE_SLOTS 4
+#endif
+#ifndef QUEUE_ITEMS
+#define QUEUE_ITEMS 16
+#endif
+#define QUEUE_PAIRS                (NUM_PES / 2)
+#define QUEUE_HEAD_OFFSET          ((QUEUE_SLOTS + BLOCK_SIZE - 1) / BLOCK_SIZE * BLOCK_SIZE)
+#define QUEUE_TAIL_OFFSET          (QUEUE_HEAD_OFFSET + BLOCK_SIZE)
+#define QUEUE_OUT_OFFSET           (QUEUE_TAIL_OFFSET + BLOCK_SIZE)
+#define QUEUE_PAIR_SPAN            (QUEUE_OUT_OFFSET + (QUEUE_ITEMS + BLOCK_SIZE - 1) / BLOCK_SIZE * BLOCK_SIZE)
+#define QUEUE_ADDR(pair)           (WL_DATA_ADDR + (pair) * QUEUE_PAIR_SPAN)
+#define QUEUE_END                  (WL_DATA_ADDR + QUEUE_PAIRS * QUEUE_PAIR_SPAN)
+
+// lookup: LOOKUP_ROUNDS passes of table lookups (queries split among PEs,
+// sums in RESULT_ADDR(pe)). Between passes PE0 updates one table entry,
+// fenced by two counter barriers: a read-mostly shared table
+#ifndef LOOKUP_ENTRIES
+#define LOOKUP_ENTRIES 16
+#endif
+#ifndef LOOKUP_QUERIES
+#define LOOKUP_QUERIES 64
+#endif
+#ifndef LOOKUP_ROUNDS
+#define LOOKUP_ROUNDS 4
+#endif
+#define LOOKUP_TABLE_ADDR          WL_DATA_ADDR
+#define LOOKUP_KEYS_ADDR           (LOOKUP_TABLE_ADDR + (LOOKUP_ENTRIES + BLOCK_SIZE - 1) / BLOCK_SIZE * BLOCK_SIZE)
+#define LOOKUP_BARRIER0_ADDR       (LOOKUP_KEYS_ADDR + (LOOKUP_QUERIES + BLOCK_SIZE - 1) / BLOCK_SIZE * BLOCK_SIZE)
+#define LOOKUP_BARRIER1_ADDR       (LOOKUP_BARRIER0_ADDR + BLOCK_SIZE)
+#define LOOKUP_END                 (LOOKUP_BARRIER1_ADDR + 1)
 
 // PROTOCOLO MESI
 typedef enum { 
@@ -95,4 +295,24 @@ typedef enum {
 // Build address from base + offset
 #define MAKE_ADDRESS(base, offset) ((base) + (offset))
 
+#if (VECTOR_B_ADDR + VECTOR_SPAN) > CODE_REGION_BASE
+#error "Data vectors overlap the code region (CODE_REGION_SIZE words at the top of memory): increase MEM_SIZE"
+#endif
+
+#if MATMUL_END > CODE_REGION_BASE || HIST_END > CODE_REGION_BASE || STENCIL_END > CODE_REGION_BASE || \
+    QUEUE_END > CODE_REGION_BASE || LOOKUP_END > CODE_REGION_BASE
+#error "Workload data overlaps the code region (CODE_REGION_SIZE words at the top of memory): increase MEM_SIZE or reduce the workload sizes"
+#endif
+
+// Stencil values are exact dyadic fractions (weights 1/2, 1/4, 1/8): exact
+// for up to 16 steps, so the result check is bit for bit
+#if STENCIL_COLS < 3 || STENCIL_ROWS == 2 || STENCIL_STEPS < 1 || STENCIL_STEPS > 16
+#error "STENCIL_COLS >= 3, STENCIL_ROWS 1 (1D) or >= 3 (2D), 1 <= STENCIL_STEPS <= 16"
+#endif
+
+// Entry r is updated before pass r + 1
+#if LOOKUP_ROUNDS < 1 || LOOKUP_ROUNDS - 1 > LOOKUP_ENTRIES
+#error "1 <= LOOKUP_ROUNDS <= LOOKUP_ENTRIES + 1"
+#endif
+
 #endif
\ No newline at end of file
@@ -1,11 +1,24 @@
 #include "log.h"
+#include "config.h"
 #include <stdlib.h>
 #include <string.h>
 #include <unistd.h>   // isatty, fileno
 #include <stdbool.h>
 #include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <time.h>
 
-static log_level_t CURRENT_LEVEL = LOG_INFO;
+log_level_t log_current_level = LOG_INFO;
+
+// Asynchronous output: one single-producer ring per logging thread, drained by a writer thread
+// Rings for the PEs plus main, bus, memory, sampler and debugger CLI threads
+#define LOG_FIXED_THREADS   5
+#define LOG_MAX_THREADS     (NUM_PES + LOG_FIXED_THREADS)  // Threads beyond this log synchronously
+#define LOG_RING_SLOTS      1024    // Per-thread ring size (power of two)
+#define LOG_MSG_MAX         224     // Longer messages are truncated
+#define LOG_WRITER_IDLE_NS  200000  // Writer sleep when every ring is empty
 
 // Modo de color
 typedef enum {
@@ -16,7 +29,9 @@ typedef enum {
 
 static color_mode_t COLOR_MODE = COLOR_AUTO;
 static bool NO_COLOR_ENV = false; // Honor NO_COLOR standard
-static pthread_mutex_t LOG_MUTEX = PTHREAD_MUTEX_INITIALIZER; // Serialize output
+static bool STDOUT_TTY = false;   // isatty() cached by log_init (one syscall per line otherwise)
+static bool STDERR_TTY = false;
+static pthread_mutex_t LOG_MUTEX = PTHREAD_MUTEX_INITIALIZER; // Serialize synchronous output
 
 static log_level_t parse_level(const char* s) {
     if (!s) return LOG_INFO;
@@ -44,28 +59,43 @@ static bool should_color(FILE* out) {
         case COLOR_NEVER:  return false;
         case COLOR_AUTO:
         default:
+            if (out == stdout) return STDOUT_TTY;
+            if (out == stderr) return STDERR_TTY;
             return isatty(fileno(out));
     }
 }
 
-void log_init(void) {
-    const char* env = getenv("LOG_LEVEL");
-    CURRENT_LEVEL = parse_level(env);
-    const char* cenv = getenv("LOG_COLOR");
-    COLOR_MODE = parse_color_mode(cenv);
-    NO_COLOR_ENV = getenv("NO_COLOR") != NULL; // If defined, disable colors
-}
 
-void log_set_level(log_level_t level) { CURRENT_LEVEL = level; }
-log_level_t log_get_level(void) { return CURRENT_LEVEL; }
+typedef struct {
+    uint64_t seq;                   // Global order across threads
+    const char* module;             // LOG_MODULE string literal
+    log_level_t level;
+    char msg[LOG_MSG_MAX];
+} LogEntry;
 
-void log_log(log_level_t level, const char* module, const char* fmt, ...) {
+typedef struct {
+    _Alignas(64) _Atomic uint64_t head;   // Next slot to fill (owning thread)
+    _Alignas(64) _Atomic uint64_t tail;   // Next slot to write out (writer thread)
+    _Atomic(LogEntry*) slots;             // NULL until the owner has allocated it; never freed
+} LogRing;
+
+static LogRing RINGS[LOG_MAX_THREADS];
+static atomic_int NUM_RINGS;
+static _Thread_local LogRing* TLS_RING;
+static _Thread_local bool TLS_NO_RING;      // Claim failed: always synchronous
+
+static _Alignas(64) _Atomic uint64_t LOG_SEQ;   // Messages handed to the rings
+static _Alignas(64) _Atomic uint64_t WRITTEN;   // Messages written and flushed
+static atomic_bool ASYNC_ACTIVE;
+static bool ASYNC_STARTED;                  // The writer runs at most once per process
+static atomic_bool WRITER_STOP;
+static pthread_t WRITER;
+
+static void write_line(FILE* out, log_level_t level, const char* module, const char* msg) {
     const char* lvl = (level == LOG_ERROR) ? "ERROR" :
                       (level == LOG_WARN)  ? "WARN"  :
                       (level == LOG_INFO)  ? "INFO"  : "DEBUG";
 
-    FILE* out = (level <= LOG_WARN) ? stderr : stdout;
-
     const char* reset = "\x1b[0m";
     const char* level_color = NULL;
     const char* module_color = NULL;
@@ -80,27 +110,180 @@ void log_log(log_level_t level, const char* module, const char* fmt, ...) {
         module_color = "\x1b[0;34m"; // blue for module tag
     }
 
-    pthread_mutex_lock(&LOG_MUTEX);
     // Minimal format, no decorative ASCII
     if (level_color && module_color) {
-        fprintf(out, "%s[%s]%s%s[%s]%s ", level_color, lvl, reset, module_color, module, reset);
+        fprintf(out, "%s[%s]%s%s[%s]%s %s\n", level_color, lvl, reset, module_color, module, reset, msg);
     } else {
-        fprintf(out, "[%s][%s] ", lvl, module);
+        fprintf(out, "[%s][%s] %s\n", lvl, module, msg);
+    }
+}
+
+static FILE* stream_for(log_level_t level) {
+    return (level <= LOG_WARN) ? stderr : stdout;
+}
+
+// Format into buf without the trailing newline (write_line adds it)
+static void format_msg(char* buf, size_t size, const char* fmt, va_list args) {
+    int n = vsnprintf(buf, size, fmt, args);
+    size_t len = (n < 0) ? 0 : ((size_t)n < size ? (size_t)n : size - 1);
+    if (len > 0 && buf[len - 1] == '\n') {
+        buf[len - 1] = '\0';
+    }
+}
+
+// ============ Writer thread ============
+
+// Writes out every published entry in global sequence order. Returns how many.
+static uint64_t drain_rings(void) {
+    uint64_t written = 0;
+    int num_rings = atomic_load_explicit(&NUM_RINGS, memory_order_acquire);
+    if (num_rings > LOG_MAX_THREADS) num_rings = LOG_MAX_THREADS;
+
+    for (;;) {
+        LogRing* next = NULL;
+        LogEntry* next_entry = NULL;
+        for (int i = 0; i < num_rings; i++) {
+            LogRing* ring = &RINGS[i];
+            LogEntry* slots = atomic_load_explicit(&ring->slots, memory_order_acquire);
+            if (!slots) continue;
+            uint64_t tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+            if (tail == atomic_load_explicit(&ring->head, memory_order_acquire)) continue;
+            LogEntry* entry = &slots[tail & (LOG_RING_SLOTS - 1)];
+            if (!next_entry || entry->seq < next_entry->seq) {
+                next = ring;
+                next_entry = entry;
+            }
+        }
+        if (!next) break;
+
+        write_line(stream_for(next_entry->level), next_entry->level, next_entry->module, next_entry->msg);
+        atomic_fetch_add_explicit(&next->tail, 1, memory_order_release);
+        written++;
+    }
+
+    if (written > 0) {
+        fflush(stdout);
+        fflush(stderr);
+        atomic_fetch_add_explicit(&WRITTEN, written, memory_order_release);
+    }
+    return written;
+}
+
+static void* writer_main(void* arg) {
+    (void)arg;
+    const struct timespec idle = { 0, LOG_WRITER_IDLE_NS };
+    for (;;) {
+        // Read the stop flag before draining: the last pass sees everything published before it
+        bool stop = atomic_load_explicit(&WRITER_STOP, memory_order_acquire);
+        if (drain_rings() == 0) {
+            if (stop) break;
+            nanosleep(&idle, NULL);
+        }
+    }
+    return NULL;
+}
+
+// Claim this thread's ring on its first message
+static LogRing* thread_ring(void) {
+    if (TLS_RING || TLS_NO_RING) return TLS_RING;
+
+    int idx = atomic_fetch_add(&NUM_RINGS, 1);
+    LogEntry* slots = (idx < LOG_MAX_THREADS) ? malloc(sizeof(LogEntry) * LOG_RING_SLOTS) : NULL;
+    if (!slots) {
+        TLS_NO_RING = true;
+        return NULL;
     }
+    TLS_RING = &RINGS[idx];
+    atomic_store_explicit(&TLS_RING->slots, slots, memory_order_release);
+    return TLS_RING;
+}
+
+// ============ Public API ============
+
+void log_init(void) {
+    const char* env = getenv("LOG_LEVEL");
+    log_current_level = parse_level(env);
+    const char* cenv = getenv("LOG_COLOR");
+    COLOR_MODE = parse_color_mode(cenv);
+    NO_COLOR_ENV = getenv("NO_COLOR") != NULL; // If defined, disable colors
+    STDOUT_TTY = isatty(fileno(stdout));
+    STDERR_TTY = isatty(fileno(stderr));
+
+    const char* aenv = getenv("LOG_ASYNC");
+    if (ASYNC_STARTED || (aenv && atoi(aenv) == 0)) return;
+    ASYNC_STARTED = true;
+    if (pthread_create(&WRITER, NULL, writer_main, NULL) == 0) {
+        atomic_store_explicit(&ASYNC_ACTIVE, true, memory_order_release);
+        atexit(log_shutdown);
+    }
+}
+
+void log_set_level(log_level_t level) { log_current_level = level; }
+
+static void log_sync(log_level_t level, const char* module, const char* msg) {
+    FILE* out = stream_for(level);
+    pthread_mutex_lock(&LOG_MUTEX);
+    write_line(out, level, module, msg);
+    fflush(out);
+    pthread_mutex_unlock(&LOG_MUTEX);
+}
 
+void log_log(log_level_t level, const char* module, const char* fmt, ...) {
     va_list args;
     va_start(args, fmt);
-    vfprintf(out, fmt, args);
+
+    LogRing* ring = NULL;
+    // Errors go out immediately (after everything before them), the process may be about to die
+    if (level != LOG_ERROR && atomic_load_explicit(&ASYNC_ACTIVE, memory_order_acquire)) {
+        ring = thread_ring();
+    }
+
+    if (!ring) {
+        char buf[1024];
+        format_msg(buf, sizeof(buf), fmt, args);
+        va_end(args);
+        if (level == LOG_ERROR) log_flush();
+        log_sync(level, module, buf);
+        return;
+    }
+
+    // Single producer: only this thread advances head. Full ring: wait for the writer.
+    uint64_t head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+    while (head - atomic_load_explicit(&ring->tail, memory_order_acquire) >= LOG_RING_SLOTS) {
+        sched_yield();
+    }
+
+    LogEntry* entry = &atomic_load_explicit(&ring->slots, memory_order_relaxed)[head & (LOG_RING_SLOTS - 1)];
+    entry->seq = atomic_fetch_add_explicit(&LOG_SEQ, 1, memory_order_relaxed);
+    entry->module = module;
+    entry->level = level;
+    format_msg(entry->msg, sizeof(entry->msg), fmt, args);
     va_end(args);
 
-    // Ensure newline at end
-    size_t len = strlen(fmt);
-    if (len == 0 || fmt[len-1] != '\n') {
-        fputc('\n', out);
+    atomic_store_explicit(&ring->head, head + 1, memory_order_release);
+}
+
+void log_flush(void) {
+    if (atomic_load_explicit(&ASYNC_ACTIVE, memory_order_acquire)) {
+        uint64_t target = atomic_load_explicit(&LOG_SEQ, memory_order_acquire);
+        while (atomic_load_explicit(&WRITTEN, memory_order_acquire) < target) {
+            sched_yield();
+        }
     }
+    fflush(stdout);
+    fflush(stderr);
+}
 
-    fflush(out);
-    pthread_mutex_unlock(&LOG_MUTEX);
+void log_shutdown(void) {
+    if (!atomic_exchange(&ASYNC_ACTIVE, false)) return;
+
+    // New messages are synchronous from here on; the writer drains what is left
+    atomic_store_explicit(&WRITER_STOP, true, memory_order_release);
+    pthread_join(WRITER, NULL);
+
+    // The slots stay allocated: a thread that saw ASYNC_ACTIVE before the
+    // exchange may still be filling its ring (PE threads at atexit, or every
+    // thread when the debugger switches to synchronous output)
 }
 
 // ============ Public color helpers ============
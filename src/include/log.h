@@ -16,15 +16,34 @@ typedef enum {
     LOG_DEBUG = 3
 } log_level_t;
 
-// Initialize logger reading LOG_LEVEL env var (ERROR/WARN/INFO/DEBUG)
+// Minimum level compiled in (numeric, see log_level_t). Call sites above it
+// expand to dead code: `make LOG_COMPILE_LEVEL=2` removes every LOGD.
+#ifndef LOG_COMPILE_LEVEL
+#define LOG_COMPILE_LEVEL 3
+#endif
+
+// Initialize logger reading LOG_LEVEL env var (ERROR/WARN/INFO/DEBUG).
+// Unless LOG_ASYNC=0, also starts the background writer thread: each thread
+// formats into its own lock-free ring buffer and the writer drains them in
+// order. Pending messages are written at exit (atexit).
 void log_init(void);
 
 // Set/get log level at runtime
+extern log_level_t log_current_level;
 void log_set_level(log_level_t level);
-log_level_t log_get_level(void);
+static inline log_level_t log_get_level(void) { return log_current_level; }
 
 // Base logging implementation
-void log_log(log_level_t level, const char* module, const char* fmt, ...);
+void log_log(log_level_t level, const char* module, const char* fmt, ...)
+    __attribute__((format(printf, 3, 4)));
+
+// Wait until every message logged so far has been written (call before
+// printing to stdout directly so the output keeps program order)
+void log_flush(void);
+
+// Drain the rings, stop the writer and switch to synchronous output.
+// Messages logged concurrently with the call may be lost.
+void log_shutdown(void);
 
 // Color helpers for external use (e.g., statistics).
 // Return ANSI codes or empty string if color is disabled for stdout.
@@ -41,22 +60,36 @@ int log_colors_enabled_stdout(void);
 #define LOG_MODULE "APP"
 #endif
 
-// Convenience macros honoring current log level
-#define LOGE(fmt, ...) do { \
-    if (log_get_level() >= LOG_ERROR) log_log(LOG_ERROR, LOG_MODULE, fmt, ##__VA_ARGS__); \
+// Convenience macros honoring current log level. Levels above
+// LOG_COMPILE_LEVEL keep the call under if (0): arguments are still
+// type-checked but no code is generated.
+#define LOG_AT(level, fmt, ...) do { \
+    if (log_get_level() >= (level)) log_log((level), LOG_MODULE, fmt, ##__VA_ARGS__); \
 } while (0)
 
-#define LOGW(fmt, ...) do { \
-    if (log_get_level() >= LOG_WARN) log_log(LOG_WARN, LOG_MODULE, fmt, ##__VA_ARGS__); \
+#define LOG_ELIDED(level, fmt, ...) do { \
+    if (0) log_log((level), LOG_MODULE, fmt, ##__VA_ARGS__); \
 } while (0)
 
-#define LOGI(fmt, ...) do { \
-    if (log_get_level() >= LOG_INFO) log_log(LOG_INFO, LOG_MODULE, fmt, ##__VA_ARGS__); \
-} while (0)
+#define LOGE(fmt, ...) LOG_AT(LOG_ERROR, fmt, ##__VA_ARGS__)
 
-#define LOGD(fmt, ...) do { \
-    if (log_get_level() >= LOG_DEBUG) log_log(LOG_DEBUG, LOG_MODULE, fmt, ##__VA_ARGS__); \
-} while (0)
+#if LOG_COMPILE_LEVEL >= 1
+#define LOGW(fmt, ...) LOG_AT(LOG_WARN, fmt, ##__VA_ARGS__)
+#else
+#define LOGW(fmt, ...) LOG_ELIDED(LOG_WARN, fmt, ##__VA_ARGS__)
+#endif
+
+#if LOG_COMPILE_LEVEL >= 2
+#define LOGI(fmt, ...) LOG_AT(LOG_INFO, fmt, ##__VA_ARGS__)
+#else
+#define LOGI(fmt, ...) LOG_ELIDED(LOG_INFO, fmt, ##__VA_ARGS__)
+#endif
+
+#if LOG_COMPILE_LEVEL >= 3
+#define LOGD(fmt, ...) LOG_AT(LOG_DEBUG, fmt, ##__VA_ARGS__)
+#else
+#define LOGD(fmt, ...) LOG_ELIDED(LOG_DEBUG, fmt, ##__VA_ARGS__)
+#endif
 
 #ifdef __cplusplus
 }
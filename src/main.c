@@ -1,31 +1,122 @@
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 #include "config.h"
 #include "cache_stats.h"
 #include "memory_stats.h"
 #include "bus_stats.h"
+#include "sched_stats.h"
 #include "dotprod.h"
+#include "workload.h"
 #include "pe.h"
+#include "loader.h"
+#include "program_image.h"
+#include "memtrace.h"
+#include "scheduler.h"
 #include "bus.h"
 #include "memory.h"
 #include "log.h"
+#include "trace.h"
+#include "checkpoint.h"
+#include "fastforward.h"
+#include "sampler.h"
+#include "stats_export.h"
+#include "block_stats.h"
+#include "coherence_check.h"
 #include "debug/debug.h"
 
-int main() {
+// --assemble a.asm [b.asm ...]: write the binary images into PROGRAM_CACHE_DIR and exit
+static int assemble_only(int count, char** files) {
+    int failures = 0;
+    for (int i = 0; i < count; i++) {
+        Program* prog = load_program_cached(files[i]);
+        if (!prog) {
+            failures++;
+            continue;
+        }
+        log_flush();
+        printf("  %s: %d instructions\n", files[i], prog->size);
+        free_program(prog);
+    }
+    return failures ? 1 : 0;
+}
+
+int main(int argc, char** argv) {
     log_init();
+
+    if (argc > 1 && strcmp(argv[1], "--assemble") == 0) {
+        return assemble_only(argc - 2, argv + 2);
+    }
+
     LOGI("Starting MESI simulator - Parallel dot product");
 
+    // Binary event trace (enabled via SIM_TRACE=<file>)
+    if (trace_init() < 0) {
+        return 1;
+    }
+
+    // Checkpoint/restore (SIM_CHECKPOINT / SIM_RESTORE)
+    if (checkpoint_init() < 0) {
+        trace_close();
+        return 1;
+    }
+
+    // Functional fast-forward and sampling (SIM_FASTFWD / SIM_SAMPLE)
+    if (ff_init() < 0) {
+        trace_close();
+        return 1;
+    }
+
+    // Counter time series (SIM_STATS_SAMPLE / SIM_STATS_SERIES)
+    if (sampler_init() < 0) {
+        trace_close();
+        return 1;
+    }
+
+    // Tolerance of the result check (SIM_VERIFY_ULPS / SIM_VERIFY_RTOL)
+    if (dotprod_verify_init() < 0) {
+        trace_close();
+        return 1;
+    }
+
+    // Program and data of the simulated workload (SIM_WORKLOAD)
+    if (workload_init() < 0) {
+        trace_close();
+        return 1;
+    }
+
+    // Per-block contention and false sharing (SIM_HOTBLOCKS)
+    if (block_stats_init() < 0) {
+        trace_close();
+        return 1;
+    }
+
+    // Online coherence invariant checker (SIM_COHERENCE_CHECK)
+    if (coherence_check_init() < 0) {
+        trace_close();
+        return 1;
+    }
+
     // Initialize debugger (enabled via SIM_DEBUG=1)
     dbg_init();
 
+    // SIM_KERNEL=spmd or SIM_WORKLOAD: parse one program image and share it read-only
+    Program* shared_prog = NULL;
+    if (pe_load_shared_program(&shared_prog) < 0) {
+        trace_close();
+        dbg_shutdown();
+        return 1;
+    }
+
     // Initialize memory and create its thread
     Memory mem;
     mem_init(&mem);
 
-    // Initialize dot product input data in memory
-    dotprod_init_data(&mem);
-    
-    pthread_t mem_thread;
-    pthread_create(&mem_thread, NULL, mem_thread_func, &mem);
+    // Initialize the workload's input data in memory (a restored checkpoint
+    // already holds it, together with the rest of the state)
+    if (!checkpoint_restoring()) {
+        workload_init_data(&mem);
+    }
 
     Bus bus;
     Cache caches[NUM_PES];
@@ -49,14 +140,53 @@ int main() {
     // Provide context to debugger (bus, caches, PEs, memory)
     dbg_register_context(&bus, caches, NUM_PES, pes, &mem);
 
-    // Create bus thread
-    pthread_create(&bus_thread, NULL, bus_thread_func, &bus);
+    // Initialize PE scheduler (SIM_SCHED / SIM_QUANTUM)
+    Scheduler sched;
+    sched_init(&sched, NUM_PES);
 
-    // Initialize and create PE threads
+    // Initialize PEs
     for (int i = 0; i < NUM_PES; i++) {
         pes[i].id = i;
         pes[i].cache = &caches[i];
+        pes[i].sched = &sched;
+        pes[i].shared_prog = shared_prog;
+        pes[i].iterations = 0;
+        pes[i].finished = 0;
         reg_init(&pes[i].rf);  // Initialize register file
+    }
+
+    // Load the saved state before any simulator thread starts
+    checkpoint_register(&mem, &bus, caches, pes, &sched);
+    if (checkpoint_restoring() && checkpoint_restore() < 0) {
+        for (int i = 0; i < NUM_PES; i++) {
+            cache_destroy(&caches[i]);
+        }
+        bus_destroy(&bus);
+        mem_destroy(&mem);
+        sched_destroy(&sched);
+        if (shared_prog) {
+            free_program(shared_prog);
+        }
+        trace_close();
+        dbg_shutdown();
+        return 1;
+    }
+
+    // Start in functional mode if SIM_FASTFWD is set
+    ff_register(caches, &sched);
+
+    // Shadow MESI states for the checker, from the (possibly restored) caches
+    coherence_check_start(&bus);
+
+    // Create memory and bus threads
+    pthread_t mem_thread;
+    pthread_create(&mem_thread, NULL, mem_thread_func, &mem);
+    pthread_create(&bus_thread, NULL, bus_thread_func, &bus);
+
+    // Create PE threads
+    sched_start(&sched);
+    sampler_start(caches, &bus, &mem, &sched);
+    for (int i = 0; i < NUM_PES; i++) {
         pthread_create(&pe_threads[i], NULL, pe_run, &pes[i]);
     }
 
@@ -68,10 +198,27 @@ int main() {
         pthread_join(pe_threads[i], NULL);
 
     LOGI("All PEs finished execution");
+    sampler_stop();
+    checkpoint_finish();
+
+    if (shared_prog) {
+        free_program(shared_prog);
+    }
 
-    // Show dot product result. PEs already wrote back modified lines on HALT,
-    // so main memory contains the final values.
-    dotprod_print_results(&mem);
+    log_flush();
+
+    // Show the workload result. PEs already wrote back modified lines on HALT,
+    // so main memory contains the final values. A mismatch with the host
+    // reference makes the exit code non-zero (trace replay has no result).
+    int verify_rc = 0;
+    if (memtrace_dir()) {
+        printf("\n[Memory trace replay: %s]\n", memtrace_dir());
+        for (int i = 0; i < NUM_PES; i++) {
+            printf("  PE%d: accesses=%lu\n", i, (unsigned long)pes[i].trace_accesses);
+        }
+    } else {
+        verify_rc = workload_print_results(&mem);
+    }
 
     // Stop bus and join its thread
     bus_destroy(&bus);
@@ -81,18 +228,19 @@ int main() {
     mem_destroy(&mem);
     pthread_join(mem_thread, NULL);
 
+    trace_close();
+
     // Print per-PE statistics
     LOGI("Printing simulator statistics");
+    log_flush();
     
+    CacheStats stats_array[NUM_PES];
     for (int i = 0; i < NUM_PES; i++) {
-        stats_print(&caches[i].stats, i);
+        stats_snapshot(&caches[i].stats, &stats_array[i]);
+        stats_print(&stats_array[i], i);
     }
     
     // Print comparative summary
-    CacheStats stats_array[NUM_PES];
-    for (int i = 0; i < NUM_PES; i++) {
-        stats_array[i] = caches[i].stats;
-    }
     stats_print_summary(stats_array, NUM_PES);
 
     // Print memory statistics
@@ -101,12 +249,68 @@ int main() {
     // Print bus statistics
     bus_stats_print(&bus.stats);
 
+    // Print arbitration wait / service / round trip percentiles
+    bus_latency_print(&bus.latency);
+
+    // Invariant violations found after each bus transaction
+    coherence_check_print();
+
+    // Print the hottest blocks (trace replay addresses have no workload regions)
+    BlockRegionFn region = memtrace_dir() ? NULL : workload_block_regions;
+    block_stats_print(block_stats, region);
+
+    // Print scheduler statistics (fairness and host throughput)
+    sched_stats_print(&sched.stats, sched_mode_name(sched.mode),
+                      sched.mode == SCHED_QUANTUM ? sched.quantum : 0);
+    host_cpu_print(&sched.stats, &bus.cpu, &mem.cpu);
+
+    // Print the functional/detailed split (SIM_FASTFWD / SIM_SAMPLE)
+    ff_print_stats(&sched);
+
+    // Machine-readable export (SIM_STATS_JSON / SIM_STATS_CSV / SIM_STATS_SERIES)
+    int rc = verify_rc;
+    StatsReport report = {
+        .caches = stats_array,
+        .bus = &bus.stats,
+        .memory = &mem.stats,
+        .sched = &sched.stats,
+        .sched_mode = sched_mode_name(sched.mode),
+        .quantum = sched.mode == SCHED_QUANTUM ? sched.quantum : 0,
+        .blocks = block_stats,
+        .region = region,
+        .latency = &bus.latency,
+    };
+    size_t sample_count;
+    const StatsSample* samples = sampler_samples(&sample_count);
+    const char* json_path = getenv("SIM_STATS_JSON");
+    if (json_path && *json_path &&
+        stats_export_json(json_path, &report, samples, sample_count) < 0) {
+        LOGE("Could not write %s", json_path);
+        rc = 1;
+    }
+    const char* csv_path = getenv("SIM_STATS_CSV");
+    if (csv_path && *csv_path && stats_export_csv(csv_path, &report) < 0) {
+        LOGE("Could not write %s", csv_path);
+        rc = 1;
+    }
+    if (sampler_write_series() < 0) {
+        rc = 1;
+    }
+    if (coherence_check_violations() > 0) {
+        rc = 1;
+    }
+    sampler_free();
+    block_stats_free();
+    coherence_check_free();
+
     // Cleanup resources
     for (int i = 0; i < NUM_PES; i++) {
         cache_destroy(&caches[i]);
     }
 
+    sched_destroy(&sched);
+
     dbg_shutdown();
 
-    return 0;
+    return rc;
 }
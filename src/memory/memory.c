@@ -152,6 +152,7 @@ void* mem_thread_func(void* arg) {
         pthread_mutex_unlock(&mem->mutex);
     }
     
+    host_cpu_self(&mem->cpu);
     LOGD("Thread finished");
     return NULL;
 }
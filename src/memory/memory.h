@@ -3,6 +3,7 @@
 
 #include "config.h"
 #include "memory_stats.h"
+#include "sched_stats.h"
 #include <pthread.h>
 #include <stdbool.h>
 
@@ -39,7 +40,8 @@ typedef struct {
     MemRequest current_request;       // Current request
     bool has_request;                 // Pending request flag
     bool running;                     // Memory thread running flag
-    MemoryStats stats;                // Access statistics
+    _Alignas(HOST_CACHE_LINE) MemoryStats stats; // Access statistics (memory thread only)
+    HostCpu cpu;                      // Host CPU of the memory thread, taken when it exits
 } Memory;
 
 // PUBLIC API
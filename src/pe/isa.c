@@ -1,8 +1,9 @@
 #define LOG_MODULE "ISA"
 #include "isa.h"
+#include "simd.h"
+#include "fastforward.h"
 #include <stdio.h>
 #include <stdlib.h>
-#include <sched.h>  // for sched_yield()
 #include "log.h"
 
 const char* opcode_to_str(OpCode op) {
@@ -16,6 +17,23 @@ const char* opcode_to_str(OpCode op) {
         case OP_DEC:   return "DEC";
         case OP_JNZ:   return "JNZ";
         case OP_HALT:  return "HALT";
+        case OP_VLOAD:   return "VLOAD";
+        case OP_VSTORE:  return "VSTORE";
+        case OP_VFMUL:   return "VFMUL";
+        case OP_VFMA:    return "VFMA";
+        case OP_VREDUCE: return "VREDUCE";
+        case OP_FAA:     return "FAA";
+        case OP_CAS:     return "CAS";
+        case OP_LL:      return "LL";
+        case OP_SC:      return "SC";
+        case OP_MONITOR: return "MONITOR";
+        case OP_MWAIT:   return "MWAIT";
+        case OP_PEID:    return "PEID";
+        case OP_NPES:    return "NPES";
+        case OP_ROI:     return "ROI";
+        case OP_FADD_LOAD:   return "FADD_LOAD";
+        case OP_DEC_JNZ:     return "DEC_JNZ";
+        case OP_INC_DEC_JNZ: return "INC_DEC_JNZ";
         default:       return "UNKNOWN";
     }
 }
@@ -58,15 +76,93 @@ void print_instruction(Instruction* inst, uint64_t pc) {
         case OP_HALT:
             LOGD("PC=%lu HALT", pc);
             break;
+        case OP_VLOAD:
+        case OP_VSTORE:
+            if (inst->addr_mode == ADDR_DIRECT) {
+                LOGD("PC=%lu %s V%d, [%d]", pc, opcode_to_str(inst->op), inst->rd, inst->addr);
+            } else {
+                LOGD("PC=%lu %s V%d, [R%d]", pc, opcode_to_str(inst->op), inst->rd, inst->addr_reg);
+            }
+            break;
+        case OP_VFMUL:
+        case OP_VFMA:
+            LOGD("PC=%lu %s V%d, V%d, V%d", pc, opcode_to_str(inst->op), inst->rd, inst->ra, inst->rb);
+            break;
+        case OP_VREDUCE:
+            LOGD("PC=%lu VREDUCE R%d, V%d", pc, inst->rd, inst->ra);
+            break;
+        case OP_FAA:
+        case OP_CAS:
+            if (inst->addr_mode == ADDR_DIRECT) {
+                LOGD("PC=%lu %s R%d, R%d, [%d]", pc, opcode_to_str(inst->op), inst->rd, inst->ra, inst->addr);
+            } else {
+                LOGD("PC=%lu %s R%d, R%d, [R%d]", pc, opcode_to_str(inst->op), inst->rd, inst->ra, inst->addr_reg);
+            }
+            break;
+        case OP_LL:
+        case OP_SC:
+            if (inst->addr_mode == ADDR_DIRECT) {
+                LOGD("PC=%lu %s R%d, [%d]", pc, opcode_to_str(inst->op), inst->rd, inst->addr);
+            } else {
+                LOGD("PC=%lu %s R%d, [R%d]", pc, opcode_to_str(inst->op), inst->rd, inst->addr_reg);
+            }
+            break;
+        case OP_MONITOR:
+            if (inst->addr_mode == ADDR_DIRECT) {
+                LOGD("PC=%lu MONITOR [%d]", pc, inst->addr);
+            } else {
+                LOGD("PC=%lu MONITOR [R%d]", pc, inst->addr_reg);
+            }
+            break;
+        case OP_MWAIT:
+            LOGD("PC=%lu MWAIT", pc);
+            break;
+        case OP_ROI:
+            LOGD("PC=%lu ROI", pc);
+            break;
+        case OP_PEID:
+        case OP_NPES:
+            LOGD("PC=%lu %s R%d", pc, opcode_to_str(inst->op), inst->rd);
+            break;
+        case OP_FADD_LOAD:
+            LOGD("PC=%lu FADD_LOAD R%d, R%d, R%d -> LOAD R%d, [R%d]", pc,
+                 inst->addr_reg, inst->ra, inst->rb, inst->rd, inst->addr_reg);
+            break;
+        case OP_DEC_JNZ:
+            LOGD("PC=%lu DEC_JNZ R%d, %d", pc, inst->rd, inst->label);
+            break;
+        case OP_INC_DEC_JNZ:
+            LOGD("PC=%lu INC_DEC_JNZ R%d, R%d, %d", pc, inst->ra, inst->rd, inst->label);
+            break;
         default:
             LOGD("PC=%lu UNKNOWN", pc);
             break;
     }
 }
 
+// Vector memory access: BLOCK_SIZE words starting at addr, split at the
+// block boundary so each touched block is one cache access
+static void vector_access(Cache* cache, int addr, double* lanes, int is_store, int pe_id) {
+    int first = BLOCK_SIZE - GET_BLOCK_OFFSET(addr);
+    if (is_store) {
+        cache_write_span(cache, addr, lanes, first, pe_id);
+        if (first < BLOCK_SIZE) {
+            cache_write_span(cache, addr + first, lanes + first, BLOCK_SIZE - first, pe_id);
+        }
+    } else {
+        cache_read_span(cache, addr, lanes, first, pe_id);
+        if (first < BLOCK_SIZE) {
+            cache_read_span(cache, addr + first, lanes + first, BLOCK_SIZE - first, pe_id);
+        }
+    }
+}
+
 int execute_instruction(Instruction* inst, RegisterFile* rf, Cache* cache, int pe_id) {
     double val_a, val_b, result;
     int effective_addr;
+    double* vd;
+    double* va;
+    double* vb;
     
     // Optional instruction trace; keep concise to avoid noise
     LOGD("PE%d: executing instruction", pe_id);
@@ -167,6 +263,157 @@ int execute_instruction(Instruction* inst, RegisterFile* rf, Cache* cache, int p
             }
             break;
             
+        case OP_VLOAD:
+        case OP_VSTORE:
+            // VLOAD Vd, [addr|Rx] / VSTORE Vs, [addr|Rx] - whole-block transfer
+            vd = vreg_get(rf, inst->rd);
+            if (!vd) return 0;
+            if (inst->addr_mode == ADDR_DIRECT) {
+                effective_addr = inst->addr;
+            } else {
+                effective_addr = (int)reg_read(rf, inst->addr_reg);
+            }
+            LOGD("PE%d: %s V%d <-> memory[0x%X..0x%X]", pe_id, opcode_to_str(inst->op),
+                 inst->rd, effective_addr, effective_addr + BLOCK_SIZE - 1);
+            vector_access(cache, effective_addr, vd, inst->op == OP_VSTORE, pe_id);
+            rf->pc++;
+            break;
+
+        case OP_VFMUL:
+        case OP_VFMA:
+            // VFMUL Vd, Va, Vb / VFMA Vd, Va, Vb - lane-wise on the host SIMD unit
+            vd = vreg_get(rf, inst->rd);
+            va = vreg_get(rf, inst->ra);
+            vb = vreg_get(rf, inst->rb);
+            if (!vd || !va || !vb) return 0;
+            if (inst->op == OP_VFMUL) {
+                simd_fmul(vd, va, vb, BLOCK_SIZE);
+            } else {
+                simd_fma(vd, va, vb, BLOCK_SIZE);
+            }
+            LOGD("PE%d: %s V%d, V%d, V%d -> lane0=%.6f", pe_id, opcode_to_str(inst->op),
+                 inst->rd, inst->ra, inst->rb, vd[0]);
+            rf->pc++;
+            break;
+
+        case OP_VREDUCE:
+            // VREDUCE Rd, Va - horizontal sum into a scalar register
+            va = vreg_get(rf, inst->ra);
+            if (!va) return 0;
+            result = simd_reduce(va, BLOCK_SIZE);
+            LOGD("PE%d: VREDUCE V%d = %.6f -> R%d", pe_id, inst->ra, result, inst->rd);
+            reg_write(rf, inst->rd, result);
+            reg_update_zero_flag(rf, result);
+            rf->pc++;
+            break;
+
+        case OP_FAA:
+        case OP_CAS:
+        case OP_LL:
+        case OP_SC: {
+            // Atomic RMW - executed in the cache with the line in M
+            int ok = 1;
+            if (inst->addr_mode == ADDR_DIRECT) {
+                effective_addr = inst->addr;
+            } else {
+                effective_addr = (int)reg_read(rf, inst->addr_reg);
+            }
+            
+            if (inst->op == OP_FAA) {
+                cache_atomic(cache, ATOMIC_FAA, effective_addr, reg_read(rf, inst->ra), 0.0, &result, pe_id);
+                reg_write(rf, inst->rd, result);
+                LOGD("PE%d: FAA memory[0x%X] old=%.6f += R%d -> R%d", pe_id, effective_addr, result, inst->ra, inst->rd);
+            } else if (inst->op == OP_CAS) {
+                ok = cache_atomic(cache, ATOMIC_CAS, effective_addr, reg_read(rf, inst->ra),
+                                  reg_read(rf, inst->rd), &result, pe_id);
+                reg_write(rf, inst->rd, result);
+                rf->zero_flag = ok;
+                LOGD("PE%d: CAS memory[0x%X] old=%.6f success=%d", pe_id, effective_addr, result, ok);
+            } else if (inst->op == OP_LL) {
+                result = cache_load_linked(cache, effective_addr, pe_id);
+                reg_write(rf, inst->rd, result);
+                LOGD("PE%d: LL memory[0x%X] = %.6f -> R%d", pe_id, effective_addr, result, inst->rd);
+            } else {
+                ok = cache_atomic(cache, ATOMIC_SC, effective_addr, reg_read(rf, inst->rd), 0.0, NULL, pe_id);
+                rf->zero_flag = ok;
+                LOGD("PE%d: SC R%d -> memory[0x%X] success=%d", pe_id, inst->rd, effective_addr, ok);
+            }
+            rf->pc++;
+            break;
+        }
+
+        case OP_MONITOR:
+            // MONITOR - arm the monitor on the block of the effective address
+            if (inst->addr_mode == ADDR_DIRECT) {
+                effective_addr = inst->addr;
+            } else {
+                effective_addr = (int)reg_read(rf, inst->addr_reg);
+            }
+            cache_monitor(cache, effective_addr, pe_id);
+            rf->pc++;
+            break;
+
+        case OP_MWAIT:
+            // MWAIT - sleep until the monitor triggers (flags unchanged, so
+            // the polling loop that follows still sees the last comparison)
+            cache_mwait(cache, pe_id);
+            rf->pc++;
+            break;
+
+        case OP_PEID:
+            // PEID Rd - id of the executing PE (like MOV, flags unchanged)
+            reg_write(rf, inst->rd, (double)pe_id);
+            rf->pc++;
+            break;
+
+        case OP_NPES:
+            // NPES Rd - number of PEs in the system
+            reg_write(rf, inst->rd, (double)NUM_PES);
+            rf->pc++;
+            break;
+
+        case OP_ROI:
+            // ROI - marks the region of interest for the fast-forward controller
+            ff_roi_reached(pe_id);
+            rf->pc++;
+            break;
+
+        case OP_FADD_LOAD:
+            // FADD Rx, Ra, Rb + LOAD Rd, [Rx] - address compute and load.
+            // Rx and the zero flag are still written, as by the original pair.
+            val_a = reg_read(rf, inst->ra);
+            val_b = reg_read(rf, inst->rb);
+            result = val_a + val_b;
+            reg_write(rf, inst->addr_reg, result);
+            reg_update_zero_flag(rf, result);
+            effective_addr = (int)result;
+            LOGD("PE%d: FADD_LOAD memory[R%d=0x%X] -> R%d", pe_id, inst->addr_reg, effective_addr, inst->rd);
+
+            result = cache_read(cache, effective_addr, pe_id);
+            reg_write(rf, inst->rd, result);
+            LOGD("PE%d: R%d = %.6f", pe_id, inst->rd, result);
+            rf->pc += inst->span;
+            break;
+
+        case OP_INC_DEC_JNZ:
+            // INC Ra (its zero flag update is overwritten by DEC)
+            reg_write(rf, inst->ra, reg_read(rf, inst->ra) + 1.0);
+            /* fall through */
+        case OP_DEC_JNZ:
+            // DEC Rd + JNZ label - counter decrement and branch
+            result = reg_read(rf, inst->rd) - 1.0;
+            reg_write(rf, inst->rd, result);
+            reg_update_zero_flag(rf, result);
+            if (rf->zero_flag == 0) {
+                LOGD("PE%d: %s R%d=%.6f, jumping to PC=%d", pe_id, opcode_to_str(inst->op),
+                     inst->rd, result, inst->label);
+                rf->pc = inst->label;
+            } else {
+                LOGD("PE%d: %s R%d=0, no jump", pe_id, opcode_to_str(inst->op), inst->rd);
+                rf->pc += inst->span;
+            }
+            break;
+
         case OP_HALT:
             // HALT - end execution; write back modified lines via bus
             LOGD("PE%d: HALT writeback of modified lines", pe_id);
@@ -179,8 +426,5 @@ int execute_instruction(Instruction* inst, RegisterFile* rf, Cache* cache, int p
             return 0;
     }
     
-    // Yield CPU to simulate instruction time and allow fair scheduling
-    sched_yield();
-    
     return 1;  // Continue execution
 }
@@ -3,6 +3,7 @@
 
 #include "registers.h"
 #include "cache.h"
+#include <stddef.h>
 
 /**
  * @brief ISA operation codes
@@ -18,7 +19,36 @@ typedef enum {
     OP_INC,    // INC Rd             - Increment: Rd = Rd + 1
     OP_DEC,    // DEC Rd             - Decrement: Rd = Rd - 1
     OP_JNZ,    // JNZ label          - Jump if zero_flag == 0
-    OP_HALT    // HALT               - Terminate execution
+    OP_HALT,   // HALT               - Terminate execution
+
+    // Vector extension (BLOCK_SIZE lanes, registers V0-V3)
+    OP_VLOAD,    // VLOAD Vd, [addr|Rx]  - Load BLOCK_SIZE consecutive words
+    OP_VSTORE,   // VSTORE Vs, [addr|Rx] - Store BLOCK_SIZE consecutive words
+    OP_VFMUL,    // VFMUL Vd, Va, Vb     - Lane-wise multiply: Vd = Va * Vb
+    OP_VFMA,     // VFMA Vd, Va, Vb      - Lane-wise multiply-add: Vd = Vd + Va * Vb
+    OP_VREDUCE,  // VREDUCE Rd, Va       - Horizontal sum: Rd = sum(Va lanes)
+
+    // Atomic read-modify-write (line held exclusively through the bus)
+    OP_FAA,      // FAA Rd, Rs, [addr|Rx] - Rd = mem; mem = mem + Rs
+    OP_CAS,      // CAS Rd, Rs, [addr|Rx] - if mem == Rd: mem = Rs; Rd = old mem; zero_flag = success
+    OP_LL,       // LL Rd, [addr|Rx]      - Load and set reservation on the block
+    OP_SC,       // SC Rs, [addr|Rx]      - Store if reservation holds; zero_flag = success
+
+    // Monitor/wait (the PE sleeps instead of polling a block)
+    OP_MONITOR,  // MONITOR [addr|Rx]     - Arm a monitor on the block and bring it into the cache
+    OP_MWAIT,    // MWAIT                 - Sleep until the monitored block is written by another PE
+
+    // PE identity (SPMD programs shared by all PEs)
+    OP_PEID,     // PEID Rd               - Rd = id of the executing PE
+    OP_NPES,     // NPES Rd               - Rd = NUM_PES
+
+    // Simulation control (no architectural effect)
+    OP_ROI,      // ROI                   - Start of the region of interest (ends SIM_FASTFWD=roi)
+
+    // Superinstructions (created by optimize_program, never parsed from .asm)
+    OP_FADD_LOAD,   // FADD Rx, Ra, Rb + LOAD Rd, [Rx]  (addr_reg = Rx)
+    OP_DEC_JNZ,     // DEC Rd + JNZ label
+    OP_INC_DEC_JNZ  // INC Ra + DEC Rd + JNZ label
 } OpCode;
 
 /**
@@ -36,24 +66,41 @@ typedef enum {
  */
 typedef struct {
     OpCode op;              // Operation code
-    int rd;                 // Destination register
-    int ra;                 // Source register A
-    int rb;                 // Source register B
+    int rd;                 // Destination register (V register for vector ops)
+    int ra;                 // Source register A (V register for vector ops)
+    int rb;                 // Source register B (V register for vector ops)
+                            // FAA/CAS use ra as the value register Rs
     double imm;             // Immediate value (for MOV)
     int addr;               // Immediate address (for LOAD/STORE direct)
     int addr_reg;           // Register with address (for LOAD/STORE indirect)
     AddressingMode addr_mode; // Addressing mode (direct or indirect)
     int label;              // Jump target (for JNZ)
+    int span;               // Original instructions covered (1, or more if fused)
 } Instruction;
 
+/**
+ * @brief Basic block (straight-line code with a single entry)
+ */
+typedef struct {
+    int start;          // Index of the first instruction (leader)
+    int length;         // Number of original instructions
+    int fused;          // Superinstructions created inside the block
+} BasicBlock;
+
 /**
  * @brief Executable program
  *
- * Contains an array of instructions and its size
+ * Contains an array of instructions and its size. Fused superinstructions
+ * keep the original instruction indices: the fused instruction sits at the
+ * first slot and advances the PC by its span, so labels stay valid.
  */
 typedef struct {
     Instruction* code;  // Instruction array
     int size;           // Number of instructions
+    BasicBlock* blocks; // Basic blocks (filled by optimize_program, may be NULL)
+    int num_blocks;     // Number of basic blocks
+    void* image;        // mmap'ed binary image holding code (NULL if code was malloc'ed)
+    size_t image_size;  // Size of the mapping
 } Program;
 
 /**
@@ -4,6 +4,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include <ctype.h>
+#include <sys/mman.h>
 #include "log.h"
 
 #define MAX_LINE_LENGTH 256
@@ -86,6 +87,23 @@ static const char* opcode_to_string_local(OpCode op) {
         case OP_DEC:   return "DEC";
         case OP_JNZ:   return "JNZ";
         case OP_HALT:  return "HALT";
+        case OP_VLOAD:   return "VLOAD";
+        case OP_VSTORE:  return "VSTORE";
+        case OP_VFMUL:   return "VFMUL";
+        case OP_VFMA:    return "VFMA";
+        case OP_VREDUCE: return "VREDUCE";
+        case OP_FAA:     return "FAA";
+        case OP_CAS:     return "CAS";
+        case OP_LL:      return "LL";
+        case OP_SC:      return "SC";
+        case OP_MONITOR: return "MONITOR";
+        case OP_MWAIT:   return "MWAIT";
+        case OP_PEID:    return "PEID";
+        case OP_NPES:    return "NPES";
+        case OP_ROI:     return "ROI";
+        case OP_FADD_LOAD:   return "FADD_LOAD";
+        case OP_DEC_JNZ:     return "DEC_JNZ";
+        case OP_INC_DEC_JNZ: return "INC_DEC_JNZ";
         default:       return "UNKNOWN";
     }
 }
@@ -120,6 +138,20 @@ static OpCode parse_opcode(const char* str) {
     if (strcmp(str, "DEC") == 0)   return OP_DEC;
     if (strcmp(str, "JNZ") == 0)   return OP_JNZ;
     if (strcmp(str, "HALT") == 0)  return OP_HALT;
+    if (strcmp(str, "VLOAD") == 0)   return OP_VLOAD;
+    if (strcmp(str, "VSTORE") == 0)  return OP_VSTORE;
+    if (strcmp(str, "VFMUL") == 0)   return OP_VFMUL;
+    if (strcmp(str, "VFMA") == 0)    return OP_VFMA;
+    if (strcmp(str, "VREDUCE") == 0) return OP_VREDUCE;
+    if (strcmp(str, "FAA") == 0)     return OP_FAA;
+    if (strcmp(str, "CAS") == 0)     return OP_CAS;
+    if (strcmp(str, "LL") == 0)      return OP_LL;
+    if (strcmp(str, "SC") == 0)      return OP_SC;
+    if (strcmp(str, "MONITOR") == 0) return OP_MONITOR;
+    if (strcmp(str, "MWAIT") == 0)   return OP_MWAIT;
+    if (strcmp(str, "PEID") == 0)    return OP_PEID;
+    if (strcmp(str, "NPES") == 0)    return OP_NPES;
+    if (strcmp(str, "ROI") == 0)     return OP_ROI;
     return OP_HALT; // Default for unrecognized opcodes
 }
 
@@ -135,6 +167,40 @@ static int parse_register(const char* str) {
     return reg;
 }
 
+/**
+ * @brief Parse a vector register number (V0-V3) into its index
+ */
+static int parse_vregister(const char* str) {
+    if (str[0] != 'V' && str[0] != 'v') return -1;
+    
+    int reg = atoi(str + 1);
+    if (reg < 0 || reg >= NUM_VREGISTERS) return -1;
+    
+    return reg;
+}
+
+/**
+ * @brief Parse a memory operand ([number] or [Rx]) into an instruction
+ * @return 0 on success, -1 on error
+ */
+static int parse_mem_operand(char* addr_str, Instruction* inst, const char* opcode_str) {
+    char* trimmed_addr = trim(addr_str);
+    if (trimmed_addr[0] == 'R' || trimmed_addr[0] == 'r') {
+        // Indirect addressing [Rx]
+        inst->addr_reg = parse_register(trimmed_addr);
+        if (inst->addr_reg < 0) {
+            LOGE("Invalid address register in %s: [%s]", opcode_str, trimmed_addr);
+            return -1;
+        }
+        inst->addr_mode = ADDR_REGISTER;
+    } else {
+        // Direct addressing [number]
+        inst->addr = atoi(trimmed_addr);
+        inst->addr_mode = ADDR_DIRECT;
+    }
+    return 0;
+}
+
 /**
  * @brief Check if a line contains a label (format "NAME:")
  * @param rest If not NULL, stores the rest of the line after ':'
@@ -230,6 +296,7 @@ static int parse_line(const char* line, Instruction* inst, const LabelTable* lab
     inst->addr_reg = 0;
     inst->addr_mode = ADDR_DIRECT;
     inst->label = 0;
+    inst->span = 1;
     
     // Parse operands according to instruction type
     char* operands = trimmed + strlen(opcode_str);
@@ -334,7 +401,9 @@ static int parse_line(const char* line, Instruction* inst, const LabelTable* lab
             
         case OP_INC:
         case OP_DEC:
-            // INC/DEC Rd
+        case OP_PEID:
+        case OP_NPES:
+            // INC/DEC/PEID/NPES Rd
             if (sscanf(operands, "%7s", reg1) == 1) {
                 inst->rd = parse_register(reg1);
                 if (inst->rd < 0) {
@@ -378,8 +447,101 @@ static int parse_line(const char* line, Instruction* inst, const LabelTable* lab
             }
             break;
             
+        case OP_VLOAD:
+        case OP_VSTORE:
+            // VLOAD Vd, [addr|Rx] / VSTORE Vs, [addr|Rx]
+            if (sscanf(operands, "%7[^,], [%31[^]]]", reg1, addr_str) == 2) {
+                inst->rd = parse_vregister(trim(reg1));
+                if (inst->rd < 0) {
+                    LOGE("Invalid vector register in %s: %s", opcode_str, reg1);
+                    return -1;
+                }
+                if (parse_mem_operand(addr_str, inst, opcode_str) < 0) return -1;
+            } else {
+                LOGE("Invalid format for %s (use Vn, [addr] or Vn, [Rx]): %s", opcode_str, operands);
+                return -1;
+            }
+            break;
+            
+        case OP_VFMUL:
+        case OP_VFMA:
+            // VFMUL/VFMA Vd, Va, Vb
+            if (sscanf(operands, "%7s %7s %7s", reg1, reg2, reg3) == 3) {
+                inst->rd = parse_vregister(reg1);
+                inst->ra = parse_vregister(reg2);
+                inst->rb = parse_vregister(reg3);
+                if (inst->rd < 0 || inst->ra < 0 || inst->rb < 0) {
+                    LOGE("Invalid vector register in %s: %s %s %s", opcode_str, reg1, reg2, reg3);
+                    return -1;
+                }
+            } else {
+                LOGE("Invalid format for %s: %s", opcode_str, operands);
+                return -1;
+            }
+            break;
+            
+        case OP_VREDUCE:
+            // VREDUCE Rd, Va
+            if (sscanf(operands, "%7s %7s", reg1, reg2) == 2) {
+                inst->rd = parse_register(reg1);
+                inst->ra = parse_vregister(reg2);
+                if (inst->rd < 0 || inst->ra < 0) {
+                    LOGE("Invalid register in VREDUCE: %s %s", reg1, reg2);
+                    return -1;
+                }
+            } else {
+                LOGE("Invalid format for VREDUCE: %s", operands);
+                return -1;
+            }
+            break;
+            
+        case OP_FAA:
+        case OP_CAS:
+            // FAA/CAS Rd, Rs, [addr|Rx]
+            if (sscanf(operands, "%7[^,], %7[^,], [%31[^]]]", reg1, reg2, addr_str) == 3) {
+                inst->rd = parse_register(trim(reg1));
+                inst->ra = parse_register(trim(reg2));
+                if (inst->rd < 0 || inst->ra < 0) {
+                    LOGE("Invalid register in %s: %s %s", opcode_str, reg1, reg2);
+                    return -1;
+                }
+                if (parse_mem_operand(addr_str, inst, opcode_str) < 0) return -1;
+            } else {
+                LOGE("Invalid format for %s (use Rd, Rs, [addr] or Rd, Rs, [Rx]): %s", opcode_str, operands);
+                return -1;
+            }
+            break;
+            
+        case OP_LL:
+        case OP_SC:
+            // LL Rd, [addr|Rx] / SC Rs, [addr|Rx]
+            if (sscanf(operands, "%7[^,], [%31[^]]]", reg1, addr_str) == 2) {
+                inst->rd = parse_register(trim(reg1));
+                if (inst->rd < 0) {
+                    LOGE("Invalid register in %s: %s", opcode_str, reg1);
+                    return -1;
+                }
+                if (parse_mem_operand(addr_str, inst, opcode_str) < 0) return -1;
+            } else {
+                LOGE("Invalid format for %s (use Rd, [addr] or Rd, [Rx]): %s", opcode_str, operands);
+                return -1;
+            }
+            break;
+            
+        case OP_MONITOR:
+            // MONITOR [addr|Rx]
+            if (sscanf(operands, " [%31[^]]]", addr_str) == 1) {
+                if (parse_mem_operand(addr_str, inst, opcode_str) < 0) return -1;
+            } else {
+                LOGE("Invalid format for MONITOR (use [addr] or [Rx]): %s", operands);
+                return -1;
+            }
+            break;
+            
         case OP_HALT:
-            // HALT no tiene operandos
+        case OP_MWAIT:
+        case OP_ROI:
+            // HALT, MWAIT y ROI no tienen operandos
             break;
             
         default:
@@ -482,6 +644,10 @@ Program* load_program(const char* filename) {
     }
     
     prog->size = 0;
+    prog->blocks = NULL;
+    prog->num_blocks = 0;
+    prog->image = NULL;
+    prog->image_size = 0;
     line_num = 0;
     
     while (fgets(line, MAX_LINE_LENGTH, file)) {
@@ -525,11 +691,136 @@ Program* load_program(const char* filename) {
     return prog;
 }
 
+// ===== POST-LOAD OPTIMIZATION: basic blocks and superinstructions =====
+
+/**
+ * @brief Mark basic block leaders: entry, branch targets and fall-through after branches
+ */
+static void mark_leaders(const Program* prog, char* leader) {
+    memset(leader, 0, prog->size);
+    if (prog->size > 0) leader[0] = 1;
+    
+    for (int i = 0; i < prog->size; i++) {
+        const Instruction* inst = &prog->code[i];
+        if (inst->op == OP_JNZ) {
+            if (inst->label >= 0 && inst->label < prog->size) leader[inst->label] = 1;
+            if (i + 1 < prog->size) leader[i + 1] = 1;
+        } else if (inst->op == OP_HALT) {
+            if (i + 1 < prog->size) leader[i + 1] = 1;
+        }
+    }
+}
+
+/**
+ * @brief Try to fuse the sequence starting at pc (never past block_end)
+ * @return Number of instructions covered by the fused instruction, or 1 if none
+ */
+static int fuse_at(Program* prog, int pc, int block_end) {
+    Instruction* a = &prog->code[pc];
+    Instruction* b = (pc + 1 < block_end) ? &prog->code[pc + 1] : NULL;
+    Instruction* c = (pc + 2 < block_end) ? &prog->code[pc + 2] : NULL;
+    
+    // FADD Rx, Ra, Rb + LOAD Rd, [Rx] -> FADD_LOAD
+    if (b && a->op == OP_FADD && b->op == OP_LOAD &&
+        b->addr_mode == ADDR_REGISTER && b->addr_reg == a->rd) {
+        Instruction fused = *a;
+        fused.op = OP_FADD_LOAD;
+        fused.addr_reg = a->rd;
+        fused.addr_mode = ADDR_REGISTER;
+        fused.rd = b->rd;
+        fused.span = 2;
+        *a = fused;
+        return 2;
+    }
+    
+    // INC Ra + DEC Rd + JNZ label -> INC_DEC_JNZ
+    if (b && c && a->op == OP_INC && b->op == OP_DEC && c->op == OP_JNZ) {
+        Instruction fused = *c;
+        fused.op = OP_INC_DEC_JNZ;
+        fused.ra = a->rd;
+        fused.rd = b->rd;
+        fused.span = 3;
+        *a = fused;
+        return 3;
+    }
+    
+    // DEC Rd + JNZ label -> DEC_JNZ
+    if (b && a->op == OP_DEC && b->op == OP_JNZ) {
+        Instruction fused = *b;
+        fused.op = OP_DEC_JNZ;
+        fused.rd = a->rd;
+        fused.span = 2;
+        *a = fused;
+        return 2;
+    }
+    
+    return 1;
+}
+
+int optimize_program(Program* prog) {
+    if (!prog || prog->size == 0) return 0;
+    
+    char* leader = (char*)malloc(prog->size);
+    if (!leader) {
+        LOGE("Could not allocate memory for basic block analysis");
+        return -1;
+    }
+    mark_leaders(prog, leader);
+    
+    int num_blocks = 0;
+    for (int i = 0; i < prog->size; i++) {
+        if (leader[i]) num_blocks++;
+    }
+    
+    BasicBlock* blocks = (BasicBlock*)malloc(num_blocks * sizeof(BasicBlock));
+    if (!blocks) {
+        LOGE("Could not allocate memory for basic blocks");
+        free(leader);
+        return -1;
+    }
+    
+    // Build the block table and fuse inside each block. The fused instruction
+    // takes the first slot; the remaining slots are kept unchanged (they are
+    // never a jump target, since a block has a single entry).
+    int total_fused = 0;
+    int b = 0;
+    for (int start = 0; start < prog->size; ) {
+        int end = start + 1;
+        while (end < prog->size && !leader[end]) end++;
+        
+        blocks[b].start = start;
+        blocks[b].length = end - start;
+        blocks[b].fused = 0;
+        
+        for (int pc = start; pc < end; ) {
+            int span = fuse_at(prog, pc, end);
+            if (span > 1) blocks[b].fused++;
+            pc += span;
+        }
+        
+        LOGD("  Block %d: [%d-%d] fused=%d", b, start, end - 1, blocks[b].fused);
+        total_fused += blocks[b].fused;
+        b++;
+        start = end;
+    }
+    
+    free(leader);
+    free(prog->blocks);
+    prog->blocks = blocks;
+    prog->num_blocks = num_blocks;
+    
+    LOGI("Program optimized: %d basic blocks, %d superinstructions", num_blocks, total_fused);
+    return total_fused;
+}
+
 void free_program(Program* prog) {
     if (prog) {
-        if (prog->code) {
+        if (prog->image) {
+            munmap(prog->image, prog->image_size);
+        } else if (prog->code) {
             free(prog->code);
         }
+        free(prog->blocks);
         free(prog);
     }
 }
@@ -572,12 +863,63 @@ void print_program(const Program* prog) {
                 break;
             case OP_INC:
             case OP_DEC:
+            case OP_PEID:
+            case OP_NPES:
                 printf("R%d", inst->rd);
                 break;
             case OP_JNZ:
                 printf("%d (uses zero_flag)", inst->label);
                 break;
             case OP_HALT:
+            case OP_MWAIT:
+            case OP_ROI:
+                break;
+            case OP_MONITOR:
+                if (inst->addr_mode == ADDR_DIRECT) {
+                    printf("[%d]", inst->addr);
+                } else {
+                    printf("[R%d]", inst->addr_reg);
+                }
+                break;
+            case OP_VLOAD:
+            case OP_VSTORE:
+                if (inst->addr_mode == ADDR_DIRECT) {
+                    printf("V%d, [%d]", inst->rd, inst->addr);
+                } else {
+                    printf("V%d, [R%d]", inst->rd, inst->addr_reg);
+                }
+                break;
+            case OP_VFMUL:
+            case OP_VFMA:
+                printf("V%d, V%d, V%d", inst->rd, inst->ra, inst->rb);
+                break;
+            case OP_VREDUCE:
+                printf("R%d, V%d", inst->rd, inst->ra);
+                break;
+            case OP_FAA:
+            case OP_CAS:
+                if (inst->addr_mode == ADDR_DIRECT) {
+                    printf("R%d, R%d, [%d]", inst->rd, inst->ra, inst->addr);
+                } else {
+                    printf("R%d, R%d, [R%d]", inst->rd, inst->ra, inst->addr_reg);
+                }
+                break;
+            case OP_LL:
+            case OP_SC:
+                if (inst->addr_mode == ADDR_DIRECT) {
+                    printf("R%d, [%d]", inst->rd, inst->addr);
+                } else {
+                    printf("R%d, [R%d]", inst->rd, inst->addr_reg);
+                }
+                break;
+            case OP_FADD_LOAD:
+                printf("R%d, [R%d = R%d + R%d]", inst->rd, inst->addr_reg, inst->ra, inst->rb);
+                break;
+            case OP_DEC_JNZ:
+                printf("R%d, %d", inst->rd, inst->label);
+                break;
+            case OP_INC_DEC_JNZ:
+                printf("R%d, R%d, %d", inst->ra, inst->rd, inst->label);
                 break;
         }
         
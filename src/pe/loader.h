@@ -21,10 +21,21 @@
  *   DEC R1           # Decrementa R1
  *   JNZ R0 5         # Salta a línea 5 si R0 != 0
  *   HALT             # Termina ejecución
+ *   VLOAD V1, [R5]   # Carga BLOCK_SIZE palabras desde la dirección en R5
+ *   VFMA V0, V1, V2  # V0 += V1 * V2 (lane a lane)
+ *   VREDUCE R0, V0   # R0 = suma de los lanes de V0
+ *   FAA R6, R7, [R1] # Atómico: R6 = mem[R1]; mem[R1] += R7
+ *   CAS R6, R7, [R1] # Atómico: si mem[R1] == R6 entonces mem[R1] = R7
+ *   LL R6, [R1]      # Load-linked (reserva el bloque)
+ *   SC R7, [R1]      # Store-conditional (zero_flag = 1 si tuvo éxito)
+ *   MONITOR [R1]     # Arma un monitor sobre el bloque de mem[R1]
+ *   MWAIT            # Duerme hasta que otro PE escriba el bloque monitorizado
+ *   PEID R7          # R7 = id del PE que ejecuta (programas SPMD)
+ *   NPES R6          # R6 = NUM_PES
  * 
  * Notas:
  * - Líneas vacías y comentarios (que empiezan con #) son ignorados
- * - Los registros se especifican como R0-R7
+ * - Los registros se especifican como R0-R7 (vectoriales: V0-V3)
  * - Las direcciones de memoria y labels son números decimales
  */
 
@@ -38,6 +49,24 @@
  */
 Program* load_program(const char* filename);
 
+/**
+ * @brief Pasada de optimización post-carga sobre un Program
+ * 
+ * Descubre los bloques básicos (líderes: entrada, destinos de salto e
+ * instrucción siguiente a un salto/HALT) y dentro de cada bloque fusiona
+ * secuencias comunes en superinstrucciones:
+ *   FADD Rx, Ra, Rb + LOAD Rd, [Rx]  -> FADD_LOAD
+ *   INC Ra + DEC Rd + JNZ label      -> INC_DEC_JNZ
+ *   DEC Rd + JNZ label               -> DEC_JNZ
+ * 
+ * Los resultados arquitectónicos son idénticos y los accesos a memoria
+ * siguen pasando por la caché. Los índices de instrucción no cambian.
+ * 
+ * @param prog Programa a optimizar
+ * @return Número de superinstrucciones creadas, o -1 en caso de error
+ */
+int optimize_program(Program* prog);
+
 /**
  * @brief Libera la memoria de un programa cargado
  * 
@@ -0,0 +1,82 @@
+#define LOG_MODULE "MEMTRACE"
+#include "memtrace.h"
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "log.h"
+
+const char* memtrace_dir(void) {
+    const char* dir = getenv("SIM_MEMTRACE");
+    return (dir && *dir) ? dir : NULL;
+}
+
+int memtrace_open(MemTrace* trace, const char* path) {
+    memset(trace, 0, sizeof(*trace));
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return -1;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(MemTraceHeader)) {
+        LOGE("%s: not a memory trace (too short)", path);
+        close(fd);
+        return -1;
+    }
+
+    size_t size = (size_t)st.st_size;
+    void* map = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) {
+        LOGE("%s: mmap failed: %s", path, strerror(errno));
+        return -1;
+    }
+    madvise(map, size, MADV_SEQUENTIAL);
+
+    const MemTraceHeader* header = (const MemTraceHeader*)map;
+    const char* reason = NULL;
+    if (memcmp(header->magic, MEMTRACE_MAGIC, sizeof(MEMTRACE_MAGIC)) != 0) {
+        reason = "bad magic";
+    } else if (header->version != MEMTRACE_VERSION) {
+        reason = "version mismatch";
+    } else if (header->record_size != sizeof(MemTraceRecord)) {
+        reason = "record layout mismatch";
+    } else if ((size - sizeof(MemTraceHeader)) / sizeof(MemTraceRecord) < header->count) {
+        reason = "truncated";
+    }
+
+    if (reason) {
+        LOGE("%s: invalid memory trace (%s)", path, reason);
+        munmap(map, size);
+        return -1;
+    }
+
+    trace->records = (const MemTraceRecord*)((const char*)map + sizeof(MemTraceHeader));
+    trace->count = header->count;
+    trace->map = map;
+    trace->map_size = size;
+    return 0;
+}
+
+void memtrace_release(MemTrace* trace, uint64_t consumed) {
+    size_t page = (size_t)sysconf(_SC_PAGESIZE);
+    size_t end = sizeof(MemTraceHeader) + (size_t)consumed * sizeof(MemTraceRecord);
+    end -= end % page;
+    if (end > trace->released) {
+        // Read-only private mapping: dropped pages would simply be re-read from the file
+        madvise((char*)trace->map + trace->released, end - trace->released, MADV_DONTNEED);
+        trace->released = end;
+    }
+}
+
+void memtrace_close(MemTrace* trace) {
+    if (trace->map) {
+        munmap(trace->map, trace->map_size);
+    }
+    memset(trace, 0, sizeof(*trace));
+}
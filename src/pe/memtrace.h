@@ -0,0 +1,69 @@
+#ifndef MEMTRACE_H
+#define MEMTRACE_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+/**
+ * @file memtrace.h
+ * @brief Trazas de referencias a memoria para el modo trace-driven
+ *
+ * Con SIM_MEMTRACE=<dir> cada PE ignora la ISA y reproduce el archivo
+ * <dir>/pe<N>.mtr alimentando cache_read/cache_write directamente.
+ * Formato binario:
+ *
+ *   MemTraceHeader | MemTraceRecord[count]
+ *
+ * El archivo se mapea con mmap (solo lectura, acceso secuencial) y las
+ * páginas ya consumidas se liberan cada MEMTRACE_WINDOW registros, así que
+ * una traza de varios GB no ocupa RAM proporcional a su tamaño.
+ * scripts/memtrace_tool.py convierte trazas de texto y genera patrones.
+ */
+
+#define MEMTRACE_MAGIC   "MPMTRC"
+#define MEMTRACE_VERSION 1
+
+#define MEMTRACE_READ  0
+#define MEMTRACE_WRITE 1
+
+typedef struct {
+    char magic[8];          // MEMTRACE_MAGIC
+    uint32_t version;       // MEMTRACE_VERSION
+    uint32_t record_size;   // sizeof(MemTraceRecord)
+    uint64_t count;         // Number of records
+} MemTraceHeader;
+
+typedef struct {
+    uint32_t addr;          // Word address
+    uint8_t op;             // MEMTRACE_READ / MEMTRACE_WRITE
+    uint8_t reserved;
+    uint16_t gap;           // Non-memory instructions before this access
+} MemTraceRecord;
+
+typedef struct {
+    const MemTraceRecord* records;
+    uint64_t count;
+    void* map;              // Whole file mapping
+    size_t map_size;
+    size_t released;        // Bytes at the start of the mapping already dropped
+} MemTrace;
+
+/**
+ * @brief Directorio de trazas (SIM_MEMTRACE), NULL si el modo está desactivado
+ */
+const char* memtrace_dir(void);
+
+/**
+ * @brief Mapea una traza y valida su cabecera
+ * @return 0 si OK, -1 si no existe o no es válida
+ */
+int memtrace_open(MemTrace* trace, const char* path);
+
+/**
+ * @brief Libera las páginas de los registros [0, consumed) ya reproducidos
+ */
+void memtrace_release(MemTrace* trace, uint64_t consumed);
+
+void memtrace_close(MemTrace* trace);
+
+#endif // MEMTRACE_H
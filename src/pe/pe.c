@@ -3,48 +3,189 @@
 #include "registers.h"
 #include "isa.h"
 #include "loader.h"
+#include "program_image.h"
+#include "memtrace.h"
+#include "workload.h"
+#include "fastforward.h"
 #include <stdio.h>
 #include <unistd.h>
 #include <stdlib.h>
+#include <string.h>
 #include "log.h"
 #include "debug/debug.h"
 
+Program* pe_load_program(const char* filename) {
+    Program* prog = load_program_cached(filename);
+    if (!prog) {
+        return NULL;
+    }
+
+    // Superinstruction fusion (SIM_FUSE=0 disables it). Skipped under the
+    // debugger so that every original PC can be stepped and breakpointed.
+    const char* env_fuse = getenv("SIM_FUSE");
+    int fuse = !(env_fuse && atoi(env_fuse) == 0);
+    if (fuse && !dbg_enabled()) {
+        optimize_program(prog);
+    }
+    return prog;
+}
+
+int pe_program_path(int pe_id, char* out, size_t size) {
+    // Workloads other than dotprod have a single SPMD program,
+    // SIM_KERNEL=spmd the shared dot-product image,
+    // SIM_KERNEL=vector selects the block-wide vectorized kernel,
+    // SIM_KERNEL=atomic the FAA counter-barrier kernel,
+    // SIM_KERNEL=opt the peephole-optimized scalar kernel.
+    const char* env_kernel = getenv("SIM_KERNEL");
+    const char* path_fmt = ASM_DOTPROD_PE_PATH_FMT;
+    if (workload_program_path()) {
+        snprintf(out, size, "%s", workload_program_path());
+        return 1;
+    } else if (env_kernel && strcmp(env_kernel, "spmd") == 0) {
+        snprintf(out, size, "%s", ASM_DOTPROD_SPMD_PATH);
+        return 1;
+    } else if (env_kernel && strcmp(env_kernel, "vector") == 0) {
+        path_fmt = ASM_DOTPROD_VEC_PE_PATH_FMT;
+    } else if (env_kernel && strcmp(env_kernel, "atomic") == 0) {
+        path_fmt = ASM_DOTPROD_ATOMIC_PE_PATH_FMT;
+    } else if (env_kernel && strcmp(env_kernel, "opt") == 0) {
+        path_fmt = ASM_DOTPROD_OPT_PE_PATH_FMT;
+    }
+    snprintf(out, size, path_fmt, pe_id);
+    return 0;
+}
+
+int pe_load_shared_program(Program** prog) {
+    char path[256];
+    *prog = NULL;
+    if (!pe_program_path(0, path, sizeof(path))) {
+        return 0;
+    }
+
+    *prog = pe_load_program(path);
+    if (!*prog) {
+        LOGE("Could not load SPMD program %s", path);
+        return -1;
+    }
+    if ((*prog)->size > CODE_REGION_SIZE) {
+        LOGE("SPMD program %s has %d instructions, the code region holds %d",
+             path, (*prog)->size, CODE_REGION_SIZE);
+        free_program(*prog);
+        *prog = NULL;
+        return -1;
+    }
+    LOGI("SPMD program loaded once for %d PEs, instructions=%d", NUM_PES, (*prog)->size);
+    return 0;
+}
+
+// Trace-driven mode: feed <dir>/pe<N>.mtr to the cache, bypassing the ISA
+static void pe_replay_memtrace(PE* pe, const char* dir) {
+    char path[512];
+    snprintf(path, sizeof(path), "%s/pe%d.mtr", dir, pe->id);
+
+    MemTrace trace;
+    if (memtrace_open(&trace, path) < 0) {
+        LOGW("PE%d: no memory trace %s, idle", pe->id, path);
+        sched_pe_exit(pe->sched, pe->id);
+        return;
+    }
+    LOGI("PE%d: replaying %s (%lu accesses)", pe->id, path, (unsigned long)trace.count);
+
+    uint64_t i;
+    for (i = 0; i < trace.count; i++) {
+        const MemTraceRecord* rec = &trace.records[i];
+        if (rec->addr >= MEM_SIZE || rec->op > MEMTRACE_WRITE) {
+            LOGE("PE%d: invalid trace record %lu (op=%d addr=0x%X)",
+                 pe->id, (unsigned long)i, rec->op, rec->addr);
+            break;
+        }
+
+        uint64_t bus_before = stats_bus_requests(&pe->cache->stats);
+        if (rec->op == MEMTRACE_WRITE) {
+            cache_write(pe->cache, (int)rec->addr, (double)i, pe->id);
+        } else {
+            cache_read(pe->cache, (int)rec->addr, pe->id);
+        }
+
+        // The gap counts as retired instructions for the quantum
+        int used_bus = stats_bus_requests(&pe->cache->stats) != bus_before;
+        sched_after_instruction(pe->sched, pe->id, 1 + rec->gap, used_bus);
+
+        if ((i + 1) % MEMTRACE_WINDOW == 0) {
+            memtrace_release(&trace, i + 1);
+        }
+    }
+    pe->trace_accesses = i;
+
+    // Same end of run as HALT: write back modified lines, leave the scheduler
+    cache_flush(pe->cache, pe->id);
+    sched_pe_exit(pe->sched, pe->id);
+    memtrace_close(&trace);
+    LOGI("PE%d: trace replay finished, accesses=%lu", pe->id, (unsigned long)i);
+}
+
 void* pe_run(void* arg) {
     PE* pe = (PE*)arg;
     LOGD("PE%d: starting thread", pe->id);
     
+    pe->trace_accesses = 0;
+    const char* trace_dir = memtrace_dir();
+    if (trace_dir) {
+        pe_replay_memtrace(pe, trace_dir);
+        return NULL;
+    }
+    
     // ===== LOAD PROGRAM FROM FILE =====
     // Each PE executes its portion of the parallel dot product
-    // PE0-PE2: compute partial products
-    // PE3: compute partial product + final reduction
+    // PE0..PE(NUM_PES-2): compute partial products
+    // Last PE (master): partial product + final reduction
+    // With SIM_KERNEL=spmd all PEs share one image (pe->shared_prog)
     
-    const char* program_files[] = {
-    ASM_DOTPROD_PE0_PATH,   // PE0: elements [0-3]
-    ASM_DOTPROD_PE1_PATH,   // PE1: elements [4-7]
-    ASM_DOTPROD_PE2_PATH,   // PE2: elements [8-11]
-    ASM_DOTPROD_PE3_PATH    // PE3: elements [12-15] + reduction
-    };
-    
-    const char* filename = program_files[pe->id];
-    
-    LOGI("PE%d: loading program", pe->id);
-    LOGD("PE%d: file=%s", pe->id, filename);
-    
-    Program* prog = load_program(filename);
+    Program* own_prog = NULL;
+    const Program* prog = pe->shared_prog;
     
     if (!prog) {
-    LOGE("PE%d: could not load program %s", pe->id, filename);
-        return NULL;
+        char filename[256];
+        pe_program_path(pe->id, filename, sizeof(filename));
+        
+        LOGI("PE%d: loading program", pe->id);
+        LOGD("PE%d: file=%s", pe->id, filename);
+        
+        own_prog = pe_load_program(filename);
+        
+        if (!own_prog) {
+        LOGE("PE%d: could not load program %s", pe->id, filename);
+            sched_pe_exit(pe->sched, pe->id);
+            return NULL;
+        }
+        if (own_prog->size > CODE_SLOT_SIZE) {
+            LOGE("PE%d: program %s has %d instructions, its code slot holds %d",
+                 pe->id, filename, own_prog->size, CODE_SLOT_SIZE);
+            free_program(own_prog);
+            sched_pe_exit(pe->sched, pe->id);
+            return NULL;
+        }
+        prog = own_prog;
     }
     
     LOGI("PE%d: program loaded, instructions=%d", pe->id, prog->size);
     
+    // SIM_MWAIT=0 turns MWAIT into a no-op, so wait loops poll as before
+    const char* env_mwait = getenv("SIM_MWAIT");
+    pe->cache->mwait_enabled = !(env_mwait && atoi(env_mwait) == 0);
+    
+    // SIM_ICACHE=0 makes instruction fetch free (no I-cache, no BUS_IFETCH)
+    const char* env_icache = getenv("SIM_ICACHE");
+    pe->cache->icache.enabled = !(env_icache && atoi(env_icache) == 0);
+    
+    // Code slot of this program in CODE_REGION (shared SPMD image: the whole region)
+    int code_base = CODE_REGION_BASE + (pe->shared_prog ? 0 : pe->id) * CODE_SLOT_SIZE;
+    
     LOGI("PE%d: starting execution", pe->id);
     
-    // Run program
-    pe->rf.pc = 0;
-    int running = 1;
-    int iterations = 0;
+    // Run program. The register file (PC included) comes from main: zeroed by
+    // reg_init, or the saved state when resuming from a checkpoint (SIM_RESTORE)
+    int running = !pe->finished;
 
     // Allow overriding the max iterations via environment variable.
     // SIM_MAX_ITERS: if set to 0 or negative, run without an iteration cap.
@@ -55,7 +196,7 @@ void* pe_run(void* arg) {
         max_iterations = val;
     }
     
-    while (running && (max_iterations <= 0 || iterations < max_iterations)) {
+    while (running && (max_iterations <= 0 || pe->iterations < max_iterations)) {
         if (pe->rf.pc >= (uint64_t)prog->size) {
          LOGE("PE%d: PC out of range (%lu >= %d)", pe->id, pe->rf.pc, prog->size);
             break;
@@ -64,25 +205,54 @@ void* pe_run(void* arg) {
         // Debugger hook: pause/step before executing
         dbg_before_instruction(pe->id, pe->rf.pc, &prog->code[pe->rf.pc]);
         
+        uint64_t bus_before = stats_bus_requests(&pe->cache->stats);
+        int span = prog->code[pe->rf.pc].span;
+        
+        // Fetch every code block covered by the instruction (span > 1 if fused)
+        int fetch_first = (int)pe->rf.pc;
+        int fetch_last = (int)(pe->rf.pc + span - 1);
+        cache_fetch(pe->cache, code_base + fetch_first, pe->id);
+        if (GET_BLOCK_BASE(fetch_last) != GET_BLOCK_BASE(fetch_first)) {
+            cache_fetch(pe->cache, code_base + fetch_last, pe->id);
+        }
+        // MWAIT may sleep: do not hold the other PEs at the quantum barrier
+        int parks = prog->code[pe->rf.pc].op == OP_MWAIT && pe->cache->mwait_enabled;
+        if (parks) sched_pe_park(pe->sched, pe->id);
+        int roi = prog->code[pe->rf.pc].op == OP_ROI;
         running = execute_instruction(&prog->code[pe->rf.pc], 
                                       &pe->rf, 
                                       pe->cache, 
                                       pe->id);
-        iterations++;
+        if (parks) sched_pe_unpark(pe->sched, pe->id);
+        pe->iterations++;
+
+        // Quantum accounting: a bus request ends the current quantum
+        if (running) {
+            int used_bus = stats_bus_requests(&pe->cache->stats) != bus_before;
+            sched_after_instruction(pe->sched, pe->id, span, used_bus);
+            // ROI ends the quantum: SIM_FASTFWD=roi switches at the next barrier
+            if (roi && ff_waiting_for_roi()) sched_end_quantum(pe->sched, pe->id);
+        }
     }
+
+    // HALT, error or iteration cap: stop taking part in quantum barriers
+    pe->finished = 1;
+    sched_pe_exit(pe->sched, pe->id);
     
-    if (max_iterations > 0 && iterations >= max_iterations) {
+    if (max_iterations > 0 && pe->iterations >= max_iterations) {
         LOGW("PE%d: maximum number of iterations reached (%d)", pe->id, max_iterations);
     }
     
     LOGI("PE%d: execution finished", pe->id);
-    LOGI("PE%d: iterations executed=%d", pe->id, iterations);
+    LOGI("PE%d: iterations executed=%d", pe->id, pe->iterations);
     
     // Print final register state
     reg_print(&pe->rf, pe->id);
     
-    // Free program memory
-    free_program(prog);
+    // Free program memory (the shared SPMD image is freed by main)
+    if (own_prog) {
+        free_program(own_prog);
+    }
     
     LOGD("PE%d: done", pe->id);
     return NULL;
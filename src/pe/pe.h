@@ -3,14 +3,34 @@
 
 #include "cache.h"
 #include "registers.h"
+#include "scheduler.h"
+#include "isa.h"
 #include <pthread.h>
 
 typedef struct {
     int id;
     RegisterFile rf;  // Banco de registros
     Cache* cache;
+    Scheduler* sched; // Planificador compartido
+    const Program* shared_prog; // Programa SPMD compartido (solo lectura), NULL = archivo propio
+    uint64_t trace_accesses;    // Accesos reproducidos en modo trace-driven (SIM_MEMTRACE)
+    int iterations;             // Instrucciones ejecutadas (límite SIM_MAX_ITERS)
+    int finished;               // Salió del bucle de ejecución (HALT, error o límite)
 } PE;
 
 void* pe_run(void* arg);
 
+// Ruta del programa de un PE según SIM_WORKLOAD/SIM_KERNEL. Retorna 1 si es una
+// imagen SPMD (el mismo archivo para todos los PEs), 0 si es propia del PE.
+int pe_program_path(int pe_id, char* out, size_t size);
+
+// Carga un programa (vía la imagen binaria en caché) y aplica la fusión de superinstrucciones
+// (salvo SIM_FUSE=0 o con el depurador activo)
+Program* pe_load_program(const char* filename);
+
+// Programa SPMD único para todos los PEs si pe_program_path lo indica (*prog = NULL si
+// cada PE carga su propio archivo). Se parsea una sola vez y se libera en main.
+// Retorna 0 si OK, -1 si el programa SPMD no pudo cargarse.
+int pe_load_shared_program(Program** prog);
+
 #endif
@@ -0,0 +1,199 @@
+#define LOG_MODULE "PROGIMG"
+#include "program_image.h"
+#include "loader.h"
+#include "config.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "log.h"
+
+#define FNV_OFFSET_BASIS 0xcbf29ce484222325ull
+#define FNV_PRIME        0x100000001b3ull
+
+// HASH
+
+int program_source_hash(const char* path, uint64_t* hash) {
+    FILE* file = fopen(path, "rb");
+    if (!file) {
+        return -1;
+    }
+
+    uint64_t h = FNV_OFFSET_BASIS;
+    unsigned char buf[4096];
+    size_t n;
+    while ((n = fread(buf, 1, sizeof(buf), file)) > 0) {
+        for (size_t i = 0; i < n; i++) {
+            h ^= buf[i];
+            h *= FNV_PRIME;
+        }
+    }
+    int err = ferror(file);
+    fclose(file);
+    if (err) {
+        return -1;
+    }
+
+    *hash = h;
+    return 0;
+}
+
+// WRITE
+
+int program_image_write(const Program* prog, uint64_t source_hash, const char* path) {
+    ProgramImageHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, PROGRAM_IMAGE_MAGIC, sizeof(PROGRAM_IMAGE_MAGIC));
+    header.version = PROGRAM_IMAGE_VERSION;
+    header.inst_size = (uint32_t)sizeof(Instruction);
+    header.source_hash = source_hash;
+    header.count = (uint32_t)prog->size;
+
+    // Unique temporary name, then rename(): readers see the old image or the new one
+    char tmp_path[512];
+    snprintf(tmp_path, sizeof(tmp_path), "%s.XXXXXX", path);
+    int fd = mkstemp(tmp_path);
+    if (fd < 0) {
+        LOGW("Could not create %s: %s", tmp_path, strerror(errno));
+        return -1;
+    }
+
+    fchmod(fd, 0644);  // mkstemp creates 0600
+
+    FILE* file = fdopen(fd, "wb");
+    if (!file) {
+        close(fd);
+        unlink(tmp_path);
+        return -1;
+    }
+
+    int ok = fwrite(&header, sizeof(header), 1, file) == 1 &&
+             fwrite(prog->code, sizeof(Instruction), (size_t)prog->size, file) == (size_t)prog->size;
+    ok = (fclose(file) == 0) && ok;
+
+    if (!ok || rename(tmp_path, path) != 0) {
+        LOGW("Could not write program image %s", path);
+        unlink(tmp_path);
+        return -1;
+    }
+
+    LOGD("Wrote image %s (%d instructions, hash=%016lx)", path, prog->size, source_hash);
+    return 0;
+}
+
+// LOAD
+
+Program* program_image_load(const char* path, uint64_t source_hash) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return NULL;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(ProgramImageHeader)) {
+        close(fd);
+        return NULL;
+    }
+
+    size_t size = (size_t)st.st_size;
+    // Private writable mapping: optimize_program fuses in place (copy-on-write)
+    void* map = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) {
+        return NULL;
+    }
+
+    const ProgramImageHeader* header = (const ProgramImageHeader*)map;
+    const char* reason = NULL;
+    if (memcmp(header->magic, PROGRAM_IMAGE_MAGIC, sizeof(PROGRAM_IMAGE_MAGIC)) != 0) {
+        reason = "bad magic";
+    } else if (header->version != PROGRAM_IMAGE_VERSION) {
+        reason = "version mismatch";
+    } else if (header->inst_size != sizeof(Instruction)) {
+        reason = "instruction layout mismatch";
+    } else if (header->source_hash != source_hash) {
+        reason = "source changed";
+    } else if (size != sizeof(ProgramImageHeader) + (size_t)header->count * sizeof(Instruction)) {
+        reason = "truncated";
+    }
+
+    if (reason) {
+        LOGD("Stale image %s (%s)", path, reason);
+        munmap(map, size);
+        return NULL;
+    }
+
+    Program* prog = (Program*)malloc(sizeof(Program));
+    if (!prog) {
+        munmap(map, size);
+        return NULL;
+    }
+    prog->code = (Instruction*)((char*)map + sizeof(ProgramImageHeader));
+    prog->size = (int)header->count;
+    prog->blocks = NULL;
+    prog->num_blocks = 0;
+    prog->image = map;
+    prog->image_size = size;
+    return prog;
+}
+
+// CACHED LOAD
+
+// PROGRAM_CACHE_DIR/<basename without .asm>.bin
+static void image_path_for(const char* asm_path, char* out, size_t out_size) {
+    const char* base = strrchr(asm_path, '/');
+    base = base ? base + 1 : asm_path;
+    size_t len = strlen(base);
+    if (len > 4 && strcmp(base + len - 4, ".asm") == 0) {
+        len -= 4;
+    }
+    snprintf(out, out_size, "%s/%.*s.bin", PROGRAM_CACHE_DIR, (int)len, base);
+}
+
+// mkdir -p for PROGRAM_CACHE_DIR
+static int ensure_cache_dir(void) {
+    char dir[256];
+    snprintf(dir, sizeof(dir), "%s", PROGRAM_CACHE_DIR);
+    for (char* p = dir + 1; *p; p++) {
+        if (*p == '/') {
+            *p = '\0';
+            if (mkdir(dir, 0755) != 0 && errno != EEXIST) return -1;
+            *p = '/';
+        }
+    }
+    if (mkdir(dir, 0755) != 0 && errno != EEXIST) return -1;
+    return 0;
+}
+
+Program* load_program_cached(const char* asm_path) {
+    const char* env_cache = getenv("SIM_PROGCACHE");
+    if (env_cache && atoi(env_cache) == 0) {
+        return load_program(asm_path);
+    }
+
+    uint64_t hash;
+    if (program_source_hash(asm_path, &hash) != 0) {
+        LOGE("Could not open file: %s", asm_path);
+        return NULL;
+    }
+
+    char image_path[512];
+    image_path_for(asm_path, image_path, sizeof(image_path));
+
+    Program* prog = program_image_load(image_path, hash);
+    if (prog) {
+        LOGI("Mapped %s (%d instructions, no parsing)", image_path, prog->size);
+        return prog;
+    }
+
+    // Miss or stale image: assemble from the text source
+    prog = load_program(asm_path);
+    if (prog && ensure_cache_dir() == 0) {
+        program_image_write(prog, hash, image_path);
+    }
+    return prog;
+}
@@ -0,0 +1,70 @@
+#ifndef PROGRAM_IMAGE_H
+#define PROGRAM_IMAGE_H
+
+#include "isa.h"
+#include <stdint.h>
+
+/**
+ * @file program_image.h
+ * @brief Imagen binaria precompilada de un programa (.asm ensamblado)
+ *
+ * El .asm sigue siendo la fuente. La imagen guarda el arreglo de
+ * Instruction ya decodificado, precedido por una cabecera:
+ *
+ *   magic "MPPROG" | versión | sizeof(Instruction) | hash FNV-1a del .asm | nº instrucciones
+ *
+ * Al cargar se mapea el archivo con mmap (MAP_PRIVATE) y Program.code apunta
+ * directamente a las instrucciones: no hay parseo. Una imagen con otra
+ * versión, otro layout de Instruction o un hash distinto al del .asm actual
+ * se considera obsoleta y se regenera.
+ *
+ * Variables de entorno:
+ *   SIM_PROGCACHE=0   desactiva la caché (siempre parsea el texto)
+ */
+
+#define PROGRAM_IMAGE_MAGIC   "MPPROG"
+#define PROGRAM_IMAGE_VERSION 1
+
+typedef struct {
+    char magic[8];          // PROGRAM_IMAGE_MAGIC
+    uint32_t version;       // PROGRAM_IMAGE_VERSION
+    uint32_t inst_size;     // sizeof(Instruction) when the image was written
+    uint64_t source_hash;   // FNV-1a 64 of the .asm contents
+    uint32_t count;         // Number of instructions
+    uint32_t reserved;      // Keeps the instruction array 8-byte aligned
+} ProgramImageHeader;
+
+/**
+ * @brief Hash FNV-1a de 64 bits del contenido de un archivo
+ * @return 0 si OK, -1 si no se pudo leer
+ */
+int program_source_hash(const char* path, uint64_t* hash);
+
+/**
+ * @brief Escribe la imagen binaria de un programa ya parseado
+ *
+ * Escribe a un archivo temporal y lo renombra, de modo que varios PEs
+ * ensamblando el mismo archivo a la vez nunca ven una imagen a medias.
+ * @return 0 si OK, -1 en caso de error
+ */
+int program_image_write(const Program* prog, uint64_t source_hash, const char* path);
+
+/**
+ * @brief Mapea una imagen binaria
+ *
+ * @param path Ruta de la imagen
+ * @param source_hash Hash esperado del .asm actual
+ * @return Program listo para ejecutar (liberar con free_program), o NULL si
+ *         la imagen no existe o es obsoleta
+ */
+Program* program_image_load(const char* path, uint64_t source_hash);
+
+/**
+ * @brief Carga un .asm usando su imagen en caché (PROGRAM_CACHE_DIR)
+ *
+ * Si la imagen es válida se mapea; si no, se parsea el texto con
+ * load_program() y se escribe la imagen para la próxima ejecución.
+ */
+Program* load_program_cached(const char* asm_path);
+
+#endif // PROGRAM_IMAGE_H
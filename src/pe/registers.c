@@ -10,6 +10,13 @@ void reg_init(RegisterFile* rf) {
         rf->regs[i] = 0.0;
     }
     
+    // Initialize vector registers to 0.0
+    for (int v = 0; v < NUM_VREGISTERS; v++) {
+        for (int l = 0; l < BLOCK_SIZE; l++) {
+            rf->vregs[v][l] = 0.0;
+        }
+    }
+    
     // Initialize program counter to 0
     rf->pc = 0;
     
@@ -37,6 +44,16 @@ void reg_write(RegisterFile* rf, int reg_id, double value) {
     rf->regs[reg_id] = value;
 }
 
+double* vreg_get(RegisterFile* rf, int vreg_id) {
+    // Range validation
+    if (vreg_id < 0 || vreg_id >= NUM_VREGISTERS) {
+        LOGE("vreg_id=%d out of range [0-%d]", vreg_id, NUM_VREGISTERS - 1);
+        return NULL;
+    }
+    
+    return rf->vregs[vreg_id];
+}
+
 void reg_update_zero_flag(RegisterFile* rf, double value) {
     // Update zero flag: 1 if value is 0.0, else 0
     rf->zero_flag = (value == 0.0) ? 1 : 0;
@@ -63,5 +80,14 @@ void reg_print(RegisterFile* rf, int pe_id) {
         printf("\n");
     }
     
+    // Vector registers, one per line
+    for (int v = 0; v < NUM_VREGISTERS; v++) {
+        printf("  V%d: [", v);
+        for (int l = 0; l < BLOCK_SIZE; l++) {
+            printf(l == 0 ? "%.6f" : ", %.6f", rf->vregs[v][l]);
+        }
+        printf("]\n");
+    }
+    
     printf("\n");
 }
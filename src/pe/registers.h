@@ -2,18 +2,22 @@
 #define REGISTERS_H
 
 #include <stdint.h>
+#include "config.h"
 
 #define NUM_REGISTERS 8
+#define NUM_VREGISTERS 4   // Registros vectoriales V0-V3 (BLOCK_SIZE lanes)
 
 /**
  * @brief Banco de registros de propósito general
  * 
  * Contiene 8 registros de 64 bits (double precision floating point),
+ * 4 registros vectoriales de BLOCK_SIZE lanes (un bloque de caché),
  * un program counter para seguimiento de instrucciones,
  * y una bandera de cero que se actualiza automáticamente
  */
 typedef struct {
     double regs[NUM_REGISTERS];  // REG0 - REG7 (64 bits cada uno)
+    double vregs[NUM_VREGISTERS][BLOCK_SIZE];  // V0 - V3
     uint64_t pc;                 // Program Counter
     int zero_flag;               // Bandera de cero: 1 si última operación = 0, 0 en caso contrario
 } RegisterFile;
@@ -45,6 +49,15 @@ double reg_read(RegisterFile* rf, int reg_id);
  */
 void reg_write(RegisterFile* rf, int reg_id, double value);
 
+/**
+ * @brief Obtiene los lanes de un registro vectorial
+ * 
+ * @param rf Puntero al banco de registros
+ * @param vreg_id ID del registro vectorial (0-3)
+ * @return double* Puntero a BLOCK_SIZE lanes, o NULL si el ID es inválido
+ */
+double* vreg_get(RegisterFile* rf, int vreg_id);
+
 /**
  * @brief Actualiza la bandera de cero basándose en un valor
  * 
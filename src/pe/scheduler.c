@@ -0,0 +1,205 @@
+#define LOG_MODULE "SCHED"
+#include "scheduler.h"
+#include <stdlib.h>
+#include <string.h>
+#include <sched.h>  // for sched_yield()
+#include <time.h>
+#include "log.h"
+#include "checkpoint.h"
+#include "fastforward.h"
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+const char* sched_mode_name(SchedMode mode) {
+    switch (mode) {
+        case SCHED_YIELD:   return "yield";
+        case SCHED_QUANTUM: return "quantum";
+        default:            return "unknown";
+    }
+}
+
+// INIT AND CLEANUP
+
+void sched_init(Scheduler* sched, int num_pes) {
+    sched->mode = SCHED_QUANTUM;
+    sched->quantum = SCHED_QUANTUM_DEFAULT;
+
+    const char* env_mode = getenv("SIM_SCHED");
+    if (env_mode) {
+        if (strcasecmp(env_mode, "yield") == 0) {
+            sched->mode = SCHED_YIELD;
+        } else if (strcasecmp(env_mode, "quantum") == 0) {
+            sched->mode = SCHED_QUANTUM;
+        } else {
+            LOGW("Unknown SIM_SCHED=%s (using quantum)", env_mode);
+        }
+    }
+
+    const char* env_quantum = getenv("SIM_QUANTUM");
+    if (env_quantum) {
+        int val = atoi(env_quantum);
+        if (val > 0) {
+            sched->quantum = val;
+        } else {
+            LOGW("Invalid SIM_QUANTUM=%s (using %d)", env_quantum, sched->quantum);
+        }
+    }
+
+    sched->active = num_pes;
+    sched->arrived = 0;
+    sched->parked = 0;
+    sched->epoch = 0;
+    sched->epoch_min = sched->quantum;
+    sched->epoch_max = 0;
+    for (int i = 0; i < NUM_PES; i++) {
+        sched->pe[i].slice = 0;
+    }
+
+    pthread_mutex_init(&sched->mutex, NULL);
+    pthread_cond_init(&sched->epoch_done, NULL);
+    sched_stats_init(&sched->stats);
+
+    if (sched->mode == SCHED_QUANTUM) {
+        LOGI("Initialized (quantum=%d instructions)", sched->quantum);
+    } else {
+        LOGI("Initialized (yield per instruction)");
+    }
+}
+
+void sched_destroy(Scheduler* sched) {
+    pthread_mutex_destroy(&sched->mutex);
+    pthread_cond_destroy(&sched->epoch_done);
+}
+
+void sched_start(Scheduler* sched) {
+    sched->stats.start_ns = now_ns();
+}
+
+// QUANTUM BARRIER
+
+// Every running PE is held at the barrier and none is inside a bus request:
+// the state is consistent unless a parked PE can wake up meanwhile
+static void barrier_hooks(Scheduler* sched) {
+    if (ff_pending) {
+        ff_at_barrier(sched);
+    }
+    if (checkpoint_pending && sched->parked == 0) {
+        checkpoint_at_barrier(sched);
+    }
+}
+
+// Release the current epoch. Must be called with the mutex held. The last
+// arrival, a PE that parks or one that exits can close the epoch: all of
+// them run the barrier hooks first.
+static void release_epoch(Scheduler* sched) {
+    barrier_hooks(sched);
+    uint64_t skew = (uint64_t)(sched->epoch_max - sched->epoch_min);
+    if (sched->epoch_max >= sched->epoch_min && skew > sched->stats.max_epoch_skew) {
+        sched->stats.max_epoch_skew = skew;
+    }
+    sched->stats.epochs++;
+    sched->epoch++;
+    sched->arrived = 0;
+    sched->epoch_min = sched->quantum;
+    sched->epoch_max = 0;
+    pthread_cond_broadcast(&sched->epoch_done);
+}
+
+static void quantum_barrier(Scheduler* sched, int pe_id, int slice) {
+    uint64_t t0 = now_ns();
+
+    pthread_mutex_lock(&sched->mutex);
+    if (slice < sched->epoch_min) sched->epoch_min = slice;
+    if (slice > sched->epoch_max) sched->epoch_max = slice;
+
+    uint64_t my_epoch = sched->epoch;
+    sched->arrived++;
+    if (sched->arrived >= sched->active) {
+        release_epoch(sched);
+    } else {
+        while (sched->epoch == my_epoch) {
+            pthread_cond_wait(&sched->epoch_done, &sched->mutex);
+        }
+    }
+    pthread_mutex_unlock(&sched->mutex);
+
+    STATS_ADD(sched->stats.pe[pe_id].wait_ns, now_ns() - t0);
+}
+
+void sched_after_instruction(Scheduler* sched, int pe_id, int retired, int used_bus) {
+    STATS_ADD(sched->stats.pe[pe_id].instructions, retired);
+
+    if (sched->mode == SCHED_YIELD) {
+        // Yield CPU to simulate instruction time and allow fair scheduling
+        sched_yield();
+        return;
+    }
+
+    int slice = (sched->pe[pe_id].slice += retired);
+    if (slice < sched->quantum && !used_bus) {
+        return;
+    }
+
+    // End of quantum: full slice or cut short by a bus request
+    STATS_INC(sched->stats.pe[pe_id].quanta);
+    if (slice < sched->quantum) {
+        STATS_INC(sched->stats.pe[pe_id].bus_preempted);
+    }
+    sched->pe[pe_id].slice = 0;
+    quantum_barrier(sched, pe_id, slice);
+}
+
+void sched_end_quantum(Scheduler* sched, int pe_id) {
+    int slice = sched->pe[pe_id].slice;
+    if (sched->mode == SCHED_YIELD || slice == 0) {
+        return;
+    }
+    STATS_INC(sched->stats.pe[pe_id].quanta);
+    sched->pe[pe_id].slice = 0;
+    quantum_barrier(sched, pe_id, slice);
+}
+
+void sched_pe_park(Scheduler* sched, int pe_id) {
+    pthread_mutex_lock(&sched->mutex);
+    if (sched->pe[pe_id].slice > 0) {
+        STATS_INC(sched->stats.pe[pe_id].quanta);
+        sched->pe[pe_id].slice = 0;
+    }
+    sched->active--;
+    sched->parked++;
+    if (sched->arrived > 0 && sched->arrived >= sched->active) {
+        release_epoch(sched);
+    }
+    pthread_mutex_unlock(&sched->mutex);
+}
+
+void sched_pe_unpark(Scheduler* sched, int pe_id) {
+    pthread_mutex_lock(&sched->mutex);
+    sched->active++;
+    sched->parked--;
+    pthread_mutex_unlock(&sched->mutex);
+    LOGD("PE%d: rejoined scheduler (active=%d)", pe_id, sched->active);
+}
+
+void sched_pe_exit(Scheduler* sched, int pe_id) {
+    host_cpu_self(&sched->stats.pe[pe_id].cpu);
+    pthread_mutex_lock(&sched->mutex);
+    if (sched->pe[pe_id].slice > 0) {
+        STATS_INC(sched->stats.pe[pe_id].quanta);
+        sched->pe[pe_id].slice = 0;
+    }
+    sched->active--;
+    // The remaining PEs may all be waiting for this one
+    if (sched->arrived > 0 && sched->arrived >= sched->active) {
+        release_epoch(sched);
+    }
+    if (sched->active == 0) {
+        sched->stats.end_ns = now_ns();
+    }
+    pthread_mutex_unlock(&sched->mutex);
+    LOGD("PE%d: left scheduler (active=%d)", pe_id, sched->active);
+}
@@ -0,0 +1,81 @@
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include "config.h"
+#include "sched_stats.h"
+#include <pthread.h>
+#include <stdint.h>
+
+/**
+ * @file scheduler.h
+ * @brief Planificador de PEs por quantum
+ *
+ * Modos:
+ * - SCHED_YIELD:   sched_yield() después de cada instrucción (modo original)
+ * - SCHED_QUANTUM: cada PE ejecuta hasta N instrucciones, o hasta emitir una
+ *                  solicitud al bus, y luego espera en una barrera a los demás
+ *                  PEs activos. El skew entre PEs queda acotado por N.
+ *
+ * Variables de entorno:
+ *   SIM_SCHED=yield|quantum   (por defecto: quantum)
+ *   SIM_QUANTUM=N             (por defecto: SCHED_QUANTUM de config.h)
+ */
+
+typedef enum {
+    SCHED_YIELD,
+    SCHED_QUANTUM
+} SchedMode;
+
+// Current quantum of one PE, updated on every instruction: one host cache
+// line per PE so the PE threads never write the same line
+typedef struct {
+    _Alignas(HOST_CACHE_LINE) int slice; // Instructions executed in the current quantum
+} SchedPESlot;
+
+typedef struct {
+    SchedMode mode;
+    int quantum;                   // Instructions per quantum
+    int active;                    // PEs that have not exited yet
+    int arrived;                   // PEs waiting at the barrier in this epoch
+    int parked;                    // PEs asleep in MWAIT (outside the barrier)
+    uint64_t epoch;                // Current epoch (barrier generation)
+    SchedPESlot pe[NUM_PES];       // Per-PE quantum progress
+    int epoch_min;                 // Shortest slice seen in this epoch
+    int epoch_max;                 // Longest slice seen in this epoch
+    pthread_mutex_t mutex;
+    pthread_cond_t epoch_done;
+    SchedStats stats;
+} Scheduler;
+
+// Init and cleanup (reads SIM_SCHED and SIM_QUANTUM)
+void sched_init(Scheduler* sched, int num_pes);
+void sched_destroy(Scheduler* sched);
+
+// Mark the start of the parallel section (host wall clock)
+void sched_start(Scheduler* sched);
+
+/**
+ * @brief Account for one executed instruction and synchronize if needed
+ *
+ * @param sched Scheduler
+ * @param pe_id PE that executed the instruction
+ * @param retired Original instructions retired (span of a superinstruction)
+ * @param used_bus 1 if the instruction issued at least one bus request
+ */
+void sched_after_instruction(Scheduler* sched, int pe_id, int retired, int used_bus);
+
+// End pe_id's quantum now, without a bus request (ROI: the fast-forward
+// controller switches at the next barrier). No-op in yield mode.
+void sched_end_quantum(Scheduler* sched, int pe_id);
+
+// PE leaves the scheduler (HALT, error or iteration cap)
+void sched_pe_exit(Scheduler* sched, int pe_id);
+
+// PE blocks outside the simulation (MWAIT): leave the quantum barrier while
+// asleep so the other PEs keep running, and rejoin on wakeup
+void sched_pe_park(Scheduler* sched, int pe_id);
+void sched_pe_unpark(Scheduler* sched, int pe_id);
+
+const char* sched_mode_name(SchedMode mode);
+
+#endif // SCHEDULER_H
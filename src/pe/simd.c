@@ -0,0 +1,52 @@
+#include "simd.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+void simd_fmul(double* d, const double* a, const double* b, int n) {
+    int i = 0;
+#if defined(__SSE2__)
+    for (; i + 2 <= n; i += 2) {
+        __m128d va = _mm_loadu_pd(a + i);
+        __m128d vb = _mm_loadu_pd(b + i);
+        _mm_storeu_pd(d + i, _mm_mul_pd(va, vb));
+    }
+#endif
+    for (; i < n; i++) {
+        d[i] = a[i] * b[i];
+    }
+}
+
+void simd_fma(double* d, const double* a, const double* b, int n) {
+    int i = 0;
+#if defined(__SSE2__)
+    for (; i + 2 <= n; i += 2) {
+        __m128d va = _mm_loadu_pd(a + i);
+        __m128d vb = _mm_loadu_pd(b + i);
+        __m128d vd = _mm_loadu_pd(d + i);
+        _mm_storeu_pd(d + i, _mm_add_pd(vd, _mm_mul_pd(va, vb)));
+    }
+#endif
+    for (; i < n; i++) {
+        d[i] = d[i] + a[i] * b[i];
+    }
+}
+
+double simd_reduce(const double* a, int n) {
+    int i = 0;
+    double sum = 0.0;
+#if defined(__SSE2__)
+    __m128d acc = _mm_setzero_pd();
+    for (; i + 2 <= n; i += 2) {
+        acc = _mm_add_pd(acc, _mm_loadu_pd(a + i));
+    }
+    double lanes[2];
+    _mm_storeu_pd(lanes, acc);
+    sum = lanes[0] + lanes[1];
+#endif
+    for (; i < n; i++) {
+        sum += a[i];
+    }
+    return sum;
+}
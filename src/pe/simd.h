@@ -0,0 +1,22 @@
+#ifndef SIMD_H
+#define SIMD_H
+
+/**
+ * @file simd.h
+ * @brief Kernels SIMD del host para las instrucciones vectoriales
+ *
+ * Operan sobre n lanes de double (n = BLOCK_SIZE en la ISA). Usan SSE2
+ * (2 doubles por operación) cuando está disponible y un bucle escalar
+ * para el resto de lanes.
+ */
+
+// d[i] = a[i] * b[i]
+void simd_fmul(double* d, const double* a, const double* b, int n);
+
+// d[i] = d[i] + a[i] * b[i]  (multiplicación y suma separadas, como FMUL + FADD)
+void simd_fma(double* d, const double* a, const double* b, int n);
+
+// Suma horizontal de a[0..n-1]
+double simd_reduce(const double* a, int n);
+
+#endif // SIMD_H
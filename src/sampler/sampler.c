@@ -0,0 +1,175 @@
+#define LOG_MODULE "SAMPLER"
+#include "sampler.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdatomic.h>
+#include <time.h>
+#include <pthread.h>
+#include "log.h"
+
+static uint64_t INTERVAL;            // SIM_STATS_SAMPLE (0: off)
+static const char* SERIES_PATH;      // SIM_STATS_SERIES
+
+static Cache* CACHES;
+static Bus* BUS;
+static Memory* MEM;
+static Scheduler* SCHED;
+
+static pthread_t thread;
+static atomic_bool running;
+static bool started;
+
+// Only the sampling thread appends while it runs; main reads after the join
+static StatsSample* samples;
+static size_t count;
+static size_t capacity;
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+// INIT
+
+int sampler_init(void) {
+    const char* env_sample = getenv("SIM_STATS_SAMPLE");
+    if (env_sample && *env_sample) {
+        char* end;
+        INTERVAL = strtoull(env_sample, &end, 0);
+        if (*end != '\0' || INTERVAL == 0) {
+            LOGE("Invalid SIM_STATS_SAMPLE=%s (instructions, > 0)", env_sample);
+            return -1;
+        }
+    }
+
+    const char* env_series = getenv("SIM_STATS_SERIES");
+    SERIES_PATH = (env_series && *env_series) ? env_series : NULL;
+    if (INTERVAL && !SERIES_PATH && !getenv("SIM_STATS_JSON")) {
+        LOGW("SIM_STATS_SAMPLE without SIM_STATS_SERIES or SIM_STATS_JSON: samples are not saved");
+    }
+    return 0;
+}
+
+// SNAPSHOT
+
+static void copy_counters(void* dst, const void* src, size_t size) {
+    uint64_t* out = (uint64_t*)dst;
+    const uint64_t* in = (const uint64_t*)src;
+    for (size_t k = 0; k < size / sizeof(uint64_t); k++) {
+        out[k] = STATS_GET(in[k]);
+    }
+}
+
+static void collect(StatsSample* sample) {
+    memset(sample, 0, sizeof(*sample));
+    for (int i = 0; i < NUM_PES; i++) {
+        sample->pe_instructions[i] = STATS_GET(SCHED->stats.pe[i].instructions);
+        sample->instructions += sample->pe_instructions[i];
+        stats_snapshot(&CACHES[i].stats, &sample->caches[i]);
+    }
+    copy_counters(&sample->bus, &BUS->stats, sizeof(BusStats));
+    copy_counters(&sample->memory, &MEM->stats, sizeof(MemoryStats));
+}
+
+// Double collect: equal reads of monotonic counters held at one instant
+static void take_sample(void) {
+    StatsSample a, b;
+    int consistent = 0;
+    collect(&a);
+    for (int attempt = 0; attempt < SAMPLER_RETRIES && !consistent; attempt++) {
+        collect(&b);
+        consistent = memcmp(&a, &b, sizeof(a)) == 0;
+        a = b;
+    }
+    a.consistent = consistent;
+    a.host_ns = now_ns() - SCHED->stats.start_ns;
+
+    if (count == capacity) {
+        size_t new_capacity = capacity ? capacity * 2 : 64;
+        StatsSample* grown = realloc(samples, new_capacity * sizeof(StatsSample));
+        if (!grown) {
+            LOGE("Out of memory for the time series, sample dropped");
+            return;
+        }
+        samples = grown;
+        capacity = new_capacity;
+    }
+    samples[count++] = a;
+}
+
+static void* sampler_thread(void* arg) {
+    (void)arg;
+    uint64_t next = INTERVAL;
+    struct timespec poll = { 0, SAMPLER_POLL_US * 1000L };
+
+    while (atomic_load(&running)) {
+        uint64_t retired = sched_stats_instructions(&SCHED->stats);
+        if (retired >= next) {
+            take_sample();
+            next = (retired / INTERVAL + 1) * INTERVAL;
+        }
+        nanosleep(&poll, NULL);
+    }
+    return NULL;
+}
+
+// CONTROL
+
+void sampler_start(Cache* caches, Bus* bus, Memory* mem, Scheduler* sched) {
+    CACHES = caches;
+    BUS = bus;
+    MEM = mem;
+    SCHED = sched;
+    if (!INTERVAL) {
+        return;
+    }
+
+    atomic_store(&running, true);
+    if (pthread_create(&thread, NULL, sampler_thread, NULL) != 0) {
+        LOGE("Could not start the sampling thread");
+        return;
+    }
+    started = true;
+    LOGI("Sampling counters every %lu instructions", (unsigned long)INTERVAL);
+}
+
+void sampler_stop(void) {
+    if (!started) {
+        return;
+    }
+    atomic_store(&running, false);
+    pthread_join(thread, NULL);
+    started = false;
+
+    // The PEs are done: the last point is the final total
+    take_sample();
+}
+
+const StatsSample* sampler_samples(size_t* out_count) {
+    *out_count = count;
+    return samples;
+}
+
+int sampler_write_series(void) {
+    if (!SERIES_PATH || count == 0) {
+        return 0;
+    }
+    FILE* f = fopen(SERIES_PATH, "w");
+    if (!f) {
+        LOGE("Could not open %s for the time series", SERIES_PATH);
+        return -1;
+    }
+    stats_series_csv_header(f);
+    for (size_t i = 0; i < count; i++) {
+        stats_series_csv_row(f, &samples[i]);
+    }
+    return fclose(f) == 0 ? 0 : -1;
+}
+
+void sampler_free(void) {
+    free(samples);
+    samples = NULL;
+    count = capacity = 0;
+}
@@ -0,0 +1,57 @@
+#ifndef SAMPLER_H
+#define SAMPLER_H
+
+#include <stddef.h>
+#include "config.h"
+#include "bus.h"
+#include "cache.h"
+#include "memory.h"
+#include "scheduler.h"
+#include "stats_export.h"
+
+/**
+ * @file sampler.h
+ * @brief Serie temporal de contadores durante la simulación
+ *
+ * SIM_STATS_SAMPLE=N arranca un hilo que toma una muestra de los contadores
+ * (acumulados) cada vez que los PEs retiran N instrucciones más, además de
+ * una muestra final. Sirve para ver cómo cambian la tasa de fallos y el
+ * ancho de banda del bus entre las fases de cómputo, barrera y reducción.
+ *
+ * Los PEs no se detienen: el hilo lee todos los contadores dos veces seguidas
+ * con cargas relajadas y acepta la muestra si ambas lecturas coinciden. Como
+ * los contadores solo crecen, esos valores coexistieron en un mismo instante.
+ * Si tras SAMPLER_RETRIES intentos siguen cambiando, guarda la última
+ * lectura con consistent=0.
+ *
+ * El hilo consulta el total cada SAMPLER_POLL_US (con SIM_SCHED=quantum y
+ * yield por igual) y toma una muestra si cruzó el siguiente múltiplo de N.
+ * Si entre dos consultas se retiran más de N instrucciones, una sola fila
+ * cubre esos intervalos: cada fila lleva su total de instrucciones exacto.
+ *
+ * Salida: SIM_STATS_SERIES=<archivo.csv> (una fila por muestra) y/o el campo
+ * "timeseries" de SIM_STATS_JSON.
+ */
+
+/**
+ * @brief Lee SIM_STATS_SAMPLE y SIM_STATS_SERIES
+ * @return 0 si OK, -1 si el intervalo es inválido
+ */
+int sampler_init(void);
+
+// Start the sampling thread (no-op without SIM_STATS_SAMPLE). Call after
+// sched_start and before the PE threads.
+void sampler_start(Cache* caches, Bus* bus, Memory* mem, Scheduler* sched);
+
+// Stop the thread and take the final sample. Call after the PEs finished.
+void sampler_stop(void);
+
+// Samples taken so far (NULL/0 if sampling is off)
+const StatsSample* sampler_samples(size_t* count);
+
+// Write SIM_STATS_SERIES, if set. Returns 0 if OK.
+int sampler_write_series(void);
+
+void sampler_free(void);
+
+#endif // SAMPLER_H
@@ -0,0 +1,192 @@
+#define LOG_MODULE "BLOCKS"
+#include "block_stats.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include "log.h"
+
+BlockStats* block_stats = NULL;
+
+static int TOP_N = BLOCK_STATS_TOP_N;    // SIM_HOTBLOCKS
+
+// INIT
+
+int block_stats_init(void) {
+    const char* env_top = getenv("SIM_HOTBLOCKS");
+    if (env_top && *env_top) {
+        char* end;
+        long top = strtol(env_top, &end, 0);
+        if (*end != '\0' || top < 0) {
+            LOGE("Invalid SIM_HOTBLOCKS=%s (number of blocks, 0 hides the section)", env_top);
+            return -1;
+        }
+        TOP_N = (int)top;
+    }
+
+    block_stats = aligned_alloc(HOST_CACHE_LINE, sizeof(BlockStats));
+    if (!block_stats) {
+        LOGW("Out of memory for per-block statistics, tracking disabled");
+        return 0;
+    }
+    for (int b = 0; b < BLOCK_STATS_BLOCKS; b++) {
+        block_stats->bus[b] = (BlockBusCounters){ .owner = -1 };
+    }
+    for (int i = 0; i < NUM_PES; i++) {
+        for (int b = 0; b < BLOCK_STATS_BLOCKS; b++) {
+            block_stats->pe[i].read[b] = 0;
+            block_stats->pe[i].written[b] = 0;
+        }
+    }
+    return 0;
+}
+
+void block_stats_free(void) {
+    free(block_stats);
+    block_stats = NULL;
+}
+
+// RECORDING
+
+void block_stats_record_bus(int block_base, int src_pe, bool exclusive, bool upgrade,
+                            int invalidations) {
+    if (!block_stats) return;
+    int block = block_base / BLOCK_SIZE;
+    if (block < 0 || block >= BLOCK_STATS_BLOCKS) return;
+
+    BlockBusCounters* c = &block_stats->bus[block];
+    STATS_INC(c->transactions);
+    STATS_ADD(c->invalidations, invalidations);
+    if (upgrade) {
+        STATS_INC(c->upgrades);
+    }
+    if (exclusive) {
+        if (c->owner >= 0 && c->owner != src_pe) {
+            STATS_INC(c->ping_pongs);
+        }
+        c->owner = src_pe;
+    }
+}
+
+// CLASSIFICATION
+
+BlockClass block_stats_classify(const BlockStats* stats, int block) {
+    int users = 0;
+    int writers = 0;
+    for (int i = 0; i < NUM_PES; i++) {
+        users += (stats->pe[i].read[block] | stats->pe[i].written[block]) != 0;
+        writers += stats->pe[i].written[block] != 0;
+    }
+    if (users == 0) return BLOCK_UNUSED;
+    if (users == 1) return BLOCK_PRIVATE;
+    if (writers == 0) return BLOCK_READ_SHARED;
+
+    // One writer/user pair with disjoint words is enough: its invalidations
+    // never carry data the other PE uses
+    for (int w = 0; w < NUM_PES; w++) {
+        uint32_t written = stats->pe[w].written[block];
+        if (!written) continue;
+        for (int u = 0; u < NUM_PES; u++) {
+            uint32_t used = stats->pe[u].read[block] | stats->pe[u].written[block];
+            if (u != w && used && (written & used) == 0) {
+                return BLOCK_FALSE_SHARING;
+            }
+        }
+    }
+    return BLOCK_TRUE_SHARING;
+}
+
+const char* block_class_name(BlockClass cls) {
+    static const char* names[BLOCK_NUM_CLASSES] = {
+        "unused", "private", "read-shared", "true-sharing", "false-sharing"
+    };
+    return (cls >= 0 && cls < BLOCK_NUM_CLASSES) ? names[cls] : "?";
+}
+
+void block_stats_words(const BlockStats* stats, int block, int pe_id, char* buf) {
+    uint32_t read = stats->pe[pe_id].read[block];
+    uint32_t written = stats->pe[pe_id].written[block];
+    for (int k = 0; k < BLOCK_SIZE; k++) {
+        buf[k] = (written >> k) & 1 ? 'w' : (read >> k) & 1 ? 'r' : '.';
+    }
+    buf[BLOCK_SIZE] = '\0';
+}
+
+// REPORT
+
+// Hotter first: bus transactions, then invalidations
+static int hotter(const BlockStats* stats, int a, int b) {
+    const BlockBusCounters* x = &stats->bus[a];
+    const BlockBusCounters* y = &stats->bus[b];
+    if (x->transactions != y->transactions) return x->transactions > y->transactions;
+    return x->invalidations > y->invalidations;
+}
+
+void block_stats_print(const BlockStats* stats, BlockRegionFn region) {
+    if (!stats || TOP_N == 0) {
+        return;
+    }
+
+    const char* B = log_color_bold();
+    const char* BLUE = log_color_blue();
+    const char* RESET = log_color_reset();
+
+    int per_class[BLOCK_NUM_CLASSES] = {0};
+    uint64_t invs_total = 0;
+    uint64_t invs_false = 0;
+    int top[BLOCK_STATS_BLOCKS];
+    int count = 0;
+
+    for (int b = 0; b < BLOCK_STATS_BLOCKS; b++) {
+        BlockClass cls = block_stats_classify(stats, b);
+        per_class[cls]++;
+        invs_total += stats->bus[b].invalidations;
+        if (cls == BLOCK_FALSE_SHARING) {
+            invs_false += stats->bus[b].invalidations;
+        }
+        if (stats->bus[b].transactions == 0) {
+            continue;
+        }
+        // Insertion into the sorted top list
+        int pos = count < TOP_N ? count++ : TOP_N;
+        while (pos > 0 && hotter(stats, b, top[pos - 1])) {
+            if (pos < TOP_N) top[pos] = top[pos - 1];
+            pos--;
+        }
+        if (pos < TOP_N) top[pos] = b;
+    }
+
+    printf("\n%s[Hot blocks]%s\n", BLUE, RESET);
+    printf("%sClasses%s: private=%d read-shared=%d true-sharing=%d false-sharing=%d\n",
+           B, RESET, per_class[BLOCK_PRIVATE], per_class[BLOCK_READ_SHARED],
+           per_class[BLOCK_TRUE_SHARING], per_class[BLOCK_FALSE_SHARING]);
+    printf("%sFalse sharing%s: %lu of %lu invalidations (%.2f%%)\n", B, RESET,
+           (unsigned long)invs_false, (unsigned long)invs_total,
+           invs_total ? 100.0 * invs_false / invs_total : 0.0);
+    printf("%sTop %d by bus transactions%s (words per PE: w=written r=read .=untouched)\n",
+           B, count, RESET);
+    printf("  %-7s %-22s %-14s %6s %6s %6s %9s %7s  %s\n", "Block", "Region", "Class",
+           "Txns", "Invs", "Upgr", "PingPong", "Writers", "Words");
+
+    for (int t = 0; t < count; t++) {
+        int b = top[t];
+        const BlockBusCounters* c = &stats->bus[b];
+        char name[64] = "-";
+        if (region) {
+            region(b * BLOCK_SIZE, name, sizeof(name));
+        }
+        int writers = 0;
+        for (int i = 0; i < NUM_PES; i++) {
+            writers += stats->pe[i].written[b] != 0;
+        }
+
+        printf("  0x%-5X %-22s %-14s %6lu %6lu %6lu %9lu %7d  ", b * BLOCK_SIZE, name,
+               block_class_name(block_stats_classify(stats, b)),
+               (unsigned long)c->transactions, (unsigned long)c->invalidations,
+               (unsigned long)c->upgrades, (unsigned long)c->ping_pongs, writers);
+        for (int i = 0; i < NUM_PES; i++) {
+            char words[BLOCK_SIZE + 1];
+            block_stats_words(stats, b, i, words);
+            printf("%sP%d:%s", i ? " " : "", i, words);
+        }
+        printf("\n");
+    }
+}
@@ -0,0 +1,120 @@
+#ifndef BLOCK_STATS_H
+#define BLOCK_STATS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "config.h"
+#include "stats_shard.h"
+
+/**
+ * @file block_stats.h
+ * @brief Contención por bloque de memoria y detector de false sharing
+ *
+ * Por cada bloque se cuentan las transacciones de bus, las copias
+ * invalidadas, los BUS_UPGR y los ping-pong (la propiedad exclusiva obtenida
+ * por BUS_RDX/BUS_UPGR pasa a un PE distinto del último dueño), y qué
+ * palabras leyó y escribió cada PE.
+ *
+ * Con las palabras se clasifica el bloque:
+ *   private        lo usa un solo PE
+ *   read-shared    varios PEs, nadie escribe
+ *   false-sharing  un PE escribe palabras que otro PE que usa el bloque
+ *                  nunca toca (p. ej. un resultado parcial por PE en el
+ *                  mismo bloque): las invalidaciones no transportan datos
+ *   true-sharing   cada par escritor/usuario comparte alguna palabra
+ *
+ * Las palabras se acumulan durante toda la ejecución, sin separar fases.
+ *
+ * Los contadores de bus solo los escribe el hilo del bus; las palabras de un
+ * PE solo las escribe ese PE, en filas separadas por HOST_CACHE_LINE.
+ * Se imprime la sección [Hot blocks] con los SIM_HOTBLOCKS bloques con más
+ * transacciones (por defecto BLOCK_STATS_TOP_N; 0 la oculta).
+ */
+
+#define BLOCK_STATS_BLOCKS (MEM_SIZE / BLOCK_SIZE)
+
+_Static_assert(BLOCK_SIZE <= 32, "word masks are uint32_t");
+
+typedef enum {
+    BLOCK_UNUSED,
+    BLOCK_PRIVATE,
+    BLOCK_READ_SHARED,
+    BLOCK_TRUE_SHARING,
+    BLOCK_FALSE_SHARING,
+    BLOCK_NUM_CLASSES
+} BlockClass;
+
+// Written by the bus thread only
+typedef struct {
+    uint64_t transactions;      // BUS_RD/BUS_RDX/BUS_UPGR/BUS_WB on the block
+    uint64_t invalidations;     // Copies invalidated by those transactions
+    uint64_t upgrades;          // BUS_UPGR
+    uint64_t ping_pongs;        // Exclusive ownership moved to another PE
+    int owner;                  // Last PE granted ownership on the bus (-1: none)
+} BlockBusCounters;
+
+// Written by its PE only: bit k = word k of the block
+typedef struct {
+    _Alignas(HOST_CACHE_LINE) uint32_t read[BLOCK_STATS_BLOCKS];
+    uint32_t written[BLOCK_STATS_BLOCKS];
+} BlockWordsPE;
+
+typedef struct {
+    BlockBusCounters bus[BLOCK_STATS_BLOCKS];
+    BlockWordsPE pe[NUM_PES];
+} BlockStats;
+
+// Symbolic name of the regions a block overlaps (e.g. "results+flags")
+typedef void (*BlockRegionFn)(int block_base, char* buf, size_t size);
+
+// NULL when tracking is off (allocation failed); checked inline at every call site
+extern BlockStats* block_stats;
+
+/**
+ * @brief Reserva la tabla y lee SIM_HOTBLOCKS
+ * @return 0 si OK, -1 si SIM_HOTBLOCKS es inválida
+ */
+int block_stats_init(void);
+
+void block_stats_free(void);
+
+// Words [offset, offset + count) of the block read or written by pe_id
+static inline void block_stats_touch(int pe_id, int block_base, int offset, int count,
+                                     bool write) {
+    if (!block_stats) return;
+    int block = block_base / BLOCK_SIZE;
+    if (block < 0 || block >= BLOCK_STATS_BLOCKS) return;
+    uint32_t mask = (count >= 32 ? ~0u : ((1u << count) - 1u)) << offset;
+    uint32_t* words = write ? &block_stats->pe[pe_id].written[block]
+                            : &block_stats->pe[pe_id].read[block];
+    uint32_t old = STATS_GET(*words);
+    if ((old | mask) != old) {
+        __atomic_store_n(words, old | mask, __ATOMIC_RELAXED);
+    }
+}
+
+/**
+ * @brief Registra una transacción de bus sobre un bloque (hilo del bus)
+ * @param exclusive La transacción da propiedad exclusiva (BUS_RDX/BUS_UPGR)
+ * @param upgrade Es un BUS_UPGR
+ * @param invalidations Copias invalidadas por la transacción
+ */
+void block_stats_record_bus(int block_base, int src_pe, bool exclusive, bool upgrade,
+                            int invalidations);
+
+// Classification of one block from its word masks
+BlockClass block_stats_classify(const BlockStats* stats, int block);
+
+const char* block_class_name(BlockClass cls);
+
+// Per-PE word map, one char per word: 'w' written, 'r' read, '.' untouched
+void block_stats_words(const BlockStats* stats, int block, int pe_id, char* buf);
+
+/**
+ * @brief Imprime la sección [Hot blocks]
+ * @param region Nombre simbólico de las regiones (NULL: solo direcciones)
+ */
+void block_stats_print(const BlockStats* stats, BlockRegionFn region);
+
+#endif // BLOCK_STATS_H
@@ -8,72 +8,85 @@ void bus_stats_init(BusStats* stats) {
 }
 
 void bus_stats_record_bus_rd(BusStats* stats, int pe_id) {
-    stats->bus_rd_count++;
-    stats->total_transactions++;
-    if (pe_id >= 0 && pe_id < 4) {
-        stats->transactions_per_pe[pe_id]++;
+    STATS_INC(stats->bus_rd_count);
+    STATS_INC(stats->total_transactions);
+    if (pe_id >= 0 && pe_id < NUM_PES) {
+        STATS_INC(stats->transactions_per_pe[pe_id]);
     }
 }
 
 void bus_stats_record_bus_rdx(BusStats* stats, int pe_id) {
-    stats->bus_rdx_count++;
-    stats->total_transactions++;
-    if (pe_id >= 0 && pe_id < 4) {
-        stats->transactions_per_pe[pe_id]++;
+    STATS_INC(stats->bus_rdx_count);
+    STATS_INC(stats->total_transactions);
+    if (pe_id >= 0 && pe_id < NUM_PES) {
+        STATS_INC(stats->transactions_per_pe[pe_id]);
     }
 }
 
 void bus_stats_record_bus_upgr(BusStats* stats, int pe_id) {
-    stats->bus_upgr_count++;
-    stats->total_transactions++;
-    if (pe_id >= 0 && pe_id < 4) {
-        stats->transactions_per_pe[pe_id]++;
+    STATS_INC(stats->bus_upgr_count);
+    STATS_INC(stats->total_transactions);
+    if (pe_id >= 0 && pe_id < NUM_PES) {
+        STATS_INC(stats->transactions_per_pe[pe_id]);
     }
 }
 
 void bus_stats_record_bus_wb(BusStats* stats, int pe_id) {
-    stats->bus_wb_count++;
-    stats->total_transactions++;
-    if (pe_id >= 0 && pe_id < 4) {
-        stats->transactions_per_pe[pe_id]++;
+    STATS_INC(stats->bus_wb_count);
+    STATS_INC(stats->total_transactions);
+    if (pe_id >= 0 && pe_id < NUM_PES) {
+        STATS_INC(stats->transactions_per_pe[pe_id]);
+    }
+}
+
+void bus_stats_record_bus_ifetch(BusStats* stats, int pe_id) {
+    STATS_INC(stats->bus_ifetch_count);
+    STATS_INC(stats->total_transactions);
+    if (pe_id >= 0 && pe_id < NUM_PES) {
+        STATS_INC(stats->transactions_per_pe[pe_id]);
     }
 }
 
 void bus_stats_record_invalidations(BusStats* stats, int count) {
-    stats->invalidations_sent += count;
+    STATS_ADD(stats->invalidations_sent, count);
 }
 
 void bus_stats_record_data_transfer(BusStats* stats, int bytes) {
-    stats->bytes_data += bytes;
-    stats->bytes_transferred += bytes;
+    STATS_ADD(stats->bytes_data, bytes);
+    STATS_ADD(stats->bytes_transferred, bytes);
 }
 
 void bus_stats_record_control_transfer(BusStats* stats, int bytes) {
-    stats->bytes_control += bytes;
-    stats->bytes_transferred += bytes;
+    STATS_ADD(stats->bytes_control, bytes);
+    STATS_ADD(stats->bytes_transferred, bytes);
 }
 
 void bus_stats_record_control_base(BusStats* stats, int bytes) {
-    stats->bytes_control_base += bytes;
+    STATS_ADD(stats->bytes_control_base, bytes);
     bus_stats_record_control_transfer(stats, bytes);
 }
 
 void bus_stats_record_control_invalidations(BusStats* stats, int bytes) {
-    stats->bytes_control_invs += bytes;
+    STATS_ADD(stats->bytes_control_invs, bytes);
     bus_stats_record_control_transfer(stats, bytes);
 }
 
+void bus_stats_record_sync(BusStats* stats) {
+    STATS_INC(stats->sync_transactions);
+}
+
 void bus_stats_print(const BusStats* stats) {
     const char* B = log_color_bold();
     const char* BLUE = log_color_blue();
     const char* RESET = log_color_reset();
 
     printf("\n%s[Bus statistics]%s\n", BLUE, RESET);
-    printf("%sTransactions%s: BUS_RD=%lu BUS_RDX=%lu BUS_UPGR=%lu BUS_WB=%lu Total=%lu\n",
+    printf("%sTransactions%s: BUS_RD=%lu BUS_RDX=%lu BUS_UPGR=%lu BUS_WB=%lu BUS_IFETCH=%lu Total=%lu\n",
            B, RESET,
            stats->bus_rd_count, stats->bus_rdx_count, stats->bus_upgr_count,
-           stats->bus_wb_count, stats->total_transactions);
+           stats->bus_wb_count, stats->bus_ifetch_count, stats->total_transactions);
     printf("%sCoherence%s: broadcast_invalidations=%lu\n", B, RESET, stats->invalidations_sent);
+    printf("%sSync area%s: transactions=%lu\n", B, RESET, stats->sync_transactions);
 
     double traffic_kb = stats->bytes_transferred / 1024.0;
     double traffic_mb = traffic_kb / 1024.0;
@@ -96,7 +109,7 @@ void bus_stats_print(const BusStats* stats) {
     }
 
     printf("%sUsage per PE%s (transactions and %%):\n", B, RESET);
-    for (int i = 0; i < 4; i++) {
+    for (int i = 0; i < NUM_PES; i++) {
         double percentage = stats->total_transactions > 0 ?
             (100.0 * stats->transactions_per_pe[i] / stats->total_transactions) : 0.0;
         printf("  PE%d: %lu (%.2f%%)\n", i, stats->transactions_per_pe[i], percentage);
@@ -2,6 +2,8 @@
 #define BUS_STATS_H
 
 #include <stdint.h>
+#include "config.h"
+#include "stats_shard.h"
 
 /**
  * @brief Statistics for the interconnect bus
@@ -12,6 +14,7 @@ typedef struct {
     uint64_t bus_rdx_count;        // Exclusive reads for write (BUS_RDX)
     uint64_t bus_upgr_count;       // Upgrades (BUS_UPGR)
     uint64_t bus_wb_count;         // Writebacks (BUS_WB)
+    uint64_t bus_ifetch_count;     // Instruction fetches (BUS_IFETCH)
     
     // Generated invalidations
     uint64_t invalidations_sent;   // Total broadcast invalidations
@@ -26,8 +29,11 @@ typedef struct {
     uint64_t bytes_control_base;   // Base control bytes per transaction
     uint64_t bytes_control_invs;   // Additional control bytes due to invalidations
     
+    // Transactions on blocks of the synchronization area (flags, counters)
+    uint64_t sync_transactions;
+    
     // Per-PE counts (who uses the bus more)
-    uint64_t transactions_per_pe[4];
+    uint64_t transactions_per_pe[NUM_PES];
 } BusStats;
 
 /**
@@ -55,6 +61,11 @@ void bus_stats_record_bus_upgr(BusStats* stats, int pe_id);
  */
 void bus_stats_record_bus_wb(BusStats* stats, int pe_id);
 
+/**
+ * @brief Record a BUS_IFETCH transaction (instruction cache miss)
+ */
+void bus_stats_record_bus_ifetch(BusStats* stats, int pe_id);
+
 /**
  * @brief Record broadcast invalidations sent
  */
@@ -74,6 +85,11 @@ void bus_stats_record_control_transfer(BusStats* stats, int bytes);
 void bus_stats_record_control_base(BusStats* stats, int bytes);
 void bus_stats_record_control_invalidations(BusStats* stats, int bytes);
 
+/**
+ * @brief Record a transaction targeting the synchronization area
+ */
+void bus_stats_record_sync(BusStats* stats);
+
 /**
  * @brief Print bus statistics
  */
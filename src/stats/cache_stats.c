@@ -4,64 +4,137 @@
 #include "log.h"
 #include "config.h"
 
-void stats_init(CacheStats* stats) {
-    memset(stats, 0, sizeof(CacheStats));
+_Thread_local int stats_thread_shard = STATS_SHARD_PE;
+
+// Aggregation adds the structs word by word
+_Static_assert(sizeof(CacheStats) % sizeof(uint64_t) == 0, "CacheStats must only hold uint64_t counters");
+
+void stats_init(CacheStatsShards* stats) {
+    memset(stats, 0, sizeof(CacheStatsShards));
+}
+
+// Shard of the calling thread
+static CacheStats* own(CacheStatsShards* stats) {
+    return &stats->shard[stats_thread_shard].counters;
+}
+
+void stats_record_read_hit(CacheStatsShards* stats) {
+    CacheStats* s = own(stats);
+    STATS_INC(s->read_hits);
+    STATS_INC(s->total_reads);
+}
+
+void stats_record_read_miss(CacheStatsShards* stats) {
+    CacheStats* s = own(stats);
+    STATS_INC(s->read_misses);
+    STATS_INC(s->total_reads);
+    STATS_INC(s->bus_reads);
+}
+
+void stats_record_write_hit(CacheStatsShards* stats) {
+    CacheStats* s = own(stats);
+    STATS_INC(s->write_hits);
+    STATS_INC(s->total_writes);
+}
+
+void stats_record_write_miss(CacheStatsShards* stats) {
+    CacheStats* s = own(stats);
+    STATS_INC(s->write_misses);
+    STATS_INC(s->total_writes);
+    STATS_INC(s->bus_read_x);
+}
+
+void stats_record_invalidation_received(CacheStatsShards* stats) {
+    STATS_INC(own(stats)->invalidations_received);
 }
 
-void stats_record_read_hit(CacheStats* stats) {
-    stats->read_hits++;
-    stats->total_reads++;
+void stats_record_invalidation_sent(CacheStatsShards* stats) {
+    STATS_INC(own(stats)->invalidations_sent);
 }
 
-void stats_record_read_miss(CacheStats* stats) {
-    stats->read_misses++;
-    stats->total_reads++;
-    stats->bus_reads++;
+void stats_record_invalidation_requested(CacheStatsShards* stats) {
+    STATS_INC(own(stats)->invalidations_requested);
 }
 
-void stats_record_write_hit(CacheStats* stats) {
-    stats->write_hits++;
-    stats->total_writes++;
+void stats_record_atomic(CacheStatsShards* stats) {
+    STATS_INC(own(stats)->atomics);
 }
 
-void stats_record_write_miss(CacheStats* stats) {
-    stats->write_misses++;
-    stats->total_writes++;
-    stats->bus_read_x++;
+void stats_record_atomic_failure(CacheStatsShards* stats) {
+    STATS_INC(own(stats)->atomic_failures);
 }
 
-void stats_record_invalidation_received(CacheStats* stats) {
-    stats->invalidations_received++;
+void stats_record_mwait(CacheStatsShards* stats, uint64_t stall_ns, int timed_out) {
+    CacheStats* s = own(stats);
+    STATS_INC(s->mwaits);
+    STATS_ADD(s->mwait_stall_ns, stall_ns);
+    if (timed_out) {
+        STATS_INC(s->mwait_timeouts);
+    } else if (stall_ns > 0) {
+        STATS_INC(s->mwait_wakeups);
+    }
+}
+
+void stats_record_bus_traffic(CacheStatsShards* stats, uint64_t bytes_read, uint64_t bytes_written) {
+    CacheStats* s = own(stats);
+    STATS_ADD(s->bytes_read_from_bus, bytes_read);
+    STATS_ADD(s->bytes_written_to_bus, bytes_written);
 }
 
-void stats_record_invalidation_sent(CacheStats* stats) {
-    stats->invalidations_sent++;
+void stats_record_bus_upgrade(CacheStatsShards* stats) {
+    STATS_INC(own(stats)->bus_upgrades);
 }
 
-void stats_record_invalidation_requested(CacheStats* stats) {
-       stats->invalidations_requested++;
+void stats_record_writeback(CacheStatsShards* stats) {
+    STATS_INC(own(stats)->bus_writebacks);
+    stats_record_bus_traffic(stats, 0, BLOCK_SIZE * sizeof(double));
 }
 
-void stats_record_bus_traffic(CacheStats* stats, uint64_t bytes_read, uint64_t bytes_written) {
-    stats->bytes_read_from_bus += bytes_read;
-    stats->bytes_written_to_bus += bytes_written;
+void stats_record_ifetch(CacheStatsShards* stats, int miss) {
+    STATS_INC(own(stats)->ifetches);
+    if (miss) {
+        STATS_INC(own(stats)->ifetch_misses);
+        stats_record_bus_traffic(stats, BLOCK_SIZE * sizeof(double), 0);
+    }
 }
 
-void stats_record_mesi_transition(CacheStats* stats, MESI_State from, MESI_State to) {
+void stats_record_mesi_transition(CacheStatsShards* stats, MESI_State from, MESI_State to) {
+       MESITransitions* t = &own(stats)->transitions;
        // Use enum names (M,E,S,I) from config.h; count transitions by semantic state
-       if (from == I && to == E) stats->transitions.I_to_E++;
-       else if (from == I && to == S) stats->transitions.I_to_S++;
-       else if (from == I && to == M) stats->transitions.I_to_M++;
+       if (from == I && to == E) STATS_INC(t->I_to_E);
+       else if (from == I && to == S) STATS_INC(t->I_to_S);
+       else if (from == I && to == M) STATS_INC(t->I_to_M);
 
-       else if (from == E && to == M) stats->transitions.E_to_M++;
-       else if (from == E && to == S) stats->transitions.E_to_S++;
-       else if (from == E && to == I) stats->transitions.E_to_I++;
+       else if (from == E && to == M) STATS_INC(t->E_to_M);
+       else if (from == E && to == S) STATS_INC(t->E_to_S);
+       else if (from == E && to == I) STATS_INC(t->E_to_I);
+
+       else if (from == S && to == M) STATS_INC(t->S_to_M);
+       else if (from == S && to == I) STATS_INC(t->S_to_I);
+
+       else if (from == M && to == S) STATS_INC(t->M_to_S);
+       else if (from == M && to == I) STATS_INC(t->M_to_I);
+}
 
-       else if (from == S && to == M) stats->transitions.S_to_M++;
-       else if (from == S && to == I) stats->transitions.S_to_I++;
+uint64_t stats_bus_requests(const CacheStatsShards* stats) {
+       uint64_t total = 0;
+       for (int i = 0; i < STATS_NUM_SHARDS; i++) {
+              const CacheStats* s = &stats->shard[i].counters;
+              total += STATS_GET(s->bus_reads) + STATS_GET(s->bus_read_x) + STATS_GET(s->bus_upgrades) +
+                       STATS_GET(s->bus_writebacks) + STATS_GET(s->ifetch_misses);
+       }
+       return total;
+}
 
-       else if (from == M && to == S) stats->transitions.M_to_S++;
-       else if (from == M && to == I) stats->transitions.M_to_I++;
+void stats_snapshot(const CacheStatsShards* stats, CacheStats* out) {
+       uint64_t* dst = (uint64_t*)out;
+       memset(out, 0, sizeof(*out));
+       for (int i = 0; i < STATS_NUM_SHARDS; i++) {
+              const uint64_t* src = (const uint64_t*)&stats->shard[i].counters;
+              for (size_t k = 0; k < sizeof(CacheStats) / sizeof(uint64_t); k++) {
+                     dst[k] += STATS_GET(src[k]);
+              }
+       }
 }
 
 void stats_print(const CacheStats* stats, int pe_id) {
@@ -94,6 +167,24 @@ void stats_print(const CacheStats* stats, int pe_id) {
     printf("%sBus%s: BusRd=%lu BusRdX=%lu BusUpgr=%lu WB=%lu\n", 
            B, RESET, stats->bus_reads, stats->bus_read_x, stats->bus_upgrades, stats->bus_writebacks);
     
+    if (stats->ifetches > 0) {
+        uint64_t ihits = stats->ifetches - stats->ifetch_misses;
+        printf("%sI-cache%s: fetches=%lu hits=%lu misses=%lu hit=%.2f%% (%dx%d, BUS_IFETCH=%lu)\n",
+               B, RESET, stats->ifetches, ihits, stats->ifetch_misses,
+               100.0 * ihits / stats->ifetches, ICACHE_SETS, ICACHE_WAYS, stats->ifetch_misses);
+    }
+    
+    if (stats->atomics > 0) {
+        printf("%sAtomics%s: ops=%lu failed=%lu\n", 
+               B, RESET, stats->atomics, stats->atomic_failures);
+    }
+    
+    if (stats->mwaits > 0) {
+        printf("%sMonitor%s: mwait=%lu woken=%lu timeouts=%lu stall=%.3f ms\n",
+               B, RESET, stats->mwaits, stats->mwait_wakeups, stats->mwait_timeouts,
+               stats->mwait_stall_ns / 1e6);
+    }
+    
     double total_mb = (stats->bytes_read_from_bus + stats->bytes_written_to_bus) / (1024.0 * 1024.0);
        printf("%sTraffic (data only)%s: read=%lu (%.2f KB) written=%lu (%.2f KB) total=%.6f MB\n", 
            B, RESET,
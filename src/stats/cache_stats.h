@@ -3,6 +3,7 @@
 
 #include <stdint.h>
 #include "config.h"
+#include "stats_shard.h"
 
 /**
  * @brief Structure to store MESI state transitions
@@ -52,6 +53,20 @@ typedef struct {
     uint64_t bus_upgrades;    // BusUpgr issued
     uint64_t bus_writebacks;  // Writebacks to memory
     
+    // Atomic read-modify-write operations (FAA, CAS, SC)
+    uint64_t atomics;         // Atomic operations executed
+    uint64_t atomic_failures; // CAS mismatches and failed SCs
+    
+    // Instruction cache
+    uint64_t ifetches;        // Instruction fetches
+    uint64_t ifetch_misses;   // Fetch misses (each one is a BUS_IFETCH)
+    
+    // MONITOR/MWAIT
+    uint64_t mwaits;          // MWAIT instructions executed
+    uint64_t mwait_wakeups;   // Sleeps ended by a write to the monitored block
+    uint64_t mwait_timeouts;  // Sleeps ended by MWAIT_TIMEOUT_US
+    uint64_t mwait_stall_ns;  // Host time spent sleeping in MWAIT
+    
     // MESI transitions
     MESITransitions transitions;
     
@@ -61,57 +76,104 @@ typedef struct {
     
 } CacheStats;
 
+/**
+ * @brief Counters of one cache, one shard per writer thread
+ *
+ * The owning PE thread writes STATS_SHARD_PE; the bus thread writes
+ * STATS_SHARD_BUS (snoop transitions, invalidations received/sent,
+ * callbacks). Each shard starts on its own host cache line.
+ */
+typedef enum {
+    STATS_SHARD_PE,
+    STATS_SHARD_BUS,
+    STATS_NUM_SHARDS
+} StatsShard;
+
+typedef struct {
+    _Alignas(HOST_CACHE_LINE) CacheStats counters;
+} CacheStatsShard;
+
+typedef struct {
+    CacheStatsShard shard[STATS_NUM_SHARDS];
+} CacheStatsShards;
+
+// Shard the calling thread writes (STATS_SHARD_PE unless the thread sets it)
+extern _Thread_local int stats_thread_shard;
+
 /**
  * @brief Initialize cache statistics
  *
  * @param stats Pointer to stats structure
  */
-void stats_init(CacheStats* stats);
+void stats_init(CacheStatsShards* stats);
 
 /**
  * @brief Record a read hit
  *
  * @param stats Pointer to stats
  */
-void stats_record_read_hit(CacheStats* stats);
+void stats_record_read_hit(CacheStatsShards* stats);
 
 /**
  * @brief Record a read miss
  *
  * @param stats Pointer to stats
  */
-void stats_record_read_miss(CacheStats* stats);
+void stats_record_read_miss(CacheStatsShards* stats);
 
 /**
  * @brief Record a write hit
  *
  * @param stats Pointer to stats
  */
-void stats_record_write_hit(CacheStats* stats);
+void stats_record_write_hit(CacheStatsShards* stats);
 
 /**
  * @brief Record a write miss
  *
  * @param stats Pointer to stats
  */
-void stats_record_write_miss(CacheStats* stats);
+void stats_record_write_miss(CacheStatsShards* stats);
 
 /**
  * @brief Record a received invalidation
  *
  * @param stats Pointer to stats
  */
-void stats_record_invalidation_received(CacheStats* stats);
+void stats_record_invalidation_received(CacheStatsShards* stats);
 
 /**
  * @brief Record a sent invalidation
  *
  * @param stats Pointer to stats
  */
-void stats_record_invalidation_sent(CacheStats* stats);
+void stats_record_invalidation_sent(CacheStatsShards* stats);
 
 // Record an invalidation request (attempt) from this PE (BusRdX/Upgr issued)
-void stats_record_invalidation_requested(CacheStats* stats);
+void stats_record_invalidation_requested(CacheStatsShards* stats);
+
+/**
+ * @brief Record an atomic operation (FAA, CAS or SC)
+ *
+ * @param stats Pointer to stats
+ */
+void stats_record_atomic(CacheStatsShards* stats);
+
+/**
+ * @brief Record a failed atomic operation (CAS mismatch or SC without reservation)
+ *
+ * @param stats Pointer to stats
+ */
+void stats_record_atomic_failure(CacheStatsShards* stats);
+
+/**
+ * @brief Record one MWAIT and the time it stalled the PE
+ *
+ * @param stats Pointer to stats
+ * @param stall_ns Nanoseconds slept (0 if the monitor had already triggered)
+ * @param timed_out 1 if the sleep ended by timeout instead of a monitor hit
+ */
+void stats_record_mwait(CacheStatsShards* stats, uint64_t stall_ns, int timed_out);
 
 /**
  * @brief Record bus traffic (bytes)
@@ -120,7 +182,7 @@ void stats_record_invalidation_requested(CacheStats* stats);
  * @param bytes_read Bytes read from bus
  * @param bytes_written Bytes written to bus
  */
-void stats_record_bus_traffic(CacheStats* stats, uint64_t bytes_read, uint64_t bytes_written);
+void stats_record_bus_traffic(CacheStatsShards* stats, uint64_t bytes_read, uint64_t bytes_written);
 
 /**
  * @brief Record a MESI state transition
@@ -129,7 +191,32 @@ void stats_record_bus_traffic(CacheStats* stats, uint64_t bytes_read, uint64_t b
  * @param from Source state (I/E/S/M)
  * @param to Destination state (I/E/S/M)
  */
-void stats_record_mesi_transition(CacheStats* stats, MESI_State from, MESI_State to);
+void stats_record_mesi_transition(CacheStatsShards* stats, MESI_State from, MESI_State to);
+
+/**
+ * @brief Bus requests issued by this PE (BusRd + BusRdX + BusUpgr + WB)
+ *
+ * @param stats Pointer to stats
+ * @return Total requests issued so far
+ */
+uint64_t stats_bus_requests(const CacheStatsShards* stats);
+
+// Record a BusUpgr issued by this PE
+void stats_record_bus_upgrade(CacheStatsShards* stats);
+
+// Record a writeback of a modified block (eviction or flush), with its bytes
+void stats_record_writeback(CacheStatsShards* stats);
+
+// Record an instruction fetch; a miss also counts the BUS_IFETCH bytes
+void stats_record_ifetch(CacheStatsShards* stats, int miss);
+
+/**
+ * @brief Sum the shards into one CacheStats (exact once the writers stopped)
+ *
+ * @param stats Sharded counters
+ * @param out Aggregated counters
+ */
+void stats_snapshot(const CacheStatsShards* stats, CacheStats* out);
 
 /**
  * @brief Print statistics for one PE
@@ -0,0 +1,154 @@
+#include "latency_stats.h"
+#include <string.h>
+#include "log.h"
+
+// Same order as BusMsg (checked in bus.c)
+static const char* MSG_NAMES[BUS_LATENCY_MSGS] = {
+    "BUS_RD", "BUS_RDX", "BUS_UPGR", "BUS_WB", "BUS_IFETCH"
+};
+
+// HISTOGRAM
+
+void latency_merge(LatencyHistogram* dst, const LatencyHistogram* src) {
+    for (int k = 0; k < LATENCY_BUCKETS; k++) {
+        dst->count[k] += src->count[k];
+    }
+    dst->total_ns += src->total_ns;
+    if (src->max_ns > dst->max_ns) {
+        dst->max_ns = src->max_ns;
+    }
+}
+
+uint64_t latency_count(const LatencyHistogram* h) {
+    uint64_t n = 0;
+    for (int k = 0; k < LATENCY_BUCKETS; k++) {
+        n += h->count[k];
+    }
+    return n;
+}
+
+double latency_percentile(const LatencyHistogram* h, double p) {
+    uint64_t n = latency_count(h);
+    if (n == 0) {
+        return 0.0;
+    }
+    double rank = p * n;
+    uint64_t seen = 0;
+    for (int k = 0; k < LATENCY_BUCKETS; k++) {
+        if (h->count[k] == 0) continue;
+        if (seen + h->count[k] >= rank) {
+            // Linear within [2^(k-1), 2^k), capped by the largest sample
+            double lo = k ? (double)(1ull << (k - 1)) : 0.0;
+            double hi = k ? (double)(1ull << k) : 1.0;
+            double value = lo + (hi - lo) * (rank - seen) / h->count[k];
+            return value < (double)h->max_ns ? value : (double)h->max_ns;
+        }
+        seen += h->count[k];
+    }
+    return (double)h->max_ns;
+}
+
+void bus_latency_init(BusLatencyStats* stats) {
+    memset(stats, 0, sizeof(*stats));
+}
+
+// REPORT
+
+// Human units: 850ns, 12.3us, 1.20ms
+static const char* fmt_ns(double ns, char* buf, size_t size) {
+    if (ns < 1000.0) {
+        snprintf(buf, size, "%.0fns", ns);
+    } else if (ns < 1000000.0) {
+        snprintf(buf, size, "%.1fus", ns / 1000.0);
+    } else {
+        snprintf(buf, size, "%.2fms", ns / 1000000.0);
+    }
+    return buf;
+}
+
+static void print_percentiles(const char* label, const LatencyHistogram* h) {
+    char p50[16], p95[16], p99[16], max[16];
+    printf(" %s=%s/%s/%s (max %s)", label,
+           fmt_ns(latency_percentile(h, 0.50), p50, sizeof(p50)),
+           fmt_ns(latency_percentile(h, 0.95), p95, sizeof(p95)),
+           fmt_ns(latency_percentile(h, 0.99), p99, sizeof(p99)),
+           fmt_ns((double)h->max_ns, max, sizeof(max)));
+}
+
+void bus_latency_print(const BusLatencyStats* stats) {
+    const char* B = log_color_bold();
+    const char* BLUE = log_color_blue();
+    const char* RESET = log_color_reset();
+
+    printf("\n%s[Bus latency]%s (host time, p50/p95/p99)\n", BLUE, RESET);
+
+    printf("%sPer message%s:\n", B, RESET);
+    for (int m = 0; m < BUS_LATENCY_MSGS; m++) {
+        LatencyHistogram wait = {0}, service = {0}, roundtrip = {0};
+        for (int i = 0; i < NUM_PES; i++) {
+            latency_merge(&wait, &stats->wait[i][m]);
+            latency_merge(&service, &stats->service[i][m]);
+            latency_merge(&roundtrip, &stats->pe[i].roundtrip[m]);
+        }
+        uint64_t n = latency_count(&service);
+        if (n == 0) continue;
+        printf("  %-10s n=%-6lu", MSG_NAMES[m], (unsigned long)n);
+        print_percentiles("wait", &wait);
+        print_percentiles("service", &service);
+        print_percentiles("roundtrip", &roundtrip);
+        printf("\n");
+    }
+
+    // Arbitration fairness: a PE starved by round-robin shows a longer wait tail
+    printf("%sPer PE%s (all messages):\n", B, RESET);
+    double p95_min = -1.0, p95_max = 0.0;
+    for (int i = 0; i < NUM_PES; i++) {
+        LatencyHistogram wait = {0}, service = {0}, roundtrip = {0};
+        for (int m = 0; m < BUS_LATENCY_MSGS; m++) {
+            latency_merge(&wait, &stats->wait[i][m]);
+            latency_merge(&service, &stats->service[i][m]);
+            latency_merge(&roundtrip, &stats->pe[i].roundtrip[m]);
+        }
+        uint64_t n = latency_count(&wait);
+        printf("  PE%-2d n=%-6lu", i, (unsigned long)n);
+        print_percentiles("wait", &wait);
+        print_percentiles("service", &service);
+        print_percentiles("roundtrip", &roundtrip);
+        printf("\n");
+        if (n > 0) {
+            double p95 = latency_percentile(&wait, 0.95);
+            if (p95_min < 0.0 || p95 < p95_min) p95_min = p95;
+            if (p95 > p95_max) p95_max = p95;
+        }
+    }
+    if (p95_min > 0.0) {
+        printf("%sArbitration%s: wait p95 max/min across PEs = %.2f\n", B, RESET, p95_max / p95_min);
+    }
+}
+
+static void json_histogram(FILE* f, const char* name, const LatencyHistogram* h) {
+    uint64_t n = latency_count(h);
+    fprintf(f, "\"%s\": {\"count\": %lu, \"mean_ns\": %.1f, \"p50_ns\": %.1f, \"p95_ns\": %.1f, "
+            "\"p99_ns\": %.1f, \"max_ns\": %lu}", name, (unsigned long)n,
+            n ? (double)h->total_ns / n : 0.0, latency_percentile(h, 0.50),
+            latency_percentile(h, 0.95), latency_percentile(h, 0.99), (unsigned long)h->max_ns);
+}
+
+void bus_latency_json(FILE* f, const BusLatencyStats* stats) {
+    fprintf(f, ",\n  \"bus_latency\": [");
+    int first = 1;
+    for (int i = 0; i < NUM_PES; i++) {
+        for (int m = 0; m < BUS_LATENCY_MSGS; m++) {
+            if (latency_count(&stats->service[i][m]) == 0) continue;
+            fprintf(f, "%s\n    {\"pe\": %d, \"msg\": \"%s\", ", first ? "" : ",", i, MSG_NAMES[m]);
+            json_histogram(f, "wait", &stats->wait[i][m]);
+            fprintf(f, ", ");
+            json_histogram(f, "service", &stats->service[i][m]);
+            fprintf(f, ", ");
+            json_histogram(f, "roundtrip", &stats->pe[i].roundtrip[m]);
+            fprintf(f, "}");
+            first = 0;
+        }
+    }
+    fprintf(f, "\n  ]");
+}
@@ -0,0 +1,70 @@
+#ifndef LATENCY_STATS_H
+#define LATENCY_STATS_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include "config.h"
+#include "stats_shard.h"
+
+/**
+ * @file latency_stats.h
+ * @brief Histogramas de latencia del bus (tiempo de reloj del host)
+ *
+ * Por cada PE y tipo de mensaje se separan tres tiempos:
+ *   wait       desde que el PE registra la solicitud hasta que el árbitro
+ *              round-robin la elige (arbitraje)
+ *   service    handler + callback en el hilo del bus
+ *   roundtrip  toda la llamada a bus_broadcast_with_callback vista por el
+ *              PE (incluye despertar su hilo)
+ *
+ * El simulador no tiene modelo de ciclos, así que solo hay tiempo de host.
+ * Los buckets son potencias de 2 (bucket k: [2^(k-1), 2^k) ns) y los
+ * percentiles se interpolan dentro del bucket. wait y service los escribe el
+ * hilo del bus; roundtrip, cada PE en su propia línea.
+ */
+
+#define LATENCY_BUCKETS 40              // Up to 2^39 ns (~9 min)
+#define BUS_LATENCY_MSGS 5              // BUS_RD .. BUS_IFETCH (BusMsg, bus.h)
+
+typedef struct {
+    uint64_t count[LATENCY_BUCKETS];
+    uint64_t total_ns;
+    uint64_t max_ns;
+} LatencyHistogram;
+
+typedef struct {
+    _Alignas(HOST_CACHE_LINE) LatencyHistogram roundtrip[BUS_LATENCY_MSGS];
+} BusLatencyPE;
+
+typedef struct {
+    LatencyHistogram wait[NUM_PES][BUS_LATENCY_MSGS];
+    LatencyHistogram service[NUM_PES][BUS_LATENCY_MSGS];
+    BusLatencyPE pe[NUM_PES];
+} BusLatencyStats;
+
+// Single writer per histogram (see above)
+static inline void latency_record(LatencyHistogram* h, uint64_t ns) {
+    int bucket = ns ? 64 - __builtin_clzll(ns) : 0;
+    if (bucket >= LATENCY_BUCKETS) bucket = LATENCY_BUCKETS - 1;
+    STATS_INC(h->count[bucket]);
+    STATS_ADD(h->total_ns, ns);
+    if (ns > h->max_ns) {
+        __atomic_store_n(&h->max_ns, ns, __ATOMIC_RELAXED);
+    }
+}
+
+void latency_merge(LatencyHistogram* dst, const LatencyHistogram* src);
+uint64_t latency_count(const LatencyHistogram* h);
+
+// p in [0, 1]; 0 if the histogram is empty
+double latency_percentile(const LatencyHistogram* h, double p);
+
+void bus_latency_init(BusLatencyStats* stats);
+
+// Prints the [Bus latency] section: p50/p95/p99 per message type and per PE
+void bus_latency_print(const BusLatencyStats* stats);
+
+// "bus_latency" array of SIM_STATS_JSON: one entry per PE and message type used
+void bus_latency_json(FILE* f, const BusLatencyStats* stats);
+
+#endif // LATENCY_STATS_H
@@ -8,22 +8,22 @@ void memory_stats_init(MemoryStats* stats) {
 }
 
 void memory_stats_record_read(MemoryStats* stats, int pe_id, int bytes) {
-    stats->reads++;
-    stats->total_accesses++;
-    stats->bytes_read += bytes;
+    STATS_INC(stats->reads);
+    STATS_INC(stats->total_accesses);
+    STATS_ADD(stats->bytes_read, bytes);
     
-    if (pe_id >= 0 && pe_id < 4) {
-        stats->reads_per_pe[pe_id]++;
+    if (pe_id >= 0 && pe_id < NUM_PES) {
+        STATS_INC(stats->reads_per_pe[pe_id]);
     }
 }
 
 void memory_stats_record_write(MemoryStats* stats, int pe_id, int bytes) {
-    stats->writes++;
-    stats->total_accesses++;
-    stats->bytes_written += bytes;
+    STATS_INC(stats->writes);
+    STATS_INC(stats->total_accesses);
+    STATS_ADD(stats->bytes_written, bytes);
     
-    if (pe_id >= 0 && pe_id < 4) {
-        stats->writes_per_pe[pe_id]++;
+    if (pe_id >= 0 && pe_id < NUM_PES) {
+        STATS_INC(stats->writes_per_pe[pe_id]);
     }
 }
 
@@ -44,7 +44,7 @@ void memory_stats_print(const MemoryStats* stats) {
         B, RESET, stats->bytes_read, read_kb, stats->bytes_written, write_kb, total_mb);
 
     printf("%sAccesses per PE%s:\n", B, RESET);
-    for (int i = 0; i < 4; i++) {
+    for (int i = 0; i < NUM_PES; i++) {
         uint64_t total_pe = stats->reads_per_pe[i] + stats->writes_per_pe[i];
         printf("  PE%d: reads=%lu writes=%lu total=%lu\n",
                i, stats->reads_per_pe[i], stats->writes_per_pe[i], total_pe);
@@ -2,6 +2,8 @@
 #define MEMORY_STATS_H
 
 #include <stdint.h>
+#include "config.h"
+#include "stats_shard.h"
 
 /**
  * @brief Statistics for main memory accesses
@@ -14,8 +16,8 @@ typedef struct {
     uint64_t bytes_written;            // Bytes written
     
     // Accesses per PE (to see which PE uses memory more)
-    uint64_t reads_per_pe[4];
-    uint64_t writes_per_pe[4];
+    uint64_t reads_per_pe[NUM_PES];
+    uint64_t writes_per_pe[NUM_PES];
 } MemoryStats;
 
 /**
@@ -0,0 +1,85 @@
+#define _GNU_SOURCE  // RUSAGE_THREAD
+#include "sched_stats.h"
+#include <stdio.h>
+#include <string.h>
+#include <sys/resource.h>
+#include "log.h"
+
+void sched_stats_init(SchedStats* stats) {
+    memset(stats, 0, sizeof(SchedStats));
+}
+
+uint64_t sched_stats_instructions(const SchedStats* stats) {
+    uint64_t total = 0;
+    for (int i = 0; i < NUM_PES; i++) {
+        total += STATS_GET(stats->pe[i].instructions);
+    }
+    return total;
+}
+
+void sched_stats_print(const SchedStats* stats, const char* mode_name, int quantum) {
+    const char* B = log_color_bold();
+    const char* BLUE = log_color_blue();
+    const char* RESET = log_color_reset();
+
+    printf("\n%s[Scheduler statistics]%s\n", BLUE, RESET);
+    if (quantum > 0) {
+        printf("%sMode%s: %s (quantum=%d instructions)\n", B, RESET, mode_name, quantum);
+    } else {
+        printf("%sMode%s: %s\n", B, RESET, mode_name);
+    }
+
+    uint64_t total = 0;
+    double sum = 0.0, sum_sq = 0.0;
+    for (int i = 0; i < NUM_PES; i++) {
+        total += stats->pe[i].instructions;
+        sum += (double)stats->pe[i].instructions;
+        sum_sq += (double)stats->pe[i].instructions * (double)stats->pe[i].instructions;
+    }
+
+    printf("%sPer PE%s:\n", B, RESET);
+    for (int i = 0; i < NUM_PES; i++) {
+        double share = total > 0 ? (100.0 * stats->pe[i].instructions / total) : 0.0;
+        double avg_slice = stats->pe[i].quanta > 0 ?
+            ((double)stats->pe[i].instructions / stats->pe[i].quanta) : 0.0;
+        printf("  PE%d: instructions=%lu (%.2f%%) quanta=%lu bus_preempted=%lu avg_slice=%.2f wait=%.3f ms cpu=%.3f ms\n",
+               i, stats->pe[i].instructions, share, stats->pe[i].quanta, stats->pe[i].bus_preempted,
+               avg_slice, stats->pe[i].wait_ns / 1e6,
+               (stats->pe[i].cpu.user_ns + stats->pe[i].cpu.sys_ns) / 1e6);
+    }
+
+    // Jain's fairness index over executed instructions: 1.0 = perfectly even
+    double jain = sum_sq > 0.0 ? (sum * sum) / (NUM_PES * sum_sq) : 0.0;
+    printf("%sFairness%s: jain_index=%.4f epochs=%lu max_epoch_skew=%lu\n",
+           B, RESET, jain, stats->epochs, stats->max_epoch_skew);
+
+    double wall_s = stats->end_ns > stats->start_ns ?
+        (stats->end_ns - stats->start_ns) / 1e9 : 0.0;
+    double ips = wall_s > 0.0 ? total / wall_s : 0.0;
+    printf("%sHost throughput%s: instructions=%lu wall=%.6f s rate=%.0f instr/s\n",
+           B, RESET, total, wall_s, ips);
+}
+
+void host_cpu_self(HostCpu* out) {
+    struct rusage usage;
+    if (getrusage(RUSAGE_THREAD, &usage) != 0) {
+        out->user_ns = out->sys_ns = 0;
+        return;
+    }
+    out->user_ns = (uint64_t)usage.ru_utime.tv_sec * 1000000000ull + (uint64_t)usage.ru_utime.tv_usec * 1000ull;
+    out->sys_ns = (uint64_t)usage.ru_stime.tv_sec * 1000000000ull + (uint64_t)usage.ru_stime.tv_usec * 1000ull;
+}
+
+void host_cpu_print(const SchedStats* stats, const HostCpu* bus, const HostCpu* mem) {
+    const char* B = log_color_bold();
+    const char* RESET = log_color_reset();
+
+    HostCpu pes = { 0, 0 };
+    for (int i = 0; i < NUM_PES; i++) {
+        pes.user_ns += stats->pe[i].cpu.user_ns;
+        pes.sys_ns += stats->pe[i].cpu.sys_ns;
+    }
+    printf("%sHost CPU%s: pe_user=%.6f pe_sys=%.6f bus_user=%.6f bus_sys=%.6f mem_user=%.6f mem_sys=%.6f s\n",
+           B, RESET, pes.user_ns / 1e9, pes.sys_ns / 1e9, bus->user_ns / 1e9, bus->sys_ns / 1e9,
+           mem->user_ns / 1e9, mem->sys_ns / 1e9);
+}
@@ -0,0 +1,62 @@
+#ifndef SCHED_STATS_H
+#define SCHED_STATS_H
+
+#include <stdint.h>
+#include "config.h"
+#include "stats_shard.h"
+
+// Host CPU time of one simulator thread, read by the thread itself
+typedef struct {
+    uint64_t user_ns;
+    uint64_t sys_ns;
+} HostCpu;
+
+/**
+ * @brief PE scheduler statistics (fairness and host throughput)
+ */
+// Per-PE counters, only written by their own PE thread. Each PE has its
+// own host cache line: instructions is updated on every instruction.
+typedef struct {
+    _Alignas(HOST_CACHE_LINE) uint64_t instructions; // Instructions executed
+    uint64_t quanta;                   // Quanta completed (synchronization points)
+    uint64_t bus_preempted;            // Quanta cut short by a bus request
+    uint64_t wait_ns;                  // Host time spent waiting at the quantum barrier
+    HostCpu cpu;                       // Host CPU of the PE thread, taken when it leaves the scheduler
+} SchedPEStats;
+
+typedef struct {
+    SchedPEStats pe[NUM_PES];
+
+    // Global counters (updated under the scheduler mutex)
+    uint64_t epochs;                   // Quantum barriers released
+    uint64_t max_epoch_skew;           // Max instruction spread between PEs inside one epoch
+
+    // Host wall time of the parallel section
+    uint64_t start_ns;
+    uint64_t end_ns;
+} SchedStats;
+
+/**
+ * @brief Initialize scheduler statistics
+ */
+void sched_stats_init(SchedStats* stats);
+
+// Instructions retired by all PEs so far
+uint64_t sched_stats_instructions(const SchedStats* stats);
+
+/**
+ * @brief Print scheduler statistics
+ *
+ * @param stats Pointer to stats
+ * @param mode_name Scheduling mode name ("yield" or "quantum")
+ * @param quantum Instructions per quantum (ignored in yield mode)
+ */
+void sched_stats_print(const SchedStats* stats, const char* mode_name, int quantum);
+
+// Host CPU used so far by the calling thread (getrusage RUSAGE_THREAD)
+void host_cpu_self(HostCpu* out);
+
+// Host CPU of the PE threads (summed), the bus thread and the memory thread
+void host_cpu_print(const SchedStats* stats, const HostCpu* bus, const HostCpu* mem);
+
+#endif // SCHED_STATS_H
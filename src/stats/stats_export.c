@@ -0,0 +1,288 @@
+#include "stats_export.h"
+#include <stdlib.h>
+#include <string.h>
+#include "log.h"
+
+// COUNTER LISTS (same order as the structs)
+
+#define CACHE_COUNTERS(X) \
+    X(read_hits) X(read_misses) X(write_hits) X(write_misses) \
+    X(invalidations_requested) X(invalidations_sent) X(invalidations_received) \
+    X(total_reads) X(total_writes) \
+    X(bus_reads) X(bus_read_x) X(bus_upgrades) X(bus_writebacks) \
+    X(atomics) X(atomic_failures) X(ifetches) X(ifetch_misses) \
+    X(mwaits) X(mwait_wakeups) X(mwait_timeouts) X(mwait_stall_ns)
+
+#define TRANSITION_COUNTERS(X) \
+    X(I_to_E) X(I_to_S) X(I_to_M) X(E_to_M) X(E_to_S) X(E_to_I) \
+    X(S_to_M) X(S_to_I) X(M_to_S) X(M_to_I)
+
+#define CACHE_BYTE_COUNTERS(X) X(bytes_read_from_bus) X(bytes_written_to_bus)
+
+#define BUS_COUNTERS(X) \
+    X(bus_rd_count) X(bus_rdx_count) X(bus_upgr_count) X(bus_wb_count) X(bus_ifetch_count) \
+    X(invalidations_sent) X(total_transactions) X(bytes_transferred) \
+    X(bytes_data) X(bytes_control) X(bytes_control_base) X(bytes_control_invs) \
+    X(sync_transactions)
+
+#define MEMORY_COUNTERS(X) \
+    X(reads) X(writes) X(total_accesses) X(bytes_read) X(bytes_written)
+
+#define SCHED_PE_COUNTERS(X) X(instructions) X(quanta) X(bus_preempted) X(wait_ns)
+
+#define COUNT(name) + 1
+// A counter added to a struct must also be added to its list
+_Static_assert(sizeof(CacheStats) / sizeof(uint64_t) ==
+               0 CACHE_COUNTERS(COUNT) TRANSITION_COUNTERS(COUNT) CACHE_BYTE_COUNTERS(COUNT),
+               "CACHE_COUNTERS out of date");
+_Static_assert(sizeof(BusStats) / sizeof(uint64_t) == 0 BUS_COUNTERS(COUNT) + NUM_PES,
+               "BUS_COUNTERS out of date");
+_Static_assert(sizeof(MemoryStats) / sizeof(uint64_t) == 0 MEMORY_COUNTERS(COUNT) + 2 * NUM_PES,
+               "MEMORY_COUNTERS out of date");
+
+static const char* kernel_name(void) {
+    const char* env_kernel = getenv("SIM_KERNEL");
+    return (env_kernel && *env_kernel) ? env_kernel : "scalar";
+}
+
+static uint64_t wall_ns(const SchedStats* sched) {
+    return sched->end_ns > sched->start_ns ? sched->end_ns - sched->start_ns : 0;
+}
+
+// JSON
+
+static void json_u64_array(FILE* f, const char* name, const uint64_t* values) {
+    fprintf(f, "\"%s\": [", name);
+    for (int i = 0; i < NUM_PES; i++) {
+        fprintf(f, "%s%lu", i ? ", " : "", (unsigned long)values[i]);
+    }
+    fprintf(f, "]");
+}
+
+#define JSON_FIELD(name) fprintf(f, ", \"" #name "\": %lu", (unsigned long)s->name);
+#define JSON_TRANSITION(name) fprintf(f, "%s\"" #name "\": %lu", first ? "" : ", ", \
+                                      (unsigned long)s->transitions.name); first = 0;
+
+static void json_cache(FILE* f, const CacheStats* s, int pe_id) {
+    int first = 1;
+    fprintf(f, "    {\"pe\": %d", pe_id);
+    CACHE_COUNTERS(JSON_FIELD)
+    CACHE_BYTE_COUNTERS(JSON_FIELD)
+    fprintf(f, ", \"transitions\": {");
+    TRANSITION_COUNTERS(JSON_TRANSITION)
+    fprintf(f, "}}");
+}
+
+static void json_bus(FILE* f, const BusStats* s) {
+    fprintf(f, "  \"bus\": {");
+    json_u64_array(f, "transactions_per_pe", s->transactions_per_pe);
+    BUS_COUNTERS(JSON_FIELD)
+    fprintf(f, "},\n");
+}
+
+static void json_memory(FILE* f, const MemoryStats* s) {
+    fprintf(f, "  \"memory\": {");
+    json_u64_array(f, "reads_per_pe", s->reads_per_pe);
+    fprintf(f, ", ");
+    json_u64_array(f, "writes_per_pe", s->writes_per_pe);
+    MEMORY_COUNTERS(JSON_FIELD)
+    fprintf(f, "},\n");
+}
+
+static void json_sched(FILE* f, const StatsReport* r) {
+    const SchedStats* sched = r->sched;
+    fprintf(f, "  \"scheduler\": {\"mode\": \"%s\", \"quantum\": %d, \"pes\": [", r->sched_mode, r->quantum);
+    for (int i = 0; i < NUM_PES; i++) {
+        const SchedPEStats* s = &sched->pe[i];
+        fprintf(f, "%s{\"pe\": %d", i ? ", " : "", i);
+        SCHED_PE_COUNTERS(JSON_FIELD)
+        fprintf(f, "}");
+    }
+    fprintf(f, "], \"epochs\": %lu, \"max_epoch_skew\": %lu, \"instructions\": %lu, \"wall_ns\": %lu}",
+            (unsigned long)sched->epochs, (unsigned long)sched->max_epoch_skew,
+            (unsigned long)sched_stats_instructions(sched), (unsigned long)wall_ns(sched));
+}
+
+static uint64_t cache_accesses(const CacheStats* s) {
+    return s->total_reads + s->total_writes;
+}
+
+static uint64_t cache_misses(const CacheStats* s) {
+    return s->read_misses + s->write_misses;
+}
+
+static uint64_t cache_bus_bytes(const CacheStats* s) {
+    return s->bytes_read_from_bus + s->bytes_written_to_bus;
+}
+
+static void json_sample(FILE* f, const StatsSample* sample) {
+    fprintf(f, "    {\"instructions\": %lu, \"host_ns\": %lu, \"consistent\": %d, \"pes\": [",
+            (unsigned long)sample->instructions, (unsigned long)sample->host_ns, sample->consistent);
+    for (int i = 0; i < NUM_PES; i++) {
+        const CacheStats* s = &sample->caches[i];
+        fprintf(f, "%s{\"instructions\": %lu, \"accesses\": %lu, \"misses\": %lu, "
+                "\"invalidations_received\": %lu, \"bus_bytes\": %lu}", i ? ", " : "",
+                (unsigned long)sample->pe_instructions[i], (unsigned long)cache_accesses(s),
+                (unsigned long)cache_misses(s), (unsigned long)s->invalidations_received,
+                (unsigned long)cache_bus_bytes(s));
+    }
+    fprintf(f, "], \"bus\": {\"transactions\": %lu, \"bytes\": %lu, \"invalidations\": %lu}, "
+            "\"memory\": {\"reads\": %lu, \"writes\": %lu}}",
+            (unsigned long)sample->bus.total_transactions, (unsigned long)sample->bus.bytes_transferred,
+            (unsigned long)sample->bus.invalidations_sent,
+            (unsigned long)sample->memory.reads, (unsigned long)sample->memory.writes);
+}
+
+// Blocks with bus traffic only: the table covers all of memory
+static void json_blocks(FILE* f, const StatsReport* r) {
+    const BlockStats* stats = r->blocks;
+    fprintf(f, ",\n  \"blocks\": [");
+    int first = 1;
+    for (int b = 0; b < BLOCK_STATS_BLOCKS; b++) {
+        const BlockBusCounters* c = &stats->bus[b];
+        if (c->transactions == 0) continue;
+        char name[64] = "";
+        if (r->region) {
+            r->region(b * BLOCK_SIZE, name, sizeof(name));
+        }
+        fprintf(f, "%s\n    {\"addr\": %d, \"region\": \"%s\", \"class\": \"%s\", "
+                "\"transactions\": %lu, \"invalidations\": %lu, \"upgrades\": %lu, "
+                "\"ping_pongs\": %lu, \"words\": [", first ? "" : ",", b * BLOCK_SIZE, name,
+                block_class_name(block_stats_classify(stats, b)),
+                (unsigned long)c->transactions, (unsigned long)c->invalidations,
+                (unsigned long)c->upgrades, (unsigned long)c->ping_pongs);
+        for (int i = 0; i < NUM_PES; i++) {
+            char words[BLOCK_SIZE + 1];
+            block_stats_words(stats, b, i, words);
+            fprintf(f, "%s\"%s\"", i ? ", " : "", words);
+        }
+        fprintf(f, "]}");
+        first = 0;
+    }
+    fprintf(f, "\n  ]");
+}
+
+int stats_export_json(const char* path, const StatsReport* report,
+                      const StatsSample* samples, size_t count) {
+    FILE* f = fopen(path, "w");
+    if (!f) {
+        LOGE("Could not open %s for the JSON stats", path);
+        return -1;
+    }
+
+    fprintf(f, "{\n  \"config\": {\"num_pes\": %d, \"sets\": %d, \"ways\": %d, \"block_size\": %d, "
+            "\"mem_size\": %d, \"icache_sets\": %d, \"icache_ways\": %d, \"kernel\": \"%s\"},\n",
+            NUM_PES, SETS, WAYS, BLOCK_SIZE, MEM_SIZE, ICACHE_SETS, ICACHE_WAYS, kernel_name());
+
+    fprintf(f, "  \"caches\": [\n");
+    for (int i = 0; i < NUM_PES; i++) {
+        json_cache(f, &report->caches[i], i);
+        fprintf(f, "%s\n", i < NUM_PES - 1 ? "," : "");
+    }
+    fprintf(f, "  ],\n");
+
+    json_bus(f, report->bus);
+    json_memory(f, report->memory);
+    json_sched(f, report);
+    if (report->blocks) {
+        json_blocks(f, report);
+    }
+    if (report->latency) {
+        bus_latency_json(f, report->latency);
+    }
+
+    if (count > 0) {
+        fprintf(f, ",\n  \"timeseries\": [\n");
+        for (size_t i = 0; i < count; i++) {
+            json_sample(f, &samples[i]);
+            fprintf(f, "%s\n", i < count - 1 ? "," : "");
+        }
+        fprintf(f, "  ]");
+    }
+    fprintf(f, "\n}\n");
+
+    return fclose(f) == 0 ? 0 : -1;
+}
+
+// CSV
+
+#define CSV_FIELD(name) fprintf(f, "%s,%s,%s,%lu\n", section, pe, #name, (unsigned long)s->name);
+#define CSV_TRANSITION(name) fprintf(f, "%s,%s,%s,%lu\n", section, pe, #name, \
+                                     (unsigned long)s->transitions.name);
+
+int stats_export_csv(const char* path, const StatsReport* report) {
+    FILE* f = fopen(path, "w");
+    if (!f) {
+        LOGE("Could not open %s for the CSV stats", path);
+        return -1;
+    }
+    fprintf(f, "section,pe,counter,value\n");
+
+    char pe[16];
+    const char* section = "cache";
+    for (int i = 0; i < NUM_PES; i++) {
+        const CacheStats* s = &report->caches[i];
+        snprintf(pe, sizeof(pe), "%d", i);
+        CACHE_COUNTERS(CSV_FIELD)
+        TRANSITION_COUNTERS(CSV_TRANSITION)
+        CACHE_BYTE_COUNTERS(CSV_FIELD)
+    }
+
+    section = "bus";
+    {
+        const BusStats* s = report->bus;
+        pe[0] = '\0';
+        BUS_COUNTERS(CSV_FIELD)
+        for (int i = 0; i < NUM_PES; i++) {
+            fprintf(f, "bus,%d,transactions,%lu\n", i, (unsigned long)s->transactions_per_pe[i]);
+        }
+    }
+
+    section = "memory";
+    {
+        const MemoryStats* s = report->memory;
+        pe[0] = '\0';
+        MEMORY_COUNTERS(CSV_FIELD)
+        for (int i = 0; i < NUM_PES; i++) {
+            fprintf(f, "memory,%d,reads,%lu\n", i, (unsigned long)s->reads_per_pe[i]);
+            fprintf(f, "memory,%d,writes,%lu\n", i, (unsigned long)s->writes_per_pe[i]);
+        }
+    }
+
+    section = "scheduler";
+    for (int i = 0; i < NUM_PES; i++) {
+        const SchedPEStats* s = &report->sched->pe[i];
+        snprintf(pe, sizeof(pe), "%d", i);
+        SCHED_PE_COUNTERS(CSV_FIELD)
+    }
+    fprintf(f, "scheduler,,epochs,%lu\n", (unsigned long)report->sched->epochs);
+    fprintf(f, "scheduler,,max_epoch_skew,%lu\n", (unsigned long)report->sched->max_epoch_skew);
+    fprintf(f, "scheduler,,wall_ns,%lu\n", (unsigned long)wall_ns(report->sched));
+
+    return fclose(f) == 0 ? 0 : -1;
+}
+
+// TIME SERIES
+
+void stats_series_csv_header(FILE* f) {
+    fprintf(f, "instructions,host_ns,consistent");
+    for (int i = 0; i < NUM_PES; i++) {
+        fprintf(f, ",pe%d_instructions,pe%d_accesses,pe%d_misses,pe%d_invalidations,pe%d_bus_bytes",
+                i, i, i, i, i);
+    }
+    fprintf(f, ",bus_transactions,bus_bytes,bus_invalidations,mem_reads,mem_writes\n");
+}
+
+void stats_series_csv_row(FILE* f, const StatsSample* sample) {
+    fprintf(f, "%lu,%lu,%d", (unsigned long)sample->instructions, (unsigned long)sample->host_ns,
+            sample->consistent);
+    for (int i = 0; i < NUM_PES; i++) {
+        const CacheStats* s = &sample->caches[i];
+        fprintf(f, ",%lu,%lu,%lu,%lu,%lu", (unsigned long)sample->pe_instructions[i],
+                (unsigned long)cache_accesses(s), (unsigned long)cache_misses(s),
+                (unsigned long)s->invalidations_received, (unsigned long)cache_bus_bytes(s));
+    }
+    fprintf(f, ",%lu,%lu,%lu,%lu,%lu\n", (unsigned long)sample->bus.total_transactions,
+            (unsigned long)sample->bus.bytes_transferred, (unsigned long)sample->bus.invalidations_sent,
+            (unsigned long)sample->memory.reads, (unsigned long)sample->memory.writes);
+}
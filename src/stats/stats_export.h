@@ -0,0 +1,67 @@
+#ifndef STATS_EXPORT_H
+#define STATS_EXPORT_H
+
+#include <stdio.h>
+#include "config.h"
+#include "cache_stats.h"
+#include "bus_stats.h"
+#include "memory_stats.h"
+#include "sched_stats.h"
+#include "block_stats.h"
+#include "latency_stats.h"
+
+/**
+ * @file stats_export.h
+ * @brief Exportación de todas las estadísticas en JSON y CSV
+ *
+ * Variables de entorno (leídas por main):
+ *   SIM_STATS_JSON=<archivo>   objeto con config, caches, bus, memory,
+ *                              scheduler, blocks (bloques con tráfico de bus),
+ *                              bus_latency (percentiles por PE y mensaje)
+ *                              y timeseries (si hay muestreo)
+ *   SIM_STATS_CSV=<archivo>    formato largo: section,pe,counter,value
+ *                              (pe vacío en los contadores globales)
+ */
+
+// Final counters of one run (aggregated, read after the PEs finished)
+typedef struct {
+    const CacheStats* caches;       // NUM_PES entries
+    const BusStats* bus;
+    const MemoryStats* memory;
+    const SchedStats* sched;
+    const char* sched_mode;
+    int quantum;                    // 0 in yield mode
+    const BlockStats* blocks;       // NULL if per-block tracking is off
+    BlockRegionFn region;           // NULL: no region names
+    const BusLatencyStats* latency; // NULL: no latency histograms
+} StatsReport;
+
+// One point of the time series (cumulative counters, see sampler.h)
+typedef struct {
+    uint64_t instructions;          // Retired by all PEs
+    uint64_t host_ns;               // Since the start of the parallel section
+    int consistent;                 // 1: all counters held these values at one instant
+    uint64_t pe_instructions[NUM_PES];
+    CacheStats caches[NUM_PES];
+    BusStats bus;
+    MemoryStats memory;
+} StatsSample;
+
+/**
+ * @brief Escribe el informe (y la serie temporal, si count > 0) en JSON
+ * @return 0 si OK, -1 si no se pudo escribir
+ */
+int stats_export_json(const char* path, const StatsReport* report,
+                      const StatsSample* samples, size_t count);
+
+/**
+ * @brief Escribe el informe en CSV (una fila por contador)
+ * @return 0 si OK, -1 si no se pudo escribir
+ */
+int stats_export_csv(const char* path, const StatsReport* report);
+
+// CSV header and rows of the time series (one row per sample)
+void stats_series_csv_header(FILE* f);
+void stats_series_csv_row(FILE* f, const StatsSample* sample);
+
+#endif // STATS_EXPORT_H
@@ -0,0 +1,28 @@
+#ifndef STATS_SHARD_H
+#define STATS_SHARD_H
+
+#include "config.h"
+
+/**
+ * @file stats_shard.h
+ * @brief Contadores de estadísticas sin contención entre hilos
+ *
+ * Cada contador tiene un único hilo escritor (su PE, el bus o la memoria) y
+ * vive en líneas de HOST_CACHE_LINE bytes que no comparte con datos de otros
+ * hilos. Los contadores de una caché que actualizan dos hilos (el PE y el
+ * bus, en snoops y callbacks) se dividen en un shard por hilo y se suman al
+ * leerlos.
+ *
+ * Con un solo escritor, una carga y un store relajados son exactos y no usan
+ * instrucciones con lock; los lectores concurrentes (depurador, checkpoint,
+ * cuenta de peticiones al bus) nunca ven un valor a medias.
+ */
+
+#define STATS_ADD(counter, n) \
+    __atomic_store_n(&(counter), __atomic_load_n(&(counter), __ATOMIC_RELAXED) + (n), __ATOMIC_RELAXED)
+
+#define STATS_INC(counter) STATS_ADD(counter, 1)
+
+#define STATS_GET(counter) __atomic_load_n(&(counter), __ATOMIC_RELAXED)
+
+#endif // STATS_SHARD_H
@@ -0,0 +1,153 @@
+#define LOG_MODULE "TRACE"
+#include "trace.h"
+#include "config.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <time.h>
+#include "log.h"
+
+#define TRACE_MAX_THREADS 16
+
+typedef struct {
+    TraceRecord records[TRACE_BUFFER_RECORDS];
+    int count;
+} TraceBuffer;
+
+bool trace_enabled = false;
+
+static FILE* TRACE_FILE;
+static pthread_mutex_t TRACE_MUTEX = PTHREAD_MUTEX_INITIALIZER;  // File writes and registration
+static TraceBuffer* BUFFERS[TRACE_MAX_THREADS];
+static int NUM_BUFFERS;
+static _Atomic uint64_t TRACE_SEQ;
+static uint64_t TRACE_T0;
+static uint64_t TRACE_WRITTEN;
+
+static _Thread_local TraceBuffer* TLS_BUF;
+static _Thread_local int TLS_MSG = TRACE_NO_MSG;
+static _Thread_local int TLS_SRC_PE = TRACE_NO_PE;
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+// Caller holds TRACE_MUTEX
+static void write_buffer(TraceBuffer* buf) {
+    if (buf->count == 0) return;
+    if (fwrite(buf->records, sizeof(TraceRecord), (size_t)buf->count, TRACE_FILE) != (size_t)buf->count) {
+        LOGW("Short write, trace truncated");
+    }
+    TRACE_WRITTEN += (uint64_t)buf->count;
+    buf->count = 0;
+}
+
+static TraceBuffer* thread_buffer(void) {
+    if (TLS_BUF) return TLS_BUF;
+
+    pthread_mutex_lock(&TRACE_MUTEX);
+    if (NUM_BUFFERS < TRACE_MAX_THREADS) {
+        TraceBuffer* buf = calloc(1, sizeof(TraceBuffer));
+        if (buf) {
+            BUFFERS[NUM_BUFFERS++] = buf;
+            TLS_BUF = buf;
+        }
+    }
+    pthread_mutex_unlock(&TRACE_MUTEX);
+
+    if (!TLS_BUF) LOGW("No trace buffer for this thread, events dropped");
+    return TLS_BUF;
+}
+
+// INIT AND CLOSE
+
+int trace_init(void) {
+    const char* path = getenv("SIM_TRACE");
+    if (!path || !*path) {
+        return 0;
+    }
+
+    TRACE_FILE = fopen(path, "wb");
+    if (!TRACE_FILE) {
+        LOGE("Could not open trace file: %s", path);
+        return -1;
+    }
+
+    TraceHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, TRACE_MAGIC, sizeof(TRACE_MAGIC));
+    header.version = TRACE_VERSION;
+    header.record_size = (uint32_t)sizeof(TraceRecord);
+    header.num_pes = NUM_PES;
+    header.block_size = BLOCK_SIZE;
+    fwrite(&header, sizeof(header), 1, TRACE_FILE);
+
+    TRACE_T0 = now_ns();
+    trace_enabled = true;
+    LOGI("Tracing bus transactions and MESI transitions to %s", path);
+    return 0;
+}
+
+void trace_close(void) {
+    if (!trace_enabled) return;
+    trace_enabled = false;
+
+    pthread_mutex_lock(&TRACE_MUTEX);
+    for (int i = 0; i < NUM_BUFFERS; i++) {
+        write_buffer(BUFFERS[i]);
+        free(BUFFERS[i]);
+        BUFFERS[i] = NULL;
+    }
+    NUM_BUFFERS = 0;
+    fclose(TRACE_FILE);
+    TRACE_FILE = NULL;
+    pthread_mutex_unlock(&TRACE_MUTEX);
+
+    LOGI("Trace closed: %lu records", (unsigned long)TRACE_WRITTEN);
+}
+
+// RECORDING
+
+void trace_set_context(int msg, int src_pe) {
+    TLS_MSG = msg;
+    TLS_SRC_PE = src_pe;
+}
+
+void trace_clear_context(void) {
+    TLS_MSG = TRACE_NO_MSG;
+    TLS_SRC_PE = TRACE_NO_PE;
+}
+
+void trace_record(TraceKind kind, int pe, int msg, int addr,
+                  int old_state, int new_state, int invalidations) {
+    TraceBuffer* buf = thread_buffer();
+    if (!buf) return;
+
+    TraceRecord* rec = &buf->records[buf->count++];
+    rec->seq = atomic_fetch_add_explicit(&TRACE_SEQ, 1, memory_order_relaxed);
+    rec->time_ns = now_ns() - TRACE_T0;
+    rec->addr = addr;
+    rec->kind = (uint8_t)kind;
+    rec->pe = (uint8_t)pe;
+    rec->src_pe = (uint8_t)(TLS_SRC_PE == TRACE_NO_PE ? pe : TLS_SRC_PE);
+    rec->msg = (uint8_t)msg;
+    rec->old_state = (uint8_t)old_state;
+    rec->new_state = (uint8_t)new_state;
+    rec->invalidations = (uint16_t)invalidations;
+    rec->reserved = 0;
+
+    // Full buffer: one large write
+    if (buf->count == TRACE_BUFFER_RECORDS) {
+        pthread_mutex_lock(&TRACE_MUTEX);
+        write_buffer(buf);
+        pthread_mutex_unlock(&TRACE_MUTEX);
+    }
+}
+
+void trace_state(int pe, int addr, int old_state, int new_state) {
+    trace_record(TRACE_STATE, pe, TLS_MSG, addr, old_state, new_state, 0);
+}
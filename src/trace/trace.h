@@ -0,0 +1,87 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @file trace.h
+ * @brief Traza binaria de transacciones de bus y transiciones MESI
+ *
+ * Se activa con SIM_TRACE=<archivo>. Cada evento es un TraceRecord de tamaño
+ * fijo; cada hilo acumula sus registros en un buffer propio de
+ * TRACE_BUFFER_RECORDS entradas y lo escribe al archivo de una vez cuando se
+ * llena. El archivo no queda ordenado: el campo seq da el orden global.
+ *
+ *   cabecera TraceHeader | TraceRecord... (en bloques por hilo)
+ *
+ * Decodificar con scripts/trace_decode.py.
+ */
+
+#define TRACE_MAGIC   "MPTRACE"
+#define TRACE_VERSION 1
+
+#define TRACE_NO_PE    0xFF
+#define TRACE_NO_MSG   0xFF
+#define TRACE_NO_STATE 0xFF
+
+// Event kinds
+typedef enum {
+    TRACE_BUS = 0,          // Bus transaction served (requester state before/after)
+    TRACE_STATE = 1,        // MESI transition of one cache line
+    TRACE_UPGR_LOST = 2     // BUS_UPGR found its S copy gone, served as BUS_RDX
+} TraceKind;
+
+typedef struct {
+    char magic[8];          // TRACE_MAGIC
+    uint32_t version;       // TRACE_VERSION
+    uint32_t record_size;   // sizeof(TraceRecord)
+    uint32_t num_pes;
+    uint32_t block_size;
+} TraceHeader;
+
+typedef struct {
+    uint64_t seq;           // Global event order
+    uint64_t time_ns;       // Since trace_init (CLOCK_MONOTONIC)
+    int32_t addr;           // Block base address
+    uint8_t kind;           // TraceKind
+    uint8_t pe;             // Cache the event applies to
+    uint8_t src_pe;         // PE whose bus request caused it (== pe for local transitions)
+    uint8_t msg;            // BusMsg in progress, TRACE_NO_MSG for local transitions
+    uint8_t old_state;      // MESI_State before (TRACE_NO_STATE if not applicable)
+    uint8_t new_state;      // MESI_State after
+    uint16_t invalidations; // Copies invalidated by the transaction (TRACE_BUS)
+    uint32_t reserved;      // Keeps the record at 32 bytes
+} TraceRecord;
+
+// true when SIM_TRACE is set; checked inline at every call site
+extern bool trace_enabled;
+
+/**
+ * @brief Abre el archivo de SIM_TRACE (si está definida) y escribe la cabecera
+ * @return 0 si OK o si la traza está desactivada, -1 si no se pudo abrir
+ */
+int trace_init(void);
+
+/**
+ * @brief Escribe los buffers pendientes de todos los hilos y cierra el archivo
+ *
+ * Llamar cuando los hilos que trazan (PEs y bus) ya terminaron.
+ */
+void trace_close(void);
+
+// Bus message being served by the calling thread (tags the TRACE_STATE records it causes)
+void trace_set_context(int msg, int src_pe);
+void trace_clear_context(void);
+
+void trace_record(TraceKind kind, int pe, int msg, int addr,
+                  int old_state, int new_state, int invalidations);
+
+// Transition of one line; cause taken from the current context
+void trace_state(int pe, int addr, int old_state, int new_state);
+
+#define TRACE_STATE(pe, addr, old_state, new_state) do { \
+    if (trace_enabled) trace_state((pe), (addr), (old_state), (new_state)); \
+} while (0)
+
+#endif // TRACE_H
@@ -0,0 +1,60 @@
+#include "workload.h"
+#include <stdio.h>
+#include <pthread.h>
+
+// Skewed input: one in three values falls in bin 0 (the hottest FAA target)
+static int hist_input(int i) { return i % 3 == 0 ? 0 : (i * 7 + i / 5) % HIST_BINS; }
+
+static void histogram_init_data(Memory* mem) {
+    pthread_mutex_lock(&mem->mutex);
+    printf("\n[Histogram] Initializing %d inputs (0x%X), %d bins (0x%X)\n",
+           HIST_SIZE, HIST_INPUT_ADDR, HIST_BINS, HIST_BINS_ADDR);
+
+    for (int i = 0; i < HIST_SIZE; i++) {
+        mem->data[HIST_INPUT_ADDR + i] = (double)hist_input(i);
+    }
+    for (int b = 0; b < HIST_BINS; b++) {
+        mem->data[HIST_BINS_ADDR + b] = 0.0;
+    }
+    workload_partition(mem, HIST_SIZE, 0, 1);
+    printf("[Histogram] Data initialization complete\n\n");
+    pthread_mutex_unlock(&mem->mutex);
+}
+
+static int histogram_print_results(Memory* mem) {
+    pthread_mutex_lock(&mem->mutex);
+    printf("\n[Histogram results]\n\n");
+
+    int expected[HIST_BINS] = {0};
+    for (int i = 0; i < HIST_SIZE; i++) {
+        expected[hist_input(i)]++;
+    }
+
+    int errors = 0;
+    double total = 0.0;
+    for (int b = 0; b < HIST_BINS; b++) {
+        double got = mem->data[HIST_BINS_ADDR + b];
+        total += got;
+        printf("  bin %2d: %6.0f (expected %d)%s\n", b, got, expected[b],
+               got != (double)expected[b] ? "  <- mismatch" : "");
+        errors += got != (double)expected[b];
+    }
+    printf("  total:  %6.0f (inputs %d)\n", total, HIST_SIZE);
+    errors += total != (double)HIST_SIZE;
+
+    int rc = workload_verdict(HIST_BINS + 1, errors);
+    pthread_mutex_unlock(&mem->mutex);
+    return rc;
+}
+
+static void histogram_block_regions(int block_base, char* buf, size_t size) {
+    const WorkloadRegion regions[] = {
+        { "input", HIST_INPUT_ADDR, HIST_SIZE },
+        { "bins",  HIST_BINS_ADDR,  HIST_BINS },
+    };
+    workload_region_names(regions, 2, block_base, buf, size);
+}
+
+const Workload histogram_workload = {
+    "histogram", histogram_init_data, histogram_print_results, histogram_block_regions
+};
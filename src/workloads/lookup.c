@@ -0,0 +1,84 @@
+#include "workload.h"
+#include <stdio.h>
+#include <pthread.h>
+
+static double lookup_entry(int e) { return (double)(e + 1); }
+
+// Skewed keys: three of every four queries hit entries 0-2, which are also
+// the first ones PE0 updates
+static int lookup_key(int q) { return q % 4 ? q % 3 : (q * 5) % LOOKUP_ENTRIES; }
+
+static void lookup_init_data(Memory* mem) {
+    pthread_mutex_lock(&mem->mutex);
+    printf("\n[Lookup] Initializing table of %d entries (0x%X), %d queries (0x%X), %d passes\n",
+           LOOKUP_ENTRIES, LOOKUP_TABLE_ADDR, LOOKUP_QUERIES, LOOKUP_KEYS_ADDR, LOOKUP_ROUNDS);
+
+    for (int e = 0; e < LOOKUP_ENTRIES; e++) {
+        mem->data[LOOKUP_TABLE_ADDR + e] = lookup_entry(e);
+    }
+    for (int q = 0; q < LOOKUP_QUERIES; q++) {
+        mem->data[LOOKUP_KEYS_ADDR + q] = (double)lookup_key(q);
+    }
+    for (int pe = 0; pe < NUM_PES; pe++) {
+        mem->data[RESULT_ADDR(pe)] = 0.0;
+    }
+    mem->data[LOOKUP_BARRIER0_ADDR] = 0.0;
+    mem->data[LOOKUP_BARRIER1_ADDR] = 0.0;
+    workload_partition(mem, LOOKUP_QUERIES, 0, 1);
+    printf("[Lookup] Data initialization complete\n\n");
+    pthread_mutex_unlock(&mem->mutex);
+}
+
+static int lookup_print_results(Memory* mem) {
+    pthread_mutex_lock(&mem->mutex);
+    printf("\n[Lookup results]\n\n");
+
+    // Replay of the passes: entry r is incremented after pass r
+    double table[LOOKUP_ENTRIES];
+    double sums[NUM_PES] = {0};
+    for (int e = 0; e < LOOKUP_ENTRIES; e++) {
+        table[e] = lookup_entry(e);
+    }
+    for (int round = 0; round < LOOKUP_ROUNDS; round++) {
+        for (int pe = 0; pe < NUM_PES; pe++) {
+            int begin, count;
+            workload_share(pe, LOOKUP_QUERIES, &begin, &count);
+            for (int q = begin; q < begin + count; q++) {
+                sums[pe] += table[lookup_key(q)];
+            }
+        }
+        if (round < LOOKUP_ROUNDS - 1) {
+            table[round] += 1.0;
+        }
+    }
+
+    int errors = 0;
+    for (int pe = 0; pe < NUM_PES; pe++) {
+        double got = mem->data[RESULT_ADDR(pe)];
+        printf("  PE%d: sum %.0f (expected %.0f, addr 0x%X)%s\n", pe, got, sums[pe],
+               RESULT_ADDR(pe), got != sums[pe] ? "  <- mismatch" : "");
+        errors += got != sums[pe];
+    }
+    for (int e = 0; e < LOOKUP_ENTRIES; e++) {
+        errors += mem->data[LOOKUP_TABLE_ADDR + e] != table[e];
+    }
+
+    int rc = workload_verdict(NUM_PES + LOOKUP_ENTRIES, errors);
+    pthread_mutex_unlock(&mem->mutex);
+    return rc;
+}
+
+static void lookup_block_regions(int block_base, char* buf, size_t size) {
+    const WorkloadRegion regions[] = {
+        { "results",  RESULTS_ADDR,         NUM_PES * SYNC_STRIDE },
+        { "table",    LOOKUP_TABLE_ADDR,    LOOKUP_ENTRIES },
+        { "keys",     LOOKUP_KEYS_ADDR,     LOOKUP_QUERIES },
+        { "barrier0", LOOKUP_BARRIER0_ADDR, 1 },
+        { "barrier1", LOOKUP_BARRIER1_ADDR, 1 },
+    };
+    workload_region_names(regions, 5, block_base, buf, size);
+}
+
+const Workload lookup_workload = {
+    "lookup", lookup_init_data, lookup_print_results, lookup_block_regions
+};
@@ -0,0 +1,89 @@
+#include "workload.h"
+#include <stdio.h>
+#include <pthread.h>
+
+#define MATMUL_PRINT_MAX 8      // Larger matrices: verification only
+
+// Small integers: every partial sum is exact
+static double matmul_a(int i, int k) { return (double)((i * MATMUL_N + k) % 7 - 3); }
+static double matmul_b(int k, int j) { return (double)((k + 2 * j) % 5 - 2); }
+
+static void print_matrix(const char* name, Memory* mem, int addr, int transposed) {
+    printf("  %s:\n", name);
+    for (int i = 0; i < MATMUL_N; i++) {
+        printf("    [");
+        for (int j = 0; j < MATMUL_N; j++) {
+            int index = transposed ? j * MATMUL_N + i : i * MATMUL_N + j;
+            printf("%6.1f%s", mem->data[addr + index], j < MATMUL_N - 1 ? ", " : "");
+        }
+        printf("]\n");
+    }
+}
+
+static void matmul_init_data(Memory* mem) {
+    pthread_mutex_lock(&mem->mutex);
+    printf("\n[Matmul] Initializing %dx%d matrices (A 0x%X, B^T 0x%X, C 0x%X)\n",
+           MATMUL_N, MATMUL_N, MATMUL_A_ADDR, MATMUL_BT_ADDR, MATMUL_C_ADDR);
+
+    for (int i = 0; i < MATMUL_N; i++) {
+        for (int j = 0; j < MATMUL_N; j++) {
+            mem->data[MATMUL_A_ADDR + i * MATMUL_N + j] = matmul_a(i, j);
+            mem->data[MATMUL_BT_ADDR + j * MATMUL_N + i] = matmul_b(i, j);
+            mem->data[MATMUL_C_ADDR + i * MATMUL_N + j] = 0.0;
+        }
+    }
+
+    // Rows of C; the start is the offset of the row in A and C
+    workload_partition(mem, MATMUL_N, 0, MATMUL_N);
+    for (int pe = 0; pe < NUM_PES; pe++) {
+        int begin, count;
+        workload_share(pe, MATMUL_N, &begin, &count);
+        printf("  PE%d: rows %d-%d\n", pe, begin, begin + count - 1);
+    }
+    printf("[Matmul] Data initialization complete\n\n");
+    pthread_mutex_unlock(&mem->mutex);
+}
+
+static int matmul_print_results(Memory* mem) {
+    pthread_mutex_lock(&mem->mutex);
+    printf("\n[Matmul results]\n\n");
+    if (MATMUL_N <= MATMUL_PRINT_MAX) {
+        print_matrix("A", mem, MATMUL_A_ADDR, 0);
+        print_matrix("B", mem, MATMUL_BT_ADDR, 1);
+        print_matrix("C", mem, MATMUL_C_ADDR, 0);
+    }
+
+    // Same k order as the kernel
+    int errors = 0;
+    for (int i = 0; i < MATMUL_N; i++) {
+        for (int j = 0; j < MATMUL_N; j++) {
+            double expected = 0.0;
+            for (int k = 0; k < MATMUL_N; k++) {
+                expected += matmul_a(i, k) * matmul_b(k, j);
+            }
+            double got = mem->data[MATMUL_C_ADDR + i * MATMUL_N + j];
+            if (got != expected) {
+                if (errors < 10) {
+                    printf("  C[%d][%d] = %.2f, expected %.2f\n", i, j, got, expected);
+                }
+                errors++;
+            }
+        }
+    }
+    int rc = workload_verdict(MATMUL_N * MATMUL_N, errors);
+    pthread_mutex_unlock(&mem->mutex);
+    return rc;
+}
+
+static void matmul_block_regions(int block_base, char* buf, size_t size) {
+    const WorkloadRegion regions[] = {
+        { "matA",  MATMUL_A_ADDR,  MATMUL_N * MATMUL_N },
+        { "matBT", MATMUL_BT_ADDR, MATMUL_N * MATMUL_N },
+        { "matC",  MATMUL_C_ADDR,  MATMUL_N * MATMUL_N },
+    };
+    workload_region_names(regions, 3, block_base, buf, size);
+}
+
+const Workload matmul_workload = {
+    "matmul", matmul_init_data, matmul_print_results, matmul_block_regions
+};
@@ -0,0 +1,83 @@
+#include "workload.h"
+#include <stdio.h>
+#include <pthread.h>
+
+// Roles in CFG_PE(pe, 1), the queue of the pair in CFG_PE(pe, 0)
+#define ROLE_IDLE     0
+#define ROLE_PRODUCER 1
+#define ROLE_CONSUMER 2
+
+// Item k (1..QUEUE_ITEMS) of a pair: unique across pairs
+static double prodcons_item(int pair, int k) { return (double)(QUEUE_ADDR(pair) + k); }
+
+static void prodcons_init_data(Memory* mem) {
+    pthread_mutex_lock(&mem->mutex);
+    printf("\n[Prodcons] Initializing %d queue(s) of %d slots, %d items per pair\n",
+           QUEUE_PAIRS, QUEUE_SLOTS, QUEUE_ITEMS);
+
+    for (int pair = 0; pair < QUEUE_PAIRS; pair++) {
+        int base = QUEUE_ADDR(pair);
+        for (int i = 0; i < QUEUE_PAIR_SPAN; i++) {
+            mem->data[base + i] = 0.0;
+        }
+        printf("  Pair %d: PE%d -> PE%d, queue 0x%X (head 0x%X, tail 0x%X, out 0x%X)\n", pair,
+               2 * pair, 2 * pair + 1, base, base + QUEUE_HEAD_OFFSET, base + QUEUE_TAIL_OFFSET,
+               base + QUEUE_OUT_OFFSET);
+    }
+    for (int pe = 0; pe < NUM_PES; pe++) {
+        int pair = pe / 2;
+        int role = pair < QUEUE_PAIRS ? (pe % 2 ? ROLE_CONSUMER : ROLE_PRODUCER) : ROLE_IDLE;
+        mem->data[CFG_PE(pe, 0)] = role == ROLE_IDLE ? 0.0 : (double)QUEUE_ADDR(pair);
+        mem->data[CFG_PE(pe, 1)] = (double)role;
+        if (role == ROLE_IDLE) {
+            printf("  PE%d: no partner, idle\n", pe);
+        }
+    }
+    printf("[Prodcons] Data initialization complete\n\n");
+    pthread_mutex_unlock(&mem->mutex);
+}
+
+static int prodcons_print_results(Memory* mem) {
+    pthread_mutex_lock(&mem->mutex);
+    printf("\n[Prodcons results]\n\n");
+
+    int errors = 0;
+    for (int pair = 0; pair < QUEUE_PAIRS; pair++) {
+        int base = QUEUE_ADDR(pair);
+        double head = mem->data[base + QUEUE_HEAD_OFFSET];
+        double tail = mem->data[base + QUEUE_TAIL_OFFSET];
+        int out_errors = 0;
+        for (int k = 0; k < QUEUE_ITEMS; k++) {
+            out_errors += mem->data[base + QUEUE_OUT_OFFSET + k] != prodcons_item(pair, k + 1);
+        }
+        printf("  Pair %d: produced %.0f, consumed %.0f, %d/%d items in order\n", pair, tail,
+               head, QUEUE_ITEMS - out_errors, QUEUE_ITEMS);
+        errors += out_errors + (head != QUEUE_ITEMS) + (tail != QUEUE_ITEMS);
+    }
+
+    int rc = workload_verdict(QUEUE_PAIRS * (QUEUE_ITEMS + 2), errors);
+    pthread_mutex_unlock(&mem->mutex);
+    return rc;
+}
+
+// One range per pair field would need QUEUE_PAIRS entries: map the offset instead
+static void prodcons_block_regions(int block_base, char* buf, size_t size) {
+    int offset = block_base - WL_DATA_ADDR;
+    if (offset < 0 || block_base >= QUEUE_END) {
+        workload_region_names(NULL, 0, block_base, buf, size);
+        return;
+    }
+    int pair = offset / QUEUE_PAIR_SPAN;
+    int base = QUEUE_ADDR(pair);
+    const WorkloadRegion regions[] = {
+        { "ring", base,                     QUEUE_SLOTS },
+        { "head", base + QUEUE_HEAD_OFFSET, 1 },
+        { "tail", base + QUEUE_TAIL_OFFSET, 1 },
+        { "out",  base + QUEUE_OUT_OFFSET,  QUEUE_ITEMS },
+    };
+    workload_region_names(regions, 4, block_base, buf, size);
+}
+
+const Workload prodcons_workload = {
+    "prodcons", prodcons_init_data, prodcons_print_results, prodcons_block_regions
+};
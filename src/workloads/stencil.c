@@ -0,0 +1,119 @@
+#include "workload.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+
+#define STENCIL_CELLS      (STENCIL_ROWS * STENCIL_COLS)
+#define STENCIL_PRINT_MAX  12   // Larger grids: verification only
+
+// Same operation order as the kernel; a*b+c must not become an FMA
+#define STENCIL_EXACT __attribute__((optimize("fp-contract=off")))
+
+static double stencil_initial(int r, int c) { return (double)((r * 7 + c * 3) % 16); }
+
+STENCIL_EXACT
+static void stencil_step(const double* src, double* dst) {
+    for (int r = STENCIL_ROWS > 1; r < STENCIL_ROWS - (STENCIL_ROWS > 1); r++) {
+        for (int c = 1; c < STENCIL_COLS - 1; c++) {
+            int i = r * STENCIL_COLS + c;
+            double center = src[i] * 0.5;
+            double sum;
+            if (STENCIL_ROWS > 1) {
+                sum = src[i - STENCIL_COLS] + src[i + STENCIL_COLS];
+                sum = sum + src[i - 1];
+                sum = (sum + src[i + 1]) * 0.125;
+            } else {
+                sum = (src[i - 1] + src[i + 1]) * 0.25;
+            }
+            dst[i] = center + sum;
+        }
+    }
+}
+
+static void stencil_init_data(Memory* mem) {
+    pthread_mutex_lock(&mem->mutex);
+    printf("\n[Stencil] Initializing %s grid %dx%d, %d steps (grids 0x%X / 0x%X)\n",
+           STENCIL_ROWS > 1 ? "2D" : "1D", STENCIL_ROWS, STENCIL_COLS, STENCIL_STEPS,
+           STENCIL_GRID0_ADDR, STENCIL_GRID1_ADDR);
+
+    // Both grids start equal: the fixed borders are never written
+    for (int r = 0; r < STENCIL_ROWS; r++) {
+        for (int c = 0; c < STENCIL_COLS; c++) {
+            mem->data[STENCIL_GRID0_ADDR + r * STENCIL_COLS + c] = stencil_initial(r, c);
+            mem->data[STENCIL_GRID1_ADDR + r * STENCIL_COLS + c] = stencil_initial(r, c);
+        }
+    }
+    mem->data[STENCIL_BARRIER0_ADDR] = 0.0;
+    mem->data[STENCIL_BARRIER1_ADDR] = 0.0;
+
+    // Interior rows (2D) or interior cells (1D), as the offset of their first cell
+    if (STENCIL_ROWS > 1) {
+        workload_partition(mem, STENCIL_ROWS - 2, STENCIL_COLS + 1, STENCIL_COLS);
+    } else {
+        workload_partition(mem, STENCIL_COLS - 2, 1, 1);
+    }
+    printf("[Stencil] Data initialization complete\n\n");
+    pthread_mutex_unlock(&mem->mutex);
+}
+
+static int stencil_print_results(Memory* mem) {
+    pthread_mutex_lock(&mem->mutex);
+    printf("\n[Stencil results]\n\n");
+
+    double* grid[2] = { malloc(STENCIL_CELLS * sizeof(double)), malloc(STENCIL_CELLS * sizeof(double)) };
+    if (!grid[0] || !grid[1]) {
+        printf("  Out of memory for the host reference\n");
+        free(grid[0]);
+        free(grid[1]);
+        pthread_mutex_unlock(&mem->mutex);
+        return workload_verdict(0, 1);
+    }
+    for (int r = 0; r < STENCIL_ROWS; r++) {
+        for (int c = 0; c < STENCIL_COLS; c++) {
+            grid[0][r * STENCIL_COLS + c] = stencil_initial(r, c);
+        }
+    }
+    memcpy(grid[1], grid[0], STENCIL_CELLS * sizeof(double));
+    for (int step = 0; step < STENCIL_STEPS; step++) {
+        stencil_step(grid[step % 2], grid[(step + 1) % 2]);
+    }
+
+    const double* expected = grid[STENCIL_STEPS % 2];
+    int final_addr = STENCIL_STEPS % 2 ? STENCIL_GRID1_ADDR : STENCIL_GRID0_ADDR;
+    int print = STENCIL_ROWS <= STENCIL_PRINT_MAX && STENCIL_COLS <= STENCIL_PRINT_MAX;
+    if (print) {
+        printf("  Grid after %d steps (addr 0x%X):\n", STENCIL_STEPS, final_addr);
+    }
+    int errors = 0;
+    for (int r = 0; r < STENCIL_ROWS; r++) {
+        if (print) printf("    [");
+        for (int c = 0; c < STENCIL_COLS; c++) {
+            int i = r * STENCIL_COLS + c;
+            double got = mem->data[final_addr + i];
+            if (print) printf("%8.4f%s", got, c < STENCIL_COLS - 1 ? ", " : "");
+            errors += got != expected[i];
+        }
+        if (print) printf("]\n");
+    }
+    free(grid[0]);
+    free(grid[1]);
+
+    int rc = workload_verdict(STENCIL_CELLS, errors);
+    pthread_mutex_unlock(&mem->mutex);
+    return rc;
+}
+
+static void stencil_block_regions(int block_base, char* buf, size_t size) {
+    const WorkloadRegion regions[] = {
+        { "grid0",    STENCIL_GRID0_ADDR,    STENCIL_CELLS },
+        { "grid1",    STENCIL_GRID1_ADDR,    STENCIL_CELLS },
+        { "barrier0", STENCIL_BARRIER0_ADDR, 1 },
+        { "barrier1", STENCIL_BARRIER1_ADDR, 1 },
+    };
+    workload_region_names(regions, 4, block_base, buf, size);
+}
+
+const Workload stencil_workload = {
+    "stencil", stencil_init_data, stencil_print_results, stencil_block_regions
+};
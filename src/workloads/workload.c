@@ -0,0 +1,125 @@
+#define LOG_MODULE "WORKLOAD"
+#include "workload.h"
+#include "dotprod.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "log.h"
+
+static const Workload dotprod_workload = {
+    "dotprod", dotprod_init_data, dotprod_print_results, dotprod_block_regions
+};
+
+static const Workload* const WORKLOADS[] = {
+    &dotprod_workload,
+    &matmul_workload,
+    &histogram_workload,
+    &stencil_workload,
+    &prodcons_workload,
+    &lookup_workload,
+};
+
+#define NUM_WORKLOADS ((int)(sizeof(WORKLOADS) / sizeof(WORKLOADS[0])))
+
+static const Workload* CURRENT = &dotprod_workload;
+static char PROGRAM_PATH[256];
+
+// INIT
+
+int workload_init(void) {
+    const char* env = getenv("SIM_WORKLOAD");
+    if (!env || !*env) {
+        return 0;
+    }
+    for (int w = 0; w < NUM_WORKLOADS; w++) {
+        if (strcmp(env, WORKLOADS[w]->name) == 0) {
+            CURRENT = WORKLOADS[w];
+        }
+    }
+    if (strcmp(env, CURRENT->name) != 0) {
+        LOGE("Invalid SIM_WORKLOAD=%s (use dotprod, matmul, histogram, stencil, prodcons or lookup)", env);
+        return -1;
+    }
+
+    if (CURRENT != &dotprod_workload) {
+        snprintf(PROGRAM_PATH, sizeof(PROGRAM_PATH), ASM_WORKLOAD_PATH_FMT, CURRENT->name);
+        const char* env_kernel = getenv("SIM_KERNEL");
+        if (env_kernel && *env_kernel) {
+            LOGW("SIM_KERNEL=%s only applies to dotprod, running %s", env_kernel, PROGRAM_PATH);
+        }
+    }
+    return 0;
+}
+
+const char* workload_name(void) {
+    return CURRENT->name;
+}
+
+const char* workload_program_path(void) {
+    return CURRENT == &dotprod_workload ? NULL : PROGRAM_PATH;
+}
+
+void workload_init_data(Memory* mem) {
+    CURRENT->init_data(mem);
+}
+
+int workload_print_results(Memory* mem) {
+    return CURRENT->print_results(mem);
+}
+
+void workload_block_regions(int block_base, char* buf, size_t size) {
+    CURRENT->block_regions(block_base, buf, size);
+}
+
+// HELPERS
+
+void workload_share(int pe, int items, int* begin, int* count) {
+    int base = items / NUM_PES;
+    int extra = items % NUM_PES;
+    *begin = pe * base + (pe < extra ? pe : extra);
+    *count = base + (pe < extra ? 1 : 0);
+}
+
+void workload_partition(Memory* mem, int items, int first, int stride) {
+    for (int pe = 0; pe < NUM_PES; pe++) {
+        int begin, count;
+        workload_share(pe, items, &begin, &count);
+        mem->data[CFG_PE(pe, 0)] = (double)(first + begin * stride);
+        mem->data[CFG_PE(pe, 1)] = (double)count;
+    }
+}
+
+int workload_verdict(int checked, int errors) {
+    printf("\nVerification:\n");
+    printf("  Checked: %d values against the host reference (exact)\n", checked);
+    printf("  Mismatches: %d\n", errors);
+    if (errors == 0) {
+        printf("  Status: CORRECT\n");
+    } else {
+        printf("  Status: INCORRECT\n");
+    }
+    printf("\n");
+    return errors == 0 ? 0 : 1;
+}
+
+void workload_region_names(const WorkloadRegion* regions, int count, int block_base,
+                           char* buf, size_t size) {
+    const WorkloadRegion common[] = {
+        { "config", SHARED_CONFIG_ADDR, CFG_TOTAL_SIZE },
+        { "code",   CODE_REGION_BASE,   CODE_REGION_SIZE },
+    };
+
+    size_t len = 0;
+    buf[0] = '\0';
+    for (int r = 0; r < count + 2; r++) {
+        const WorkloadRegion* region = r == 0 ? &common[0] : r <= count ? &regions[r - 1] : &common[1];
+        int start = region->start;
+        int end = start + region->size;
+        if (start < block_base + BLOCK_SIZE && end > block_base && len < size) {
+            len += snprintf(buf + len, size - len, "%s%s", len ? "+" : "", region->name);
+        }
+    }
+    if (len == 0) {
+        snprintf(buf, size, "-");
+    }
+}
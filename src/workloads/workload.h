@@ -0,0 +1,94 @@
+#ifndef WORKLOAD_H
+#define WORKLOAD_H
+
+#include <stddef.h>
+#include "config.h"
+#include "memory.h"
+#include "block_stats.h"
+
+/**
+ * @file workload.h
+ * @brief Cargas de trabajo del simulador (SIM_WORKLOAD)
+ *
+ * Además del producto punto, cada carga estresa un patrón de compartición
+ * distinto del protocolo:
+ *   dotprod     producto punto (por defecto; SIM_KERNEL elige su programa)
+ *   matmul      C = A * B por filas: B solo lectura y compartida por todos
+ *   histogram   FAA sobre pocos bins compartidos: contención de escritura
+ *   stencil     Jacobi 1D/2D con barrera por paso: intercambio de halo
+ *               (las filas frontera de cada PE las leen sus vecinos)
+ *   prodcons    cola circular por parejas de PEs: migración de líneas
+ *               productor -> consumidor y espera con MONITOR/MWAIT
+ *   lookup      tabla de lectura mayoritaria que PE0 actualiza entre pasadas:
+ *               invalidaciones de muchas copias S
+ *
+ * Salvo dotprod, cada carga es un único programa SPMD (asm/wl_<nombre>.asm,
+ * generado desde config.h por scripts/generate_asm.py) y el reparto de
+ * trabajo de cada PE se escribe en CFG_PE(pe, 0..1). Los datos de entrada
+ * son enteros pequeños o fracciones diádicas: la verificación contra la
+ * referencia del host es exacta, bit a bit.
+ */
+
+// A named address range of a workload's layout ([Hot blocks] region names)
+typedef struct {
+    const char* name;
+    int start;
+    int size;
+} WorkloadRegion;
+
+typedef struct {
+    const char* name;
+    void (*init_data)(Memory* mem);         // Inputs and shares of work
+    int (*print_results)(Memory* mem);      // 0 if the result is correct, 1 otherwise
+    BlockRegionFn block_regions;
+} Workload;
+
+/**
+ * @brief Lee SIM_WORKLOAD
+ * @return 0 si OK, -1 si el nombre no existe
+ */
+int workload_init(void);
+
+const char* workload_name(void);
+
+// SPMD program of the workload, NULL for dotprod (per-PE programs, SIM_KERNEL)
+const char* workload_program_path(void);
+
+void workload_init_data(Memory* mem);
+
+/**
+ * @brief Imprime el resultado y lo verifica contra la referencia del host
+ * @return 0 si es correcto, 1 si no
+ */
+int workload_print_results(Memory* mem);
+
+// Region names of a block for the selected workload (see dotprod_block_regions)
+void workload_block_regions(int block_base, char* buf, size_t size);
+
+// HELPERS FOR THE WORKLOADS (mem->mutex held)
+
+/**
+ * @brief Reparte items entre los PEs en tramos contiguos
+ *
+ * Los primeros items % NUM_PES PEs reciben uno más. CFG_PE(pe, 0) recibe
+ * first + inicio * stride y CFG_PE(pe, 1) el número de items.
+ */
+void workload_partition(Memory* mem, int items, int first, int stride);
+
+// Share of one PE: index of its first item and item count
+void workload_share(int pe, int items, int* begin, int* count);
+
+// Prints the "Verification:" section; returns 0 if errors == 0, 1 otherwise
+int workload_verdict(int checked, int errors);
+
+// Joins the names of the regions overlapping the block ("config" and "code" are implicit)
+void workload_region_names(const WorkloadRegion* regions, int count, int block_base,
+                           char* buf, size_t size);
+
+extern const Workload matmul_workload;
+extern const Workload histogram_workload;
+extern const Workload stencil_workload;
+extern const Workload prodcons_workload;
+extern const Workload lookup_workload;
+
+#endif // WORKLOAD_H